@@ -0,0 +1,397 @@
+/*****************************************************************************
+ ***************************** DBlobPipeline.cpp *****************************
+ *****************************************************************************/
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+#include "DBlobPipeline.h"
+
+#include <algorithm>
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::DBlobPipeline
+ *
+ *****************************************************************************/
+
+DBlobPipeline::DBlobPipeline(int nSlots, const std::vector<DStage>& Stages,
+      const DReady& Ready) :
+      m_Ready(Ready),
+      m_FreeSlots(std::max(nSlots, 1)),
+      m_nMailbox(-1),
+      m_nSpareSlot(-1),
+      m_nGeneration(0),
+      m_SlotGenerations(std::max(nSlots, 1), 0),
+      m_nDropped(0),
+      m_nStatsStart(Now()),
+      m_bQuit(false)
+   {
+   for (int nSlot = 0 ; nSlot < GetSlotCount() ; nSlot++)
+      {
+      m_FreeSlots.Push(nSlot);
+      } // end for
+
+   for (const auto& Stage : Stages)
+      {
+      std::unique_ptr<DStageThread> pStage(new DStageThread);
+      pStage->Stage = Stage;
+      pStage->pOutput.reset(new DSPSCRing<int>(GetSlotCount()));
+      pStage->nProcessed = 0;
+      pStage->nStalls = 0;
+      pStage->nBusyTime = 0;
+      m_Stages.push_back(std::move(pStage));
+      } // end for
+
+   // Started once every stage is in place since each looks at the one
+   // before it
+   for (int nStage = 0 ; nStage < GetStageCount() ; nStage++)
+      {
+      m_Stages[nStage]->Thread = std::thread(&DBlobPipeline::Run, this, nStage);
+      } // end for
+
+   return;
+
+   } // End of function DBlobPipeline::DBlobPipeline
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::~DBlobPipeline
+ *
+ *****************************************************************************/
+
+DBlobPipeline::~DBlobPipeline()
+   {
+   m_bQuit = true;
+   for (auto& pStage : m_Stages)
+      {
+      RingBell(*pStage);
+      } // end for
+
+   for (auto& pStage : m_Stages)
+      {
+      pStage->Thread.join();
+      } // end for
+
+   return;
+
+   } // End of function DBlobPipeline::~DBlobPipeline
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::AcquireSlot
+ *
+ *  A slot replaced in the mailbox is used first since nothing else can
+ *  have it.
+ *
+ *****************************************************************************/
+
+int DBlobPipeline::AcquireSlot()
+   {
+   int nSlot = m_nSpareSlot;
+   if (nSlot != -1)
+      {
+      m_nSpareSlot = -1;
+      } // end if
+   else if (!m_FreeSlots.Pop(nSlot))
+      {
+      nSlot = -1;
+      m_nDropped++;
+      } // end else if
+
+   return (nSlot);
+
+   } // End of function DBlobPipeline::AcquireSlot
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::Submit
+ *
+ *  Leave the frame for the first stage.  If the last one is still there it
+ *  is dropped and its slot kept for the next frame.
+ *
+ *****************************************************************************/
+
+void DBlobPipeline::Submit(int nSlot)
+   {
+   int nOldSlot = m_nMailbox.exchange(nSlot);
+   if (nOldSlot != -1)
+      {
+      m_nSpareSlot = nOldSlot;
+      m_nDropped++;
+      } // end if
+
+   if (!m_Stages.empty())
+      {
+      RingBell(*m_Stages.front());
+      } // end if
+
+   return;
+
+   } // End of function DBlobPipeline::Submit
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::TakeResult
+ *
+ *  Frames dropped by a pause come out too; they're handed back here
+ *  instead.
+ *
+ *****************************************************************************/
+
+int DBlobPipeline::TakeResult()
+   {
+   int nSlot = -1;
+   if (!m_Stages.empty())
+      {
+      while (m_Stages.back()->pOutput->Pop(nSlot)
+            && (m_SlotGenerations[nSlot] != m_nGeneration))
+         {
+         ReleaseSlot(nSlot);
+         m_nDropped++;
+         nSlot = -1;
+         } // end while
+      } // end if
+
+   return (nSlot);
+
+   } // End of function DBlobPipeline::TakeResult
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::ReleaseSlot
+ *
+ *****************************************************************************/
+
+void DBlobPipeline::ReleaseSlot(int nSlot)
+   {
+   // Never full, there are only so many slots
+   m_FreeSlots.Push(nSlot);
+
+   return;
+
+   } // End of function DBlobPipeline::ReleaseSlot
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::GetStageStats
+ *
+ *****************************************************************************/
+
+DBlobPipeline::DStageStats DBlobPipeline::GetStageStats(int nStage) const
+   {
+   const DStageThread& Stage = *m_Stages[nStage];
+
+   DStageStats Stats;
+   Stats.nProcessed = Stage.nProcessed;
+   Stats.nStalls = Stage.nStalls;
+   if (nStage == 0)
+      {
+      Stats.nQueued = (m_nMailbox != -1) ? 1 : 0;
+      } // end if
+   else
+      {
+      Stats.nQueued = static_cast<int>(m_Stages[nStage - 1]->pOutput->GetSize());
+      } // end else
+
+   int64_t nElapsed = Now() - m_nStatsStart;
+   Stats.dOccupancy = (nElapsed > 0)
+         ? std::min(1.0, static_cast<double>(Stage.nBusyTime) / nElapsed) : 0.0;
+
+   return (Stats);
+
+   } // End of function DBlobPipeline::GetStageStats
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::GetQueuedFrames
+ *
+ *****************************************************************************/
+
+int DBlobPipeline::GetQueuedFrames() const
+   {
+   int nQueued = 0;
+   for (int nStage = 0 ; nStage < GetStageCount() ; nStage++)
+      {
+      nQueued += GetStageStats(nStage).nQueued;
+      } // end for
+
+   return (nQueued);
+
+   } // End of function DBlobPipeline::GetQueuedFrames
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::ResetStats
+ *
+ *****************************************************************************/
+
+void DBlobPipeline::ResetStats()
+   {
+   for (auto& pStage : m_Stages)
+      {
+      pStage->nProcessed = 0;
+      pStage->nStalls = 0;
+      pStage->nBusyTime = 0;
+      } // end for
+   m_nDropped = 0;
+   m_nStatsStart = Now();
+
+   return;
+
+   } // End of function DBlobPipeline::ResetStats
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::TakeInput
+ *
+ *  Take the next frame waiting for the stage, if there is one.
+ *
+ *****************************************************************************/
+
+bool DBlobPipeline::TakeInput(int nStage, int& nSlot)
+   {
+   if (nStage == 0)
+      {
+      nSlot = m_nMailbox.exchange(-1);
+      } // end if
+   else if (!m_Stages[nStage - 1]->pOutput->Pop(nSlot))
+      {
+      nSlot = -1;
+      } // end else if
+
+   return (nSlot != -1);
+
+   } // End of function DBlobPipeline::TakeInput
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::HasInput
+ *
+ *****************************************************************************/
+
+bool DBlobPipeline::HasInput(int nStage) const
+   {
+   return ((nStage == 0) ? (m_nMailbox != -1)
+         : !m_Stages[nStage - 1]->pOutput->IsEmpty());
+
+   } // End of function DBlobPipeline::HasInput
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::RingBell
+ *
+ *  Wake the stage if it's waiting for a frame.  Taking its bell lock, even
+ *  for a moment, means it's either still to check for a frame or already
+ *  waiting, so the ring isn't missed.
+ *
+ *****************************************************************************/
+
+void DBlobPipeline::RingBell(DStageThread& Stage)
+   {
+      {
+      std::lock_guard<std::mutex> Lock(Stage.BellMutex);
+      }
+   Stage.Bell.notify_one();
+
+   return;
+
+   } // End of function DBlobPipeline::RingBell
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::Run
+ *
+ *  A stage's thread.  Works on each frame that comes to it and passes it
+ *  on, or waits for one.  The first stage stamps the frames with the pause
+ *  generation and the others skip frames stamped before the last pause.
+ *
+ *****************************************************************************/
+
+void DBlobPipeline::Run(int nStage)
+   {
+   DStageThread& Stage = *m_Stages[nStage];
+   bool bLast = (nStage + 1 == GetStageCount());
+
+   while (!m_bQuit)
+      {
+      int nSlot;
+      if (!TakeInput(nStage, nSlot))
+         {
+         Stage.nStalls++;
+         std::unique_lock<std::mutex> Lock(Stage.BellMutex);
+         Stage.Bell.wait(Lock, [this, nStage] { return (m_bQuit || HasInput(nStage)); });
+         continue;
+         } // end if
+
+         {
+         std::lock_guard<std::mutex> Lock(Stage.Mutex);
+         if (nStage == 0)
+            {
+            m_SlotGenerations[nSlot] = m_nGeneration;
+            } // end if
+
+         if (m_SlotGenerations[nSlot] == m_nGeneration)
+            {
+            int64_t nStart = Now();
+            Stage.Stage(nSlot);
+            Stage.nBusyTime += Now() - nStart;
+            Stage.nProcessed++;
+            } // end if
+         }
+
+      Stage.pOutput->Push(nSlot);
+      if (bLast)
+         {
+         m_Ready();
+         } // end if
+      else
+         {
+         RingBell(*m_Stages[nStage + 1]);
+         } // end else
+      } // end while
+
+   return;
+
+   } // End of function DBlobPipeline::Run
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::DPause::DPause
+ *
+ *  Takes the stages' locks in order, waiting for each to finish the frame
+ *  it's on.
+ *
+ *****************************************************************************/
+
+DBlobPipeline::DPause::DPause(DBlobPipeline& Pipeline) :
+      m_Pipeline(Pipeline)
+   {
+   for (auto& pStage : m_Pipeline.m_Stages)
+      {
+      pStage->Mutex.lock();
+      } // end for
+
+   m_Pipeline.m_nGeneration++;
+
+   return;
+
+   } // End of function DBlobPipeline::DPause::DPause
+
+/*****************************************************************************
+ *
+ *  DBlobPipeline::DPause::~DPause
+ *
+ *****************************************************************************/
+
+DBlobPipeline::DPause::~DPause()
+   {
+   for (auto& pStage : m_Pipeline.m_Stages)
+      {
+      pStage->Mutex.unlock();
+      } // end for
+
+   return;
+
+   } // End of function DBlobPipeline::DPause::~DPause
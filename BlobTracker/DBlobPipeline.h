@@ -0,0 +1,186 @@
+/*****************************************************************************
+ ****************************** DBlobPipeline.h ******************************
+ *****************************************************************************/
+
+#if !defined(__DBLOBPIPELINE_H__)
+#define __DBLOBPIPELINE_H__
+
+#pragma once
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+#include "DSPSCRing.h"
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <chrono>
+
+/*****************************************************************************
+ *
+ ***  class DBlobPipeline
+ *
+ * Frames passed through a chain of stages, each on a thread of its own, so
+ * one frame can be in each stage at once and the frame rate is set by the
+ * slowest stage rather than all of them together.  The frames live in a
+ * fixed set of slots owned by the caller; only slot numbers move, through
+ * lock free single producer, single consumer rings.  A ring can hold every
+ * slot so a stage never waits for room to hand a frame on.
+ *
+ * The producer gets a free slot with AcquireSlot, fills it and Submits it.
+ * A submitted frame the first stage hasn't started yet is replaced by the
+ * next one, so the newest frame always goes through and a backlog costs
+ * frames rather than latency.  After the last stage the ready callback is
+ * called on its thread, and the consumer takes the finished slots with
+ * TakeResult and hands them back with ReleaseSlot.
+ *
+ * Each stage holds a lock of its own while it works on a frame.  DPause
+ * takes all of them so the stages' shared settings can be changed, and
+ * frames part way through the pipeline then are dropped instead of being
+ * finished with a mix of the old and the new settings.
+ *
+ *****************************************************************************/
+
+class DBlobPipeline
+   {
+   public:
+      // Works on the frame in a slot, on the stage's own thread
+      using DStage = std::function<void (int nSlot)>;
+      // A slot is ready for TakeResult.  Called on the last stage's thread.
+      using DReady = std::function<void ()>;
+
+      struct DStageStats
+         {
+         int nProcessed;
+         // Times the stage ran out of frames and had to wait for one
+         int nStalls;
+         // Frames waiting for the stage
+         int nQueued;
+         // Fraction of the time since the statistics were reset the stage
+         // spent working
+         double dOccupancy;
+         };
+
+      DBlobPipeline(int nSlots, const std::vector<DStage>& Stages,
+            const DReady& Ready);
+
+      DBlobPipeline(const DBlobPipeline& src) = delete;
+
+      ~DBlobPipeline();
+
+      DBlobPipeline& operator=(const DBlobPipeline& rhs) = delete;
+
+      // Producer side.  A slot to fill, -1 if they're all busy, in which
+      // case the frame is dropped.  Every slot acquired must be submitted.
+      int AcquireSlot();
+      void Submit(int nSlot);
+
+      // Consumer side.  The next finished slot, -1 if there isn't one.
+      int TakeResult();
+      void ReleaseSlot(int nSlot);
+
+      int GetSlotCount() const
+         {
+         return (static_cast<int>(m_SlotGenerations.size()));
+         }
+
+      int GetStageCount() const
+         {
+         return (static_cast<int>(m_Stages.size()));
+         }
+
+      DStageStats GetStageStats(int nStage) const;
+
+      // Frames replaced before the first stage got to them, thrown away by
+      // a pause or with no slot free to take them
+      int GetDroppedFrames() const
+         {
+         return (m_nDropped);
+         }
+
+      // Frames waiting for any stage
+      int GetQueuedFrames() const;
+
+      void ResetStats();
+
+      // Holds every stage still for as long as it exists
+      class DPause
+         {
+         public:
+            explicit DPause(DBlobPipeline& Pipeline);
+
+            DPause(const DPause& src) = delete;
+
+            ~DPause();
+
+            DPause& operator=(const DPause& rhs) = delete;
+
+         protected:
+            DBlobPipeline& m_Pipeline;
+
+         private:
+
+         }; // end of class DBlobPipeline::DPause
+
+   protected:
+      using DClock = std::chrono::steady_clock;
+
+      struct DStageThread
+         {
+         DStage Stage;
+         // Held while working on a frame and by DPause
+         std::mutex Mutex;
+         // Rung when a frame is handed to the stage
+         std::mutex BellMutex;
+         std::condition_variable Bell;
+         // Frames done, for the next stage or the consumer
+         std::unique_ptr<DSPSCRing<int> > pOutput;
+
+         std::atomic<int> nProcessed;
+         std::atomic<int> nStalls;
+         std::atomic<int64_t> nBusyTime;
+
+         std::thread Thread;
+         };
+
+      std::vector<std::unique_ptr<DStageThread> > m_Stages;
+      DReady m_Ready;
+
+      // Slots the consumer has handed back
+      DSPSCRing<int> m_FreeSlots;
+      // The newest frame submitted, -1 when the first stage has taken it
+      std::atomic<int> m_nMailbox;
+      // A replaced frame's slot, kept by the producer for the next frame
+      int m_nSpareSlot;
+
+      // Bumped by each pause.  The first stage stamps each frame with it
+      // and frames stamped before the last pause are dropped.
+      std::atomic<int> m_nGeneration;
+      std::vector<int> m_SlotGenerations;
+
+      std::atomic<int> m_nDropped;
+      std::atomic<int64_t> m_nStatsStart;
+      std::atomic<bool> m_bQuit;
+
+      bool TakeInput(int nStage, int& nSlot);
+      bool HasInput(int nStage) const;
+      void RingBell(DStageThread& Stage);
+      void Run(int nStage);
+
+      static int64_t Now()
+         {
+         return (std::chrono::duration_cast<std::chrono::nanoseconds>(
+               DClock::now().time_since_epoch()).count());
+         }
+
+   private:
+
+   }; // end of class DBlobPipeline
+
+#endif // __DBLOBPIPELINE_H__
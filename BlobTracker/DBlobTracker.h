@@ -1,16 +1,16 @@
-/*
- * DBlobTracker.h
- *
- *  Created on: Jul 3, 2014
- *      Author: Tim
- */
-
-#ifndef DBLOBTRACKER_H_
-#define DBLOBTRACKER_H_
-
-namespace DBlobTracker
-   {
-   enum EColorScheme { eRGB, eHSV, eHSL };
-   }  // end namespace DBlobTracker
-
-#endif /* DBLOBTRACKER_H_ */
+/*
+ * DBlobTracker.h
+ *
+ *  Created on: Jul 3, 2014
+ *      Author: Tim
+ */
+
+#ifndef DBLOBTRACKER_H_
+#define DBLOBTRACKER_H_
+
+namespace DBlobTracker
+   {
+   enum EColorScheme { eRGB, eHSV, eHSL, eYCbCr };
+   }  // end namespace DBlobTracker
+
+#endif /* DBLOBTRACKER_H_ */
@@ -1,967 +1,1929 @@
-/*
- * DBlobTrackerMainWindow.cpp
- *
- *  Created on: May 25, 2014
- *      Author: Tim
- */
-
-/*****************************************************************************
- ******************************  I N C L U D E  ******************************
- ****************************************************************************/
-
-#include "DBlobTrackerMainWindow.h"
-#include "DQCVImageUtils.h"
-
-#include <QMessageBox>
-#include <QStatusBar>
-#include <QFileDialog>
-
-#include <iomanip>
-#include <iostream>
-#include <fstream>
-#include <boost/config.hpp>
-#include <boost/archive/xml_oarchive.hpp>
-#include <boost/archive/text_oarchive.hpp>
-#include <boost/serialization/vector.hpp>
-
-/*****************************************************************************
- ***  class DBlobParams
- ****************************************************************************/
-
-/******************************************************************************
-*
-***  DBlobParams::Read
-*
-* Read the blob parameters from a Boost Serialization XML Archive.
-*
-******************************************************************************/
-
-bool DBlobParams::Read(const std::string& strPath)
-   {
-   std::ifstream ifs(strPath);
-   bool bRet = ifs.good();
-   if (bRet)
-      {
-      boost::archive::xml_iarchive ia(ifs);
-      ia & boost::serialization::make_nvp("Blob_Params", *this);
-      } // end if
-
-   ifs.close();
-
-   return (bRet);
-
-   } // end of method DBlobParams::Read
-
-/******************************************************************************
-*
-***  DBlobParams::Write
-*
-* Write the blob parameters to a Boost Serialization XML Archive.
-*
-******************************************************************************/
-
-bool DBlobParams::Write(const std::string& strPath) const
-   {
-   std::ofstream ofs(strPath);
-   bool bRet = ofs.good();
-   if (bRet)
-      {
-      boost::archive::xml_oarchive oa(ofs);
-      oa & boost::serialization::make_nvp("Blob_Params", *this);
-      } // end if
-
-   ofs.close();
-
-   return (bRet);
-
-   } // end of method DBlobParams::Write
-
-/*****************************************************************************
- ***  class DBlobTrackerMainWindow
- ****************************************************************************/
-
-/*****************************************************************************
- *
- ***  DBlobTrackerMainWindow::DBlobTrackerMainWindow
- *
- ****************************************************************************/
-
-DBlobTrackerMainWindow::DBlobTrackerMainWindow(QWidget* pParent /* = nullptr */) :
-      Base(pParent),
-      m_pBlobFinder(nullptr),
-      m_pColorTableEditor(nullptr),
-      m_pBlobCount(nullptr),
-      m_pProcessTime(nullptr),
-      m_pActionSaveBlobFile(nullptr),
-      m_pActionLoadBlobFile(nullptr)
-   {
-   setGeometry(200, 200, 750, 800);
-
-   m_Params.SetColorSet(DBlobTracker::eHSV);
-
-   m_bDisplayCategories = false;
-   m_bDisplayLargest = false;
-   m_bShowBoundingBox = false;
-   m_bShowCrossHairs = false;
-   m_nBlobDisplay = DBlob::eBlob;
-
-   m_strAppName = "DruaiBlobTracker";
-
-   return;
-
-   } // end of DBlobTrackerMainWindow::DBlobTrackerMainWindow
-
-/*****************************************************************************
- *
- ***  DBlobTrackerMainWindow::Initialize
- *
- ****************************************************************************/
-
-void DBlobTrackerMainWindow::Initialize(
-      Qt::Orientation eOrientation /* = Qt::Vertcial */)
-   {
-   Base::Initialize(eOrientation);
-
-   SetupColorStrings();
-
-   AddBlobMenu();
-
-   SetupStatusBar();
-
-   // Make the captured image valid until one is actually captured
-   m_CapturedImage = DCVImage(m_ImageSize.width(), m_ImageSize.height(), CV_8UC3);
-   m_CapturedImage.Clear();
-
-   SetColorScheme(m_Params.GetColorSet());
-
-   m_pCameraHandler->StartCamera();
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::Initialize
-
-/*****************************************************************************
- *
- ***  DBlobTrackerMainWindow::SetupCentralWidget
- *
- ****************************************************************************/
-
-void DBlobTrackerMainWindow::SetupCentralWidget()
-   {
-   Base::SetupCentralWidget();
-
-   CreateHistogramWidgets();
-
-   CreateColorTable();
-
-   // Setup to reprocess image if ROI changes
-   connect(m_pInputImageWidget, SIGNAL(ROIChanged(const QRect&)), this, SLOT(UpdateHistograms()));
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::SetupCentralWidget
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::SetupStatusBar()
-*
-******************************************************************************/
-
-void DBlobTrackerMainWindow::SetupStatusBar()
-   {
-   QStatusBar* pSB = statusBar();
-
-   QLabel* pTime = new QLabel(tr("Process Time:"));
-   pSB->addPermanentWidget(pTime);
-   m_pProcessTime = new QLabel(tr("9999"));
-   m_pProcessTime->setMinimumSize(m_pProcessTime->sizeHint());
-   m_pProcessTime->setAlignment(Qt::AlignRight);
-   pSB->addPermanentWidget(m_pProcessTime);
-   QLabel* pMS = new QLabel(tr("ms"));
-   pSB->addPermanentWidget(pMS);
-
-   QLabel* pBlobs = new QLabel(tr("Blob Count:"));
-   pSB->addPermanentWidget(pBlobs);
-   m_pBlobCount = new QLabel(tr("999999999999999999"));
-   m_pBlobCount->setMinimumSize(m_pBlobCount->sizeHint());
-   m_pBlobCount->setAlignment(Qt::AlignLeft);
-   pSB->addPermanentWidget(m_pBlobCount);
-
-   m_pBlobCount->setText("");
-   m_pProcessTime->setText("");
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::SetupStatusBar
-
-/*****************************************************************************
-*
-***  DBlobTrackerMainWindow::SetupColorStrings
-*
-****************************************************************************/
-
-void DBlobTrackerMainWindow::SetupColorStrings()
-   {
-   m_ColorSchemeNames << tr("RGB") << tr("HSV") << tr("HSL");
-
-   QStringList RGB;
-   RGB << tr("Red") << tr("Green") << tr("Blue");
-   QStringList HSV;
-   HSV << tr("Hue") << tr("Saturation") << tr("Value");
-   QStringList HSL;
-   HSL << tr("Hue") << tr("Saturation") << tr("Lightness");
-
-   m_ColorComponentNames.push_back(RGB);
-   m_ColorComponentNames.push_back(HSV);
-   m_ColorComponentNames.push_back(HSL);
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::SetupColorStrings
-
-/*****************************************************************************
- *
- ***  DBlobTrackerMainWindow::AddBlobMenu
- *
- ****************************************************************************/
-
-QMenu* DBlobTrackerMainWindow::AddBlobMenu()
-   {
-   QMenu* pBlobMenu = GetMenuBar()->addMenu(tr("&Blob"));
-
-   // Action Group for the color schemes
-   QActionGroup* pColorGroup = new QActionGroup(this);
-   pColorGroup->setExclusive(true);
-
-   QAction* pColorAction = new QAction(tr("RGB"), pColorGroup);
-   pColorAction->setCheckable(true);
-   pColorAction->setData(QVariant(DBlobTracker::eRGB));
-
-   pBlobMenu->addAction(pColorAction);
-   pColorAction->setChecked(pColorAction->data().toInt() == m_Params.GetColorSet());
-
-   pColorAction = new QAction(tr("HSV"), pColorGroup);
-   pColorAction->setCheckable(true);
-   pColorAction->setData(QVariant(DBlobTracker::eHSV));
-
-   pBlobMenu->addAction(pColorAction);
-   pColorAction->setChecked(pColorAction->data().toInt() == m_Params.GetColorSet());
-
-   pColorAction = new QAction(tr("HSL"), pColorGroup);
-   pColorAction->setCheckable(true);
-   pColorAction->setData(QVariant(DBlobTracker::eHSL));
-
-   pBlobMenu->addAction(pColorAction);
-   pColorAction->setChecked(pColorAction->data().toInt() == m_Params.GetColorSet());
-
-   connect(pColorGroup, SIGNAL(triggered(QAction*)),
-         SLOT(ChangeColorScheme(QAction*)));
-
-   pBlobMenu->addSeparator();
-
-   // Menu items to "decorate" the blobs for easier viewing
-
-   QAction* pActionBoundingBox = new QAction(tr("Bounding Boxes"), this);
-   pActionBoundingBox->setStatusTip(tr("Show the Blob Bounding Boxes"));
-   pActionBoundingBox->setCheckable(true);
-   pBlobMenu->addAction(pActionBoundingBox);
-   connect(pActionBoundingBox, SIGNAL(toggled(bool)),
-         SLOT(ShowBoundingBoxAction(bool)));
-
-   QAction* pActionCrossHairs = new QAction(tr("Cross Hairs"), this);
-   pActionCrossHairs->setStatusTip(tr("Show Cross Hairs on Blob Centroid"));
-   pActionCrossHairs->setCheckable(true);
-   pBlobMenu->addAction(pActionCrossHairs);
-   connect(pActionCrossHairs, SIGNAL(toggled(bool)), SLOT(ShowCrossHairsAction(bool)));
-
-   QAction* pActionLargestBlob = new QAction(tr("Largest Blob"), this);
-   pActionLargestBlob->setStatusTip(tr("Show Only the Largest Blob"));
-   pActionLargestBlob->setCheckable(true);
-   pBlobMenu->addAction(pActionLargestBlob);
-   connect(pActionLargestBlob, SIGNAL(toggled(bool)), SLOT(DisplayLargestAction(bool)));
-
-   // Add save and load blob file to the File menu
-   m_pActionSaveBlobFile = new QAction(tr("Save Blob File..."), this);
-   m_pActionSaveBlobFile->setEnabled(false);
-   m_pFileMenu->insertAction(m_pActionExit, m_pActionSaveBlobFile);
-   connect(m_pActionSaveBlobFile, SIGNAL(triggered()), SLOT(OnSaveBlobFile()));
-
-   m_pActionLoadBlobFile = new QAction(tr("Load Blob File..."), this);
-   m_pActionLoadBlobFile->setEnabled(false);
-   m_pFileMenu->insertAction(m_pActionExit, m_pActionLoadBlobFile);
-   connect(m_pActionLoadBlobFile, SIGNAL(triggered()), SLOT(OnLoadBlobFile()));
-
-   m_pFileMenu->insertSeparator(m_pActionExit);
-
-
-   return (pBlobMenu);
-
-   } // end of method DBlobTrackerMainWindow::AddBlobMenu
-
-/*****************************************************************************
-*
-***  DBlobTrackerMainWindow::UpdateFileActions
-*
-* Some file actions are inappropriate when the camera is running.  Enable or
-* disable based on the camera state.
-*
-****************************************************************************/
-
-void DBlobTrackerMainWindow::UpdateFileActions()
-   {
-   Base::UpdateFileActions();
-
-   bool bEnable = !m_pCameraHandler->IsRunning();
-
-   m_pActionSaveBlobFile->setEnabled(bEnable);
-   m_pActionLoadBlobFile->setEnabled(bEnable);
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::UpdateFileActions
-
-/*****************************************************************************
- *
- ***  DBlobTrackerMainWindow::CreateHistogramWidgets
- *
- ****************************************************************************/
-
-void DBlobTrackerMainWindow::CreateHistogramWidgets()
-   {
-   QVBoxLayout* pHistogramBox = new QVBoxLayout();
-
-   for (int i = 0 ; i < 3 ; i++)
-      {
-      QHBoxLayout* pHBox = new QHBoxLayout();
-
-      // Create a label for each histogram
-      QLabel* pLabel = new QLabel(this);
-      pLabel->setStyleSheet("QLabel{font: bold 20px}");
-      m_HistogramLabels.push_back(pLabel);
-      pHBox->addWidget(pLabel);
-
-      // Create the Histogram Widgets and insert into the grid
-      DQHistogramWidget* pHistogramWidget = new DQHistogramWidget(
-            qRgb(0, 0, 0));
-      m_HistogramWidgets.push_back(pHistogramWidget);
-      pHBox->addWidget(pHistogramWidget);
-
-      pHistogramBox->addLayout(pHBox);
-      } // end for
-
-   m_pMainGrid->addLayout(pHistogramBox, 0, 1, 2, 1);
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::CreateHistogramWidgets
-
-/*****************************************************************************
-*
-***  DBlobTrackerMainWindow::CreateColorTable
-*
-****************************************************************************/
-
-void DBlobTrackerMainWindow::CreateColorTable()
-   {
-   m_pColorTableEditor = new DColorRangeTableEditor(this);
-   m_pMainGrid->addWidget(m_pColorTableEditor, 2, 0, 1, 2);
-
-   // If we automatically loaded a saved parameter file, display it
-   if (m_Params.GetColors().size() > 0)
-      {
-      LoadColorTable();
-      } // end if
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::CreateColorTable
-
-/*****************************************************************************
- *
- ***  DBlobTrackerMainWindow::ChangeColorScheme
- *
- *  Handle the menu selections for changing the color scheme in the 3
- *  alternative color plane widgets.
- *
- ****************************************************************************/
-
-void DBlobTrackerMainWindow::ChangeColorScheme(QAction* pAction)
-   {
-   int nColorScheme = pAction->data().toInt();
-   if (nColorScheme != m_Params.GetColorSet())
-      {
-      SetColorScheme(nColorScheme);
-
-      // User changed the color scheme so reprocess the image
-      if (!m_pCameraHandler->IsRunning())
-         {
-         // If camera stopped, update the output display
-         ProcessImage(m_CapturedImage);
-         } // end if
-      } // end if
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::ChangeColorScheme
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::DisplayLargestAction
-*
-* Handle menu item for displaying the largest blob.
-*
-******************************************************************************/
-
-void DBlobTrackerMainWindow::DisplayLargestAction(bool bChecked)
-   {
-   m_bDisplayLargest = bChecked;
-
-   if (!m_pCameraHandler->IsRunning())
-      {
-      // If camera stopped, update the output display
-      DisplayOutput();
-      } // end if
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::DisplayLargestAction
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::ShowBoundingBoxAction
-*
-* Handle the menu item for showing blob bounding boxes.
-*
-******************************************************************************/
-
-void DBlobTrackerMainWindow::ShowBoundingBoxAction(bool bChecked)
-   {
-   m_bShowBoundingBox = bChecked;
-
-   if (m_bShowBoundingBox)
-      {
-      m_nBlobDisplay |= DBlob::eBoundingRect;
-      } // end if
-   else
-      {
-      m_nBlobDisplay &= ~DBlob::eBoundingRect;
-      } // end else
-
-   if (!m_pCameraHandler->IsRunning())
-      {
-      // If camera stopped, update the output display
-      DisplayOutput();
-      } // end if
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::ShowBoundingBoxAction
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::ShowCrossHairsAction
-*
-* Handle menu item for displaying cross hairs at the blob centroid.
-*
-******************************************************************************/
-
-void DBlobTrackerMainWindow::ShowCrossHairsAction(bool bChecked)
-   {
-   m_bShowCrossHairs = bChecked;
-
-   if (m_bShowCrossHairs)
-      {
-      m_nBlobDisplay |= DBlob::eCrossHairs;
-      } // end if
-   else
-      {
-      m_nBlobDisplay &= ~DBlob::eCrossHairs;
-      } // end else
-
-   if (!m_pCameraHandler->IsRunning())
-      {
-      // If camera stopped, update the output display
-      DisplayOutput();
-      } // end if
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::ShowCrossHairsAction
-
-/*****************************************************************************
- *
- ***  DBlobTrackerMainWindow::SetColorScheme
- *
- ****************************************************************************/
-
-void DBlobTrackerMainWindow::SetColorScheme(int nColorScheme)
-   {
-   m_Params.SetColorSet(nColorScheme);
-
-   if (nColorScheme == DBlobTracker::eRGB)
-      {
-      delete m_pBlobFinder;
-      m_pBlobFinder = new DColorBlobFinder(&m_Params.GetColors());
-
-      m_HistogramWidgets[0]->SetLineColor(qRgb(255, 0, 0));
-      m_HistogramWidgets[1]->SetLineColor(qRgb(0, 255, 0));
-      m_HistogramWidgets[2]->SetLineColor(qRgb(0, 0, 255));
-      } // end if
-   else if (nColorScheme == DBlobTracker::eHSV)
-      {
-      delete m_pBlobFinder;
-      m_pBlobFinder = new DColorBlobFinderHSV(&m_Params.GetColors());
-
-      m_HistogramWidgets[0]->SetLineColor(qRgb(255, 0, 255));
-      m_HistogramWidgets[1]->SetLineColor(qRgb(0, 255, 255));
-      m_HistogramWidgets[2]->SetLineColor(qRgb(0, 0, 0));
-      } // end else if
-   else if (nColorScheme == DBlobTracker::eHSL)
-      {
-      delete m_pBlobFinder;
-      m_pBlobFinder = new DColorBlobFinderHSL(&m_Params.GetColors());
-
-      m_HistogramWidgets[0]->SetLineColor(qRgb(255, 0, 255));
-      m_HistogramWidgets[1]->SetLineColor(qRgb(0, 255, 255));
-      m_HistogramWidgets[2]->SetLineColor(qRgb(0, 0, 0));
-      } // end else if
-
-   QStringList Names = m_ColorComponentNames[nColorScheme];
-   m_HistogramLabels[0]->setText(Names[0]);
-   m_HistogramLabels[1]->setText(Names[1]);
-   m_HistogramLabels[2]->setText(Names[2]);
-
-   m_pColorTableEditor->SetColorScheme(
-         static_cast<DBlobTracker::EColorScheme>(m_Params.GetColorSet()),
-         m_ColorSchemeNames[nColorScheme],
-         m_ColorComponentNames[nColorScheme]);
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::SetColorScheme
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::CameraStarted
-*
-******************************************************************************/
-
-void DBlobTrackerMainWindow::CameraStarted()
-   {
-   // Get what's currently in the color table
-   if (ExtractColorTable())
-      {
-      // Prohibit editing the color table while running
-      m_pColorTableEditor->setEnabled(false);
-
-      Base::CameraStarted();
-      } // end if
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::CameraStarted
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::CameraStopped
-*
-******************************************************************************/
-
-void DBlobTrackerMainWindow::CameraStopped()
-   {
-   Base::CameraStopped();
-\
-   // Let them edit away
-   m_pColorTableEditor->setEnabled(true);
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::CameraStopped
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::ExtractColorTable
-*
-* Extract the data from the Color Table Editor Widget and store them in the
-* Blob parameters object for processing.
-*
-******************************************************************************/
-
-bool DBlobTrackerMainWindow::ExtractColorTable()
-   {
-   bool bRet = true;
-
-   // Just recreate the table, it's easier
-   m_Params.GetColors().clear();
-
-   DColorRangeTableWidget* pTable = m_pColorTableEditor->GetColorTable();
-
-   // Not currently using
-   QString strBlobName;
-
-   for (int r = DColorRangeTableWidget::eBackgroundRow ; bRet && (r < pTable->rowCount()) ; r++)
-      {
-      int nValues[6];
-      int nVal = 0;
-      bool bCircular = false;
-//      strBlobName = m_pColorGrid->GetRowLabelValue(r);
-
-      for (int c = DColorRangeTableWidget::eMin1 ;
-            bRet && (c <= DColorRangeTableWidget::eMax3) ; c++)
-         {
-         QTableWidgetItem* pItem = pTable->item(r, c);
-         if (pItem != nullptr)
-            {
-            if (c == DColorRangeTableWidget::eCirc1)
-               {
-               bCircular = (pItem->checkState() == Qt::Checked);
-               } // end if
-            else
-               {
-               nValues[nVal++] = pItem->text().toInt(&bRet);
-               } // end else
-            } // end if
-         else
-            {
-            bRet = false;
-            } // end else
-         } // end for
-
-      QTableWidgetItem* pColor = pTable->item(r, DColorRangeTableWidget::eDispColor);
-      QColor DisplayColor;
-      if (pColor != nullptr)
-         {
-         DisplayColor = pColor->backgroundColor();
-         } // end if
-
-      if (bRet)
-         {
-         if (bCircular && (nValues[0] < nValues[1]))
-            {
-            std::swap(nValues[0], nValues[1]);
-            } // end if
-
-         DBlob::DBlobColorRange::RangeTest Test1(nValues[0], nValues[1],
-               bCircular);
-         DBlob::DBlobColorRange::RangeTest Test2(nValues[2], nValues[3]);
-         DBlob::DBlobColorRange::RangeTest Test3(nValues[4], nValues[5]);
-
-         DBlob::DBlobColorRange ColorRange(Test1, Test2, Test3);
-
-         m_Params.GetColors().push_back(DBlobColor(strBlobName.toStdString(),
-               ColorRange, DCVRGB(DisplayColor)));
-         } // end if
-      } // end for
-
-   if (!bRet)
-      {
-      QMessageBox::critical(this, tr("Error"), tr("Failure to extract color table"), QMessageBox::Ok);
-      } // end if
-
-   return (bRet);
-
-   } // end of method DBlobTrackerMainWindow::ExtractColorTable
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::LoadColorTable
-*
-* Transfer a set of blob colors to the ColorRangeTableWidget for display and
-* editing.
-*
-******************************************************************************/
-
-void DBlobTrackerMainWindow::LoadColorTable()
-   {
-   DColorRangeTableWidget* pTable = m_pColorTableEditor->GetColorTable();
-   pTable->LoadColorTable(m_Params.GetColors());
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::LoadColorTable
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::ReprocessImage
-*
-* Handle reprocessing the last image.  Only applicable when the camera is
-* stopped.
-*
-******************************************************************************/
-
-void DBlobTrackerMainWindow::ReprocessImage()
-   {
-   // Extract the color table in case the user modified it
-   if (ExtractColorTable())
-      {
-      Base::ReprocessImage();
-      } // end if
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::ReprocessImage
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::SaveParameters()
-*
-* Save the program parameters.  In this case, the Blob Color Table.
-*
-******************************************************************************/
-
-bool DBlobTrackerMainWindow::SaveParameters()
-   {
-
-   return (SaveBlobFile(GetParameterPath("xml").toStdString()));
-
-   } // end of method DBlobTrackerMainWindow::SaveParameters
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::LoadParameters()
-*
-* Load the program parameters.  In this case, the Blob Color Table.
-*
-******************************************************************************/
-
-bool DBlobTrackerMainWindow::LoadParameters()
-   {
-
-   return (m_Params.Read(GetParameterPath("xml").toStdString()));
-
-   } // end of method DBlobTrackerMainWindow::LoadParameters()
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::OnSaveBlobFile
-*
-* Handle the menu item for saving the Blob Color Table to file.
-*
-******************************************************************************/
-
-void DBlobTrackerMainWindow::OnSaveBlobFile()
-   {
-   QString strFileName = QFileDialog::getSaveFileName(this,
-         tr("Save Blob File As"), QDir::currentPath(),
-         tr("Blob files (*.xml)"));
-   if (!strFileName.isEmpty())
-      {
-      SaveBlobFile(strFileName.toStdString());
-      } // end if
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::OnSaveBlobFile
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::OnLoadBlobFile
-*
-* Handle the menu item for loading the Blob Color Table from file.
-*
-******************************************************************************/
-
-void DBlobTrackerMainWindow::OnLoadBlobFile()
-   {
-   QString strFileName = QFileDialog::getOpenFileName(this,
-         tr("Load Blob files (*.xml)"));
-
-   if (!strFileName.isEmpty())
-      {
-      if (!LoadBlobFile(strFileName.toStdString()))
-         {
-         QString strMsg(tr("Failed to load blob file "));
-         strMsg += strFileName;
-         QMessageBox::warning(this, tr("Load Blob File"), strMsg);
-         } // end if
-      } // end if
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::OnSaveLoadFile
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::SaveBlobFile
-*
-* Handle the mechanics of actually saving the Blob Color Table to file.
-*
-******************************************************************************/
-
-bool DBlobTrackerMainWindow::SaveBlobFile(const std::string& strPath)
-   {
-   bool bRet = ExtractColorTable();
-
-   if (bRet)
-      {
-      bRet = m_Params.Write(strPath);
-      } // end if
-
-   return (bRet);
-
-   } // end of method DBlobTrackerMainWindow::SaveBlobFile
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::LoadBlobFile
-*
-* Handle the mechanics of actually loading the Blob Color Table from file.
-*
-******************************************************************************/
-
-bool DBlobTrackerMainWindow::LoadBlobFile(const std::string& strPath)
-   {
-   bool bRet = m_Params.Read(strPath);
-
-   if (bRet)
-      {
-      LoadColorTable();
-      ReprocessImage();
-      } // end if
-
-   return (bRet);
-
-   } // end of method DBlobTrackerMainWindow::LoadBlobFile
-
-/*****************************************************************************
- *
- ***  DBlobTrackerMainWindow::ProcessImage
- *
- ****************************************************************************/
-
-void DBlobTrackerMainWindow::ProcessImage(DCVImage& Image)
-   {
-   m_CapturedImage = Image;
-
-   // Display the input image or camera capture in the input widget
-   DCVImage Display = Image.clone();
-   DQImage InputImage = cvMatToQImage(Display);
-   InputImage.SetROI(m_pInputImageWidget->GetImage().GetROI());
-   m_pInputImageWidget->SetImage(InputImage);
-
-   m_Timer.start();
-   m_pBlobFinder->Find(&m_CapturedImage);
-   qint64 nElapsed = m_Timer.elapsed();
-
-   m_pProcessTime->setText(QString().setNum(nElapsed));
-
-//   int nBlobs = m_pBlobFinder->GetBlobs().size();
-
-   DisplayOutput();
-
-   UpdateHistograms();
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::ProcessImage
-
-/******************************************************************************
-*
-***  DBlobTrackerMainWindow::DisplayOutput
-*
-******************************************************************************/
-
-void DBlobTrackerMainWindow::DisplayOutput()
-   {
-   DQImage OutputImage(320, 240, QImage::Format_RGB32);
-   DQIBlobRenderer Renderer;
-
-   // Render directly to the QImage for display
-   Renderer.SetImage(&OutputImage);
-
-// Uncomment to debug the categorized image
-//   m_bDisplayCategories = true;
-   if (m_bDisplayCategories)
-      {
-      m_pBlobFinder->DisplayCategories(&Renderer);
-      } // end if
-   else
-      {
-      m_pBlobFinder->DisplayBackground(&Renderer);
-
-      if (m_bDisplayLargest)
-         {
-         m_pBlobFinder->DisplayLargestBlobs(&Renderer, m_nBlobDisplay,
-               DCVRGB(255, 255, 255), 2);
-         } // end if
-      else
-         {
-         m_pBlobFinder->DisplayBlobs(&Renderer, m_nBlobDisplay,
-               DCVRGB(255, 255, 255), 2);
-         } // end else
-      } // end else
-
-   Renderer.End();
-
-//   DQImage OutputImage = cvMatToQImage(OutputImage);
-   m_pOutputImageWidget->SetImage(OutputImage);
-
-   // Handle the status bar process message
-   const DBlobs& Blobs = m_pBlobFinder->GetBlobs();
-//   int nBlobs = Blobs.size();
-
-   QString strBlobCount;
-   if (Blobs.size() < 2)
-     {
-      // Only background blob found. (Zero would be an error)
-     strBlobCount = "0";
-      } // end if
-   else
-      {
-      // Build a string showing the number of blobs in each category
-      strBlobCount.setNum(Blobs[1].size());
-
-      for (size_t i = 2 ; i < Blobs.size() ; i++)
-         {
-         QString strBlob;
-         strBlobCount += ", ";
-         strBlob.setNum(Blobs[i].size());
-         strBlobCount += strBlob;
-         } // end for
-      } // end else
-   m_pBlobCount->setText(strBlobCount);
-
-   return;
-
-   } // end of method DBlobTrackerMainWindow::DisplayOutput
-
-/*****************************************************************************
- *
- ***  DBlobTrackerMainWindow::UpdateHistograms
- *
- ****************************************************************************/
-
-void DBlobTrackerMainWindow::UpdateHistograms()
-   {
-   DQImage& Image = m_pInputImageWidget->GetImage();
-
-   if (m_Params.GetColorSet() == DBlobTracker::eRGB)
-      {
-      Image.RedChannel().CalcHistogram(m_HistogramWidgets[0]->GetHistogram());
-      Image.GreenChannel().CalcHistogram(m_HistogramWidgets[1]->GetHistogram());
-      Image.BlueChannel().CalcHistogram(m_HistogramWidgets[2]->GetHistogram());
-
-      m_pColorTableEditor->GetColorTable()->hideColumn(2);
-      } // end if
-   else if (m_Params.GetColorSet() == DBlobTracker::eHSV)
-      {
-      Image.HSVHue8Channel().CalcHistogram(m_HistogramWidgets[0]->GetHistogram());
-      Image.HSVSaturationChannel().CalcHistogram(m_HistogramWidgets[1]->GetHistogram());
-      Image.HSVValueChannel().CalcHistogram(m_HistogramWidgets[2]->GetHistogram());
-
-      m_pColorTableEditor->GetColorTable()->showColumn(2);
-      } // end else if
-   else if (m_Params.GetColorSet() == DBlobTracker::eHSL)
-      {
-      Image.HSLHue8Channel().CalcHistogram(m_HistogramWidgets[0]->GetHistogram());
-      Image.HSLSaturationChannel().CalcHistogram(m_HistogramWidgets[1]->GetHistogram());
-      Image.HSLLightnessChannel().CalcHistogram(m_HistogramWidgets[2]->GetHistogram());
-
-      m_pColorTableEditor->GetColorTable()->showColumn(2);
-      } // end else if
-
-   update();
-
-   return;
-
-      } // end of method DBlobTrackerMainWindow::UpdateHistograms
+/*
+ * DBlobTrackerMainWindow.cpp
+ *
+ *  Created on: May 25, 2014
+ *      Author: Tim
+ */
+
+/*****************************************************************************
+ ******************************  I N C L U D E  ******************************
+ ****************************************************************************/
+
+#include "DBlobTrackerMainWindow.h"
+#include "DQCVImageUtils.h"
+
+#include <QMessageBox>
+#include <QStatusBar>
+#include <QFileDialog>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+#include <boost/config.hpp>
+#include <boost/archive/xml_oarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/serialization/vector.hpp>
+
+/*****************************************************************************
+ ***  class DBlobParams
+ ****************************************************************************/
+
+/******************************************************************************
+*
+***  DBlobParams::Read
+*
+* Read the blob parameters from a Boost Serialization XML Archive.
+*
+******************************************************************************/
+
+bool DBlobParams::Read(const std::string& strPath)
+   {
+   std::ifstream ifs(strPath);
+   bool bRet = ifs.good();
+   if (bRet)
+      {
+      boost::archive::xml_iarchive ia(ifs);
+      ia & boost::serialization::make_nvp("Blob_Params", *this);
+      } // end if
+
+   ifs.close();
+
+   return (bRet);
+
+   } // end of method DBlobParams::Read
+
+/******************************************************************************
+*
+***  DBlobParams::Write
+*
+* Write the blob parameters to a Boost Serialization XML Archive.
+*
+******************************************************************************/
+
+bool DBlobParams::Write(const std::string& strPath) const
+   {
+   std::ofstream ofs(strPath);
+   bool bRet = ofs.good();
+   if (bRet)
+      {
+      boost::archive::xml_oarchive oa(ofs);
+      oa & boost::serialization::make_nvp("Blob_Params", *this);
+      } // end if
+
+   ofs.close();
+
+   return (bRet);
+
+   } // end of method DBlobParams::Write
+
+/*****************************************************************************
+ ***  class DBlobTrackerMainWindow
+ ****************************************************************************/
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::DBlobTrackerMainWindow
+ *
+ ****************************************************************************/
+
+DBlobTrackerMainWindow::DBlobTrackerMainWindow(QWidget* pParent /* = nullptr */) :
+      Base(pParent),
+      m_pBlobFinder(nullptr),
+      m_pColorTableEditor(nullptr),
+      m_pBlobCount(nullptr),
+      m_pTrackCount(nullptr),
+      m_pProcessTime(nullptr),
+      m_pDroppedFrames(nullptr),
+      m_pQueueDepth(nullptr),
+      m_FramePool(10),
+      m_pActionSaveBlobFile(nullptr),
+      m_pActionLoadBlobFile(nullptr)
+   {
+   setGeometry(200, 200, 750, 800);
+
+   m_Params.SetColorSet(DBlobTracker::eHSV);
+
+   m_bDisplayCategories = false;
+   m_bDisplayLargest = false;
+   m_bShowBoundingBox = false;
+   m_bShowCrossHairs = false;
+   m_nBlobDisplay = DBlob::eBlob;
+   m_eClassifier = DColorBlobFinder::eClassifyLoop;
+   m_nThreads = 1;
+   m_bStatisticsOnly = false;
+   m_bPredictiveSearch = false;
+   m_bFindInROI = false;
+   m_bIncremental = false;
+   m_bValidateIncremental = false;
+   m_nFrameCount = 0;
+   m_nTrackedFrame = 0;
+
+   m_strAppName = "DruaiBlobTracker";
+
+   // Categorize, label and render on threads of their own, so the next
+   // frame is categorized while this one is labeled.  A slot for each stage
+   // and a few to be filled and shown.
+   const int nSlots = 6;
+   m_Slots.resize(nSlots);
+   m_pPipeline.reset(new DBlobPipeline(nSlots,
+         { [this](int nSlot) { CategorizeStage(nSlot); },
+         [this](int nSlot) { LabelStage(nSlot); },
+         [this](int nSlot) { RenderStage(nSlot); } },
+         [this] { QMetaObject::invokeMethod(this, "ShowResult", Qt::QueuedConnection); }));
+
+   return;
+
+   } // end of DBlobTrackerMainWindow::DBlobTrackerMainWindow
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::Initialize
+ *
+ ****************************************************************************/
+
+void DBlobTrackerMainWindow::Initialize(
+      Qt::Orientation eOrientation /* = Qt::Vertcial */)
+   {
+   Base::Initialize(eOrientation);
+
+   SetupColorStrings();
+
+   AddBlobMenu();
+
+   SetupStatusBar();
+
+   // Make the captured image valid until one is actually captured
+   m_CapturedImage = DCVImage(m_ImageSize.width(), m_ImageSize.height(), CV_8UC3);
+   m_CapturedImage.Clear();
+
+   SetColorScheme(m_Params.GetColorSet());
+
+   m_pCameraHandler->StartCamera();
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::Initialize
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::SetupCentralWidget
+ *
+ ****************************************************************************/
+
+void DBlobTrackerMainWindow::SetupCentralWidget()
+   {
+   Base::SetupCentralWidget();
+
+   CreateHistogramWidgets();
+
+   CreateColorTable();
+
+   // Setup to reprocess image if ROI changes
+   connect(m_pInputImageWidget, SIGNAL(ROIChanged(const QRect&)), this, SLOT(UpdateHistograms()));
+   connect(m_pInputImageWidget, SIGNAL(ROIChanged(const QRect&)), this, SLOT(InputROIChanged()));
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::SetupCentralWidget
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::SetupStatusBar()
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::SetupStatusBar()
+   {
+   QStatusBar* pSB = statusBar();
+
+   QLabel* pTime = new QLabel(tr("Process Time:"));
+   pSB->addPermanentWidget(pTime);
+   m_pProcessTime = new QLabel(tr("9999"));
+   m_pProcessTime->setMinimumSize(m_pProcessTime->sizeHint());
+   m_pProcessTime->setAlignment(Qt::AlignRight);
+   pSB->addPermanentWidget(m_pProcessTime);
+   QLabel* pMS = new QLabel(tr("ms"));
+   pSB->addPermanentWidget(pMS);
+
+   QLabel* pDropped = new QLabel(tr("Dropped:"));
+   pSB->addPermanentWidget(pDropped);
+   m_pDroppedFrames = new QLabel(tr("999999"));
+   m_pDroppedFrames->setMinimumSize(m_pDroppedFrames->sizeHint());
+   m_pDroppedFrames->setAlignment(Qt::AlignRight);
+   pSB->addPermanentWidget(m_pDroppedFrames);
+
+   QLabel* pQueued = new QLabel(tr("Queued:"));
+   pSB->addPermanentWidget(pQueued);
+   m_pQueueDepth = new QLabel(tr("99"));
+   m_pQueueDepth->setMinimumSize(m_pQueueDepth->sizeHint());
+   m_pQueueDepth->setAlignment(Qt::AlignRight);
+   pSB->addPermanentWidget(m_pQueueDepth);
+
+   QLabel* pBlobs = new QLabel(tr("Blob Count:"));
+   pSB->addPermanentWidget(pBlobs);
+   m_pBlobCount = new QLabel(tr("999999999999999999"));
+   m_pBlobCount->setMinimumSize(m_pBlobCount->sizeHint());
+   m_pBlobCount->setAlignment(Qt::AlignLeft);
+   pSB->addPermanentWidget(m_pBlobCount);
+
+   QLabel* pTracks = new QLabel(tr("Tracks:"));
+   pSB->addPermanentWidget(pTracks);
+   m_pTrackCount = new QLabel(tr("99999"));
+   m_pTrackCount->setMinimumSize(m_pTrackCount->sizeHint());
+   m_pTrackCount->setAlignment(Qt::AlignLeft);
+   pSB->addPermanentWidget(m_pTrackCount);
+
+   m_pBlobCount->setText("");
+   m_pTrackCount->setText("");
+   m_pProcessTime->setText("");
+   m_pDroppedFrames->setText("");
+   m_pQueueDepth->setText("");
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::SetupStatusBar
+
+/*****************************************************************************
+*
+***  DBlobTrackerMainWindow::SetupColorStrings
+*
+****************************************************************************/
+
+void DBlobTrackerMainWindow::SetupColorStrings()
+   {
+   m_ColorSchemeNames << tr("RGB") << tr("HSV") << tr("HSL") << tr("YCbCr");
+
+   QStringList RGB;
+   RGB << tr("Red") << tr("Green") << tr("Blue");
+   QStringList HSV;
+   HSV << tr("Hue") << tr("Saturation") << tr("Value");
+   QStringList HSL;
+   HSL << tr("Hue") << tr("Saturation") << tr("Lightness");
+   QStringList YCbCr;
+   YCbCr << tr("Luma") << tr("Blue Difference") << tr("Red Difference");
+
+   m_ColorComponentNames.push_back(RGB);
+   m_ColorComponentNames.push_back(HSV);
+   m_ColorComponentNames.push_back(HSL);
+   m_ColorComponentNames.push_back(YCbCr);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::SetupColorStrings
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::AddBlobMenu
+ *
+ ****************************************************************************/
+
+QMenu* DBlobTrackerMainWindow::AddBlobMenu()
+   {
+   QMenu* pBlobMenu = GetMenuBar()->addMenu(tr("&Blob"));
+
+   // Action Group for the color schemes
+   QActionGroup* pColorGroup = new QActionGroup(this);
+   pColorGroup->setExclusive(true);
+
+   QAction* pColorAction = new QAction(tr("RGB"), pColorGroup);
+   pColorAction->setCheckable(true);
+   pColorAction->setData(QVariant(DBlobTracker::eRGB));
+
+   pBlobMenu->addAction(pColorAction);
+   pColorAction->setChecked(pColorAction->data().toInt() == m_Params.GetColorSet());
+
+   pColorAction = new QAction(tr("HSV"), pColorGroup);
+   pColorAction->setCheckable(true);
+   pColorAction->setData(QVariant(DBlobTracker::eHSV));
+
+   pBlobMenu->addAction(pColorAction);
+   pColorAction->setChecked(pColorAction->data().toInt() == m_Params.GetColorSet());
+
+   pColorAction = new QAction(tr("HSL"), pColorGroup);
+   pColorAction->setCheckable(true);
+   pColorAction->setData(QVariant(DBlobTracker::eHSL));
+
+   pBlobMenu->addAction(pColorAction);
+   pColorAction->setChecked(pColorAction->data().toInt() == m_Params.GetColorSet());
+
+   pColorAction = new QAction(tr("YCbCr"), pColorGroup);
+   pColorAction->setCheckable(true);
+   pColorAction->setData(QVariant(DBlobTracker::eYCbCr));
+
+   pBlobMenu->addAction(pColorAction);
+   pColorAction->setChecked(pColorAction->data().toInt() == m_Params.GetColorSet());
+
+   connect(pColorGroup, SIGNAL(triggered(QAction*)),
+         SLOT(ChangeColorScheme(QAction*)));
+
+   pBlobMenu->addSeparator();
+
+   // Submenu for the pixel classification strategy
+   QMenu* pClassifierMenu = pBlobMenu->addMenu(tr("Classifier"));
+
+   QActionGroup* pClassifierGroup = new QActionGroup(this);
+   pClassifierGroup->setExclusive(true);
+
+   QAction* pClassifierAction = new QAction(tr("Per Color Test"), pClassifierGroup);
+   pClassifierAction->setCheckable(true);
+   pClassifierAction->setData(QVariant(DColorBlobFinder::eClassifyLoop));
+   pClassifierMenu->addAction(pClassifierAction);
+   pClassifierAction->setChecked(pClassifierAction->data().toInt() == m_eClassifier);
+
+   pClassifierAction = new QAction(tr("Channel Bitmask"), pClassifierGroup);
+   pClassifierAction->setCheckable(true);
+   pClassifierAction->setData(QVariant(DColorBlobFinder::eClassifyBitmask));
+   pClassifierMenu->addAction(pClassifierAction);
+   pClassifierAction->setChecked(pClassifierAction->data().toInt() == m_eClassifier);
+
+   pClassifierAction = new QAction(tr("SIMD Range Test"), pClassifierGroup);
+   pClassifierAction->setCheckable(true);
+   pClassifierAction->setData(QVariant(DColorBlobFinder::eClassifySIMD));
+   pClassifierMenu->addAction(pClassifierAction);
+   pClassifierAction->setChecked(pClassifierAction->data().toInt() == m_eClassifier);
+
+   pClassifierAction = new QAction(tr("24 Bit Lookup Table"), pClassifierGroup);
+   pClassifierAction->setCheckable(true);
+   pClassifierAction->setData(QVariant(DColorBlobFinder::eClassifyLookup24));
+   pClassifierMenu->addAction(pClassifierAction);
+   pClassifierAction->setChecked(pClassifierAction->data().toInt() == m_eClassifier);
+
+   pClassifierAction = new QAction(tr("5/6/5 Bit Lookup Table"), pClassifierGroup);
+   pClassifierAction->setCheckable(true);
+   pClassifierAction->setData(QVariant(DColorBlobFinder::eClassifyLookup565));
+   pClassifierMenu->addAction(pClassifierAction);
+   pClassifierAction->setChecked(pClassifierAction->data().toInt() == m_eClassifier);
+
+   connect(pClassifierGroup, SIGNAL(triggered(QAction*)),
+         SLOT(ChangeClassifier(QAction*)));
+
+   // Submenu for the number of threads finding blobs
+   QMenu* pThreadMenu = pBlobMenu->addMenu(tr("Threads"));
+
+   QActionGroup* pThreadGroup = new QActionGroup(this);
+   pThreadGroup->setExclusive(true);
+
+   // Powers of two below the core count, then all of them
+   int nCores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+   std::vector<int> ThreadCounts;
+   for (int nThreads = 1 ; nThreads < nCores ; nThreads *= 2)
+      {
+      ThreadCounts.push_back(nThreads);
+      } // end for
+   ThreadCounts.push_back(nCores);
+
+   for (int nThreads : ThreadCounts)
+      {
+      QString strText = (nThreads == nCores)
+            ? tr("All Cores (%1)").arg(nCores) : QString::number(nThreads);
+      QAction* pThreadAction = new QAction(strText, pThreadGroup);
+      pThreadAction->setCheckable(true);
+      pThreadAction->setData(QVariant(nThreads));
+      pThreadMenu->addAction(pThreadAction);
+      pThreadAction->setChecked(nThreads == m_nThreads);
+      } // end for
+
+   connect(pThreadGroup, SIGNAL(triggered(QAction*)),
+         SLOT(ChangeThreadCount(QAction*)));
+
+   QAction* pActionBenchmark = new QAction(tr("Benchmark Run Matching"), this);
+   pActionBenchmark->setStatusTip(tr("Time blob finding on the current image "
+         "with the pairwise and sweep run matching"));
+   pBlobMenu->addAction(pActionBenchmark);
+   connect(pActionBenchmark, SIGNAL(triggered()), SLOT(BenchmarkRunMatching()));
+
+   QAction* pActionScaling = new QAction(tr("Benchmark Thread Scaling"), this);
+   pActionScaling->setStatusTip(tr("Time blob finding on a 4K frame made from "
+         "the current image with each thread count"));
+   pBlobMenu->addAction(pActionScaling);
+   connect(pActionScaling, SIGNAL(triggered()), SLOT(BenchmarkThreadScaling()));
+
+   QAction* pActionYCbCr = new QAction(tr("Benchmark YUYV and NV12"), this);
+   pActionYCbCr->setStatusTip(tr("Time blob finding on YUYV and NV12 frames "
+         "made from the current image against converting them first"));
+   pBlobMenu->addAction(pActionYCbCr);
+   connect(pActionYCbCr, SIGNAL(triggered()), SLOT(BenchmarkYCbCr()));
+
+   QAction* pActionPipeline = new QAction(tr("Pipeline Statistics"), this);
+   pActionPipeline->setStatusTip(tr("Show how busy each stage of finding the "
+         "blobs is and how often it waits for a frame"));
+   pBlobMenu->addAction(pActionPipeline);
+   connect(pActionPipeline, SIGNAL(triggered()), SLOT(PipelineStatistics()));
+
+   QAction* pActionStatistics = new QAction(tr("Statistics Only"), this);
+   pActionStatistics->setStatusTip(tr("Keep only blob area, centroid and "
+         "bounds, drawing bounding boxes in place of the blobs"));
+   pActionStatistics->setCheckable(true);
+   pBlobMenu->addAction(pActionStatistics);
+   connect(pActionStatistics, SIGNAL(toggled(bool)),
+         SLOT(StatisticsOnlyAction(bool)));
+
+   QAction* pActionPredictive = new QAction(tr("Predictive Search"), this);
+   pActionPredictive->setStatusTip(tr("Search only around where the tracked "
+         "blobs should be, scanning the whole frame now and then"));
+   pActionPredictive->setCheckable(true);
+   pBlobMenu->addAction(pActionPredictive);
+   connect(pActionPredictive, SIGNAL(toggled(bool)),
+         SLOT(PredictiveSearchAction(bool)));
+
+   QAction* pActionFindInROI = new QAction(tr("Find In ROI"), this);
+   pActionFindInROI->setStatusTip(tr("Find blobs only inside the input "
+         "image's region of interest"));
+   pActionFindInROI->setCheckable(true);
+   pBlobMenu->addAction(pActionFindInROI);
+   connect(pActionFindInROI, SIGNAL(toggled(bool)), SLOT(FindInROIAction(bool)));
+
+   QAction* pActionIncremental = new QAction(tr("Incremental Update"), this);
+   pActionIncremental->setStatusTip(tr("Categorize only the tiles of the "
+         "image that changed since the last frame"));
+   pActionIncremental->setCheckable(true);
+   pBlobMenu->addAction(pActionIncremental);
+   connect(pActionIncremental, SIGNAL(toggled(bool)),
+         SLOT(IncrementalAction(bool)));
+
+   QAction* pActionValidate = new QAction(tr("Validate Incremental Update"), this);
+   pActionValidate->setStatusTip(tr("Check each incremental update against "
+         "categorizing the whole image"));
+   pActionValidate->setCheckable(true);
+   pBlobMenu->addAction(pActionValidate);
+   connect(pActionValidate, SIGNAL(toggled(bool)),
+         SLOT(ValidateIncrementalAction(bool)));
+
+   pBlobMenu->addSeparator();
+
+   // Menu items to "decorate" the blobs for easier viewing
+
+   QAction* pActionBoundingBox = new QAction(tr("Bounding Boxes"), this);
+   pActionBoundingBox->setStatusTip(tr("Show the Blob Bounding Boxes"));
+   pActionBoundingBox->setCheckable(true);
+   pBlobMenu->addAction(pActionBoundingBox);
+   connect(pActionBoundingBox, SIGNAL(toggled(bool)),
+         SLOT(ShowBoundingBoxAction(bool)));
+
+   QAction* pActionCrossHairs = new QAction(tr("Cross Hairs"), this);
+   pActionCrossHairs->setStatusTip(tr("Show Cross Hairs on Blob Centroid"));
+   pActionCrossHairs->setCheckable(true);
+   pBlobMenu->addAction(pActionCrossHairs);
+   connect(pActionCrossHairs, SIGNAL(toggled(bool)), SLOT(ShowCrossHairsAction(bool)));
+
+   QAction* pActionLargestBlob = new QAction(tr("Largest Blob"), this);
+   pActionLargestBlob->setStatusTip(tr("Show Only the Largest Blob"));
+   pActionLargestBlob->setCheckable(true);
+   pBlobMenu->addAction(pActionLargestBlob);
+   connect(pActionLargestBlob, SIGNAL(toggled(bool)), SLOT(DisplayLargestAction(bool)));
+
+   // Add save and load blob file to the File menu
+   m_pActionSaveBlobFile = new QAction(tr("Save Blob File..."), this);
+   m_pActionSaveBlobFile->setEnabled(false);
+   m_pFileMenu->insertAction(m_pActionExit, m_pActionSaveBlobFile);
+   connect(m_pActionSaveBlobFile, SIGNAL(triggered()), SLOT(OnSaveBlobFile()));
+
+   m_pActionLoadBlobFile = new QAction(tr("Load Blob File..."), this);
+   m_pActionLoadBlobFile->setEnabled(false);
+   m_pFileMenu->insertAction(m_pActionExit, m_pActionLoadBlobFile);
+   connect(m_pActionLoadBlobFile, SIGNAL(triggered()), SLOT(OnLoadBlobFile()));
+
+   m_pFileMenu->insertSeparator(m_pActionExit);
+
+
+   return (pBlobMenu);
+
+   } // end of method DBlobTrackerMainWindow::AddBlobMenu
+
+/*****************************************************************************
+*
+***  DBlobTrackerMainWindow::UpdateFileActions
+*
+* Some file actions are inappropriate when the camera is running.  Enable or
+* disable based on the camera state.
+*
+****************************************************************************/
+
+void DBlobTrackerMainWindow::UpdateFileActions()
+   {
+   Base::UpdateFileActions();
+
+   bool bEnable = !m_pCameraHandler->IsRunning();
+
+   m_pActionSaveBlobFile->setEnabled(bEnable);
+   m_pActionLoadBlobFile->setEnabled(bEnable);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::UpdateFileActions
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::CreateHistogramWidgets
+ *
+ ****************************************************************************/
+
+void DBlobTrackerMainWindow::CreateHistogramWidgets()
+   {
+   QVBoxLayout* pHistogramBox = new QVBoxLayout();
+
+   for (int i = 0 ; i < 3 ; i++)
+      {
+      QHBoxLayout* pHBox = new QHBoxLayout();
+
+      // Create a label for each histogram
+      QLabel* pLabel = new QLabel(this);
+      pLabel->setStyleSheet("QLabel{font: bold 20px}");
+      m_HistogramLabels.push_back(pLabel);
+      pHBox->addWidget(pLabel);
+
+      // Create the Histogram Widgets and insert into the grid
+      DQHistogramWidget* pHistogramWidget = new DQHistogramWidget(
+            qRgb(0, 0, 0));
+      m_HistogramWidgets.push_back(pHistogramWidget);
+      pHBox->addWidget(pHistogramWidget);
+
+      pHistogramBox->addLayout(pHBox);
+      } // end for
+
+   m_pMainGrid->addLayout(pHistogramBox, 0, 1, 2, 1);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::CreateHistogramWidgets
+
+/*****************************************************************************
+*
+***  DBlobTrackerMainWindow::CreateColorTable
+*
+****************************************************************************/
+
+void DBlobTrackerMainWindow::CreateColorTable()
+   {
+   m_pColorTableEditor = new DColorRangeTableEditor(this);
+   m_pMainGrid->addWidget(m_pColorTableEditor, 2, 0, 1, 2);
+
+   // If we automatically loaded a saved parameter file, display it
+   if (m_Params.GetColors().size() > 0)
+      {
+      LoadColorTable();
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::CreateColorTable
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::ChangeColorScheme
+ *
+ *  Handle the menu selections for changing the color scheme in the 3
+ *  alternative color plane widgets.
+ *
+ ****************************************************************************/
+
+void DBlobTrackerMainWindow::ChangeColorScheme(QAction* pAction)
+   {
+   int nColorScheme = pAction->data().toInt();
+   if (nColorScheme != m_Params.GetColorSet())
+      {
+      SetColorScheme(nColorScheme);
+
+      // User changed the color scheme so reprocess the image
+      if (!m_pCameraHandler->IsRunning())
+         {
+         // If camera stopped, update the output display
+         ProcessImage(m_CapturedImage);
+         } // end if
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::ChangeColorScheme
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::ChangeClassifier
+*
+* Handle the menu selections for the pixel classification strategy.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::ChangeClassifier(QAction* pAction)
+   {
+   m_eClassifier = static_cast<DColorBlobFinder::EClassifier>(pAction->data().toInt());
+      {
+      DBlobPipeline::DPause Pause(*m_pPipeline);
+      m_pBlobFinder->SetClassifier(m_eClassifier);
+      }
+
+   if (!m_pCameraHandler->IsRunning())
+      {
+      // If camera stopped, update the output display
+      ProcessImage(m_CapturedImage);
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::ChangeClassifier
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::ChangeThreadCount
+*
+* Handle the menu selections for the number of blob finding threads.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::ChangeThreadCount(QAction* pAction)
+   {
+   DBlobPipeline::DPause Pause(*m_pPipeline);
+   m_nThreads = pAction->data().toInt();
+   m_pBlobFinder->SetThreadCount(m_nThreads);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::ChangeThreadCount
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::StatisticsOnlyAction
+*
+* Handle the menu item for finding blobs without keeping their pixel runs.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::StatisticsOnlyAction(bool bChecked)
+   {
+   m_bStatisticsOnly = bChecked;
+      {
+      DBlobPipeline::DPause Pause(*m_pPipeline);
+      m_pBlobFinder->SetStoreRuns(!m_bStatisticsOnly);
+      }
+
+   if (!m_pCameraHandler->IsRunning())
+      {
+      // If camera stopped, find the blobs again the new way
+      ReprocessImage();
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::StatisticsOnlyAction
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::IncrementalAction
+*
+* Handle the menu item for recategorizing only the changed parts of frames.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::IncrementalAction(bool bChecked)
+   {
+   DBlobPipeline::DPause Pause(*m_pPipeline);
+   m_bIncremental = bChecked;
+   m_pBlobFinder->SetIncremental(m_bIncremental);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::IncrementalAction
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::ValidateIncrementalAction
+*
+* Handle the menu item for checking the incremental update.  Rows it got
+* wrong are reported on the status bar.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::ValidateIncrementalAction(bool bChecked)
+   {
+   DBlobPipeline::DPause Pause(*m_pPipeline);
+   m_bValidateIncremental = bChecked;
+   m_pBlobFinder->SetValidateIncremental(m_bValidateIncremental);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::ValidateIncrementalAction
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::PredictiveSearchAction
+*
+* Handle the menu item for searching only windows around the tracked blobs.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::PredictiveSearchAction(bool bChecked)
+   {
+   DBlobPipeline::DPause Pause(*m_pPipeline);
+   m_bPredictiveSearch = bChecked;
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::PredictiveSearchAction
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::FindInROIAction
+*
+* Handle the menu item for finding blobs in the region of interest only.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::FindInROIAction(bool bChecked)
+   {
+   m_bFindInROI = bChecked;
+
+   if (!m_pCameraHandler->IsRunning())
+      {
+      // If camera stopped, find the blobs again in the new area
+      ReprocessImage();
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::FindInROIAction
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::InputROIChanged
+*
+* The input image's region of interest moved.  Blobs found in it are stale.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::InputROIChanged()
+   {
+   if (m_bFindInROI && !m_pCameraHandler->IsRunning())
+      {
+      ReprocessImage();
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::InputROIChanged
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::DisplayLargestAction
+*
+* Handle menu item for displaying the largest blob.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::DisplayLargestAction(bool bChecked)
+   {
+      {
+      DBlobPipeline::DPause Pause(*m_pPipeline);
+      m_bDisplayLargest = bChecked;
+      UpdateLargestCounts();
+      }
+
+   if (!m_pCameraHandler->IsRunning())
+      {
+      // If camera stopped, update the output display
+      DisplayOutput();
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::DisplayLargestAction
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::UpdateLargestCounts
+*
+* Have the blob finder keep the largest blob of each color while labeling
+* when only the largest blobs are shown.  The caller pauses the pipeline.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::UpdateLargestCounts()
+   {
+   int nColors = static_cast<int>(m_Params.GetColors().size());
+   for (int c = 1 ; c < nColors ; c++)
+      {
+      m_pBlobFinder->SetLargestCount(c, m_bDisplayLargest ? 1 : 0);
+      } // end for
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::UpdateLargestCounts
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::ShowBoundingBoxAction
+*
+* Handle the menu item for showing blob bounding boxes.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::ShowBoundingBoxAction(bool bChecked)
+   {
+   m_bShowBoundingBox = bChecked;
+
+      {
+      DBlobPipeline::DPause Pause(*m_pPipeline);
+      if (m_bShowBoundingBox)
+         {
+         m_nBlobDisplay |= DBlob::eBoundingRect;
+         } // end if
+      else
+         {
+         m_nBlobDisplay &= ~DBlob::eBoundingRect;
+         } // end else
+      }
+
+   if (!m_pCameraHandler->IsRunning())
+      {
+      // If camera stopped, update the output display
+      DisplayOutput();
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::ShowBoundingBoxAction
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::ShowCrossHairsAction
+*
+* Handle menu item for displaying cross hairs at the blob centroid.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::ShowCrossHairsAction(bool bChecked)
+   {
+   m_bShowCrossHairs = bChecked;
+
+      {
+      DBlobPipeline::DPause Pause(*m_pPipeline);
+      if (m_bShowCrossHairs)
+         {
+         m_nBlobDisplay |= DBlob::eCrossHairs;
+         } // end if
+      else
+         {
+         m_nBlobDisplay &= ~DBlob::eCrossHairs;
+         } // end else
+      }
+
+   if (!m_pCameraHandler->IsRunning())
+      {
+      // If camera stopped, update the output display
+      DisplayOutput();
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::ShowCrossHairsAction
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::BenchmarkRunMatching
+*
+* Time finding blobs in the current image with each way of matching runs
+* between rows.  Noisy images with many small runs per row show the
+* difference best.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::BenchmarkRunMatching()
+   {
+   const int nFrames = 20;
+
+   // The stages wait until the timing is done, but not for the dialog
+   double dTime[2];
+      {
+      DBlobPipeline::DPause Pause(*m_pPipeline);
+      bool bLinear = m_pBlobFinder->IsLinearOverlap();
+
+      for (int i = 0 ; i < 2 ; i++)
+         {
+         m_pBlobFinder->SetLinearOverlap(i == 1);
+
+         // Warm up the caches and the compiled classifier
+         m_pBlobFinder->Find(&m_CapturedImage);
+
+         QElapsedTimer Timer;
+         Timer.start();
+         for (int f = 0 ; f < nFrames ; f++)
+            {
+            m_pBlobFinder->Find(&m_CapturedImage);
+            } // end for
+         dTime[i] = Timer.nsecsElapsed() / (1.0e6 * nFrames);
+         } // end for
+
+      m_pBlobFinder->SetLinearOverlap(bLinear);
+      }
+
+   QString strMsg = tr("Average of %1 frames\n\nPairwise: %2 ms\nSweep: %3 ms"
+         "\nSpeedup: %4x").arg(nFrames).arg(dTime[0], 0, 'f', 2)
+         .arg(dTime[1], 0, 'f', 2).arg(dTime[0] / std::max(dTime[1], 1.0e-6), 0, 'f', 1);
+   QMessageBox::information(this, tr("Benchmark Run Matching"), strMsg);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::BenchmarkRunMatching
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::BenchmarkThreadScaling
+*
+* Time finding blobs in a 3840 x 2160 frame with one thread up to all of the
+* cores.  The frame is the current image tiled out to size so it has blobs
+* of the colors being looked for.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::BenchmarkThreadScaling()
+   {
+   const int nFrames = 10;
+   const int nWidth = 3840;
+   const int nHeight = 2160;
+
+   if (m_CapturedImage.empty())
+      {
+      return;
+      } // end if
+
+   cv::Mat Tiled;
+   cv::repeat(m_CapturedImage, nHeight / m_CapturedImage.rows + 1,
+         nWidth / m_CapturedImage.cols + 1, Tiled);
+   DCVImage Frame;
+   Tiled(cv::Rect(0, 0, nWidth, nHeight)).copyTo(Frame);
+
+   QString strMsg = tr("Average of %1 frames of %2 x %3\n").arg(nFrames)
+         .arg(nWidth).arg(nHeight);
+
+   // The stages wait until the timing is done, but not for the dialog
+      {
+      DBlobPipeline::DPause Pause(*m_pPipeline);
+
+      // Powers of two below the core count, then all of them
+      int nCores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+      std::vector<int> ThreadCounts;
+      for (int nThreads = 1 ; nThreads < nCores ; nThreads *= 2)
+         {
+         ThreadCounts.push_back(nThreads);
+         } // end for
+      ThreadCounts.push_back(nCores);
+
+      double dSingle = 0.0;
+      for (int nThreads : ThreadCounts)
+         {
+         m_pBlobFinder->SetThreadCount(nThreads);
+
+         // Warm up the caches and the new threads
+         m_pBlobFinder->Find(&Frame);
+
+         QElapsedTimer Timer;
+         Timer.start();
+         for (int f = 0 ; f < nFrames ; f++)
+            {
+            m_pBlobFinder->Find(&Frame);
+            } // end for
+         double dTime = Timer.nsecsElapsed() / (1.0e6 * nFrames);
+         if (nThreads == 1)
+            {
+            dSingle = dTime;
+            } // end if
+
+         strMsg += tr("\n%1 threads: %2 ms  (%3x)").arg(nThreads)
+               .arg(dTime, 0, 'f', 2).arg(dSingle / std::max(dTime, 1.0e-6), 0, 'f', 1);
+         } // end for
+
+      // Leave the finder as it was
+      m_pBlobFinder->SetThreadCount(m_nThreads);
+      }
+
+   QMessageBox::information(this, tr("Benchmark Thread Scaling"), strMsg);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::BenchmarkThreadScaling
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::BenchmarkYCbCr
+*
+* Time finding blobs in YUYV and NV12 frames made from the current image,
+* as a camera would deliver them, against converting the YUYV frame to BGR
+* first.  Each pair of pixels, or 2 x 2 block for NV12, shares the average of
+* its chroma.  Only the YCbCr finder tests the frames as they are.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::BenchmarkYCbCr()
+   {
+   const int nFrames = 20;
+
+   if (m_CapturedImage.empty() || (m_CapturedImage.type() != CV_8UC3))
+      {
+      return;
+      } // end if
+
+   int nWidth = m_CapturedImage.cols & ~1;
+   int nHeight = m_CapturedImage.rows & ~1;
+   size_t nLumaSize = static_cast<size_t>(nWidth) * nHeight;
+   std::vector<uint8_t> YUYV(2 * nLumaSize);
+   std::vector<uint8_t> NV12(nLumaSize + nLumaSize / 2);
+
+   for (int r = 0 ; r < nHeight ; r++)
+      {
+      const unsigned char* pRow = m_CapturedImage.GetRow(r);
+      uint8_t* pYUYV = &YUYV[2 * static_cast<size_t>(r) * nWidth];
+      uint8_t* pLuma = &NV12[static_cast<size_t>(r) * nWidth];
+      for (int c = 0 ; c < nWidth ; c += 2, pYUYV += 4)
+         {
+         unsigned char Pixel[2][3];
+         DColorSpaceYCbCr::Convert(pRow + 3 * c, Pixel[0]);
+         DColorSpaceYCbCr::Convert(pRow + 3 * (c + 1), Pixel[1]);
+         pYUYV[0] = pLuma[c] = Pixel[0][0];
+         pYUYV[1] = static_cast<uint8_t>((Pixel[0][1] + Pixel[1][1] + 1) / 2);
+         pYUYV[2] = pLuma[c + 1] = Pixel[1][0];
+         pYUYV[3] = static_cast<uint8_t>((Pixel[0][2] + Pixel[1][2] + 1) / 2);
+         } // end for
+      } // end for
+
+   // NV12 chroma averages the YUYV chroma of each pair of rows
+   for (int r = 0 ; r < nHeight ; r += 2)
+      {
+      const uint8_t* pTop = &YUYV[2 * static_cast<size_t>(r) * nWidth];
+      const uint8_t* pBottom = pTop + 2 * nWidth;
+      uint8_t* pChroma = &NV12[nLumaSize + static_cast<size_t>(r / 2) * nWidth];
+      for (int c = 0 ; c < nWidth ; c += 2)
+         {
+         pChroma[c] = static_cast<uint8_t>((pTop[2 * c + 1] + pBottom[2 * c + 1] + 1) / 2);
+         pChroma[c + 1] = static_cast<uint8_t>((pTop[2 * c + 3] + pBottom[2 * c + 3] + 1) / 2);
+         } // end for
+      } // end for
+
+   cv::Mat YUYVFrame(nHeight, nWidth, CV_8UC2, YUYV.data());
+   DCVImage Converted;
+
+   static const char* pNames[] = { "BGR", "YUYV converted to BGR", "YUYV", "NV12" };
+   QString strMsg = tr("Average of %1 frames of %2 x %3\n").arg(nFrames)
+         .arg(nWidth).arg(nHeight);
+
+   // The stages wait until the timing is done, but not for the dialog
+      {
+      DBlobPipeline::DPause Pause(*m_pPipeline);
+      for (int nTest = 0 ; nTest < 4 ; nTest++)
+         {
+         // Warm up the caches and the compiled classifier on the first frame
+         QElapsedTimer Timer;
+         for (int f = -1 ; f < nFrames ; f++)
+            {
+            if (f == 0)
+               {
+               Timer.start();
+               } // end if
+
+            if (nTest == 0)
+               {
+               m_pBlobFinder->Find(&m_CapturedImage);
+               } // end if
+            else if (nTest == 1)
+               {
+               cv::cvtColor(YUYVFrame, Converted, cv::COLOR_YUV2BGR_YUYV);
+               m_pBlobFinder->Find(&Converted);
+               } // end else if
+            else if (nTest == 2)
+               {
+               m_pBlobFinder->Find(YUYV.data(), nWidth, nHeight, 2 * nWidth,
+                     DColorBlobFinder::eYUYV);
+               } // end else if
+            else
+               {
+               m_pBlobFinder->Find(NV12.data(), nWidth, nHeight, nWidth,
+                     DColorBlobFinder::eNV12);
+               } // end else
+            } // end for
+         double dTime = Timer.nsecsElapsed() / (1.0e6 * nFrames);
+
+         const DBlobs& Blobs = m_pBlobFinder->GetBlobs();
+         size_t nBlobs = 0;
+         for (size_t i = 1 ; i < Blobs.size() ; i++)
+            {
+            nBlobs += Blobs[i].size();
+            } // end for
+
+         strMsg += tr("\n%1: %2 ms, %3 blobs").arg(pNames[nTest])
+               .arg(dTime, 0, 'f', 2).arg(nBlobs);
+         } // end for
+      }
+
+   QMessageBox::information(this, tr("Benchmark YUYV and NV12"), strMsg);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::BenchmarkYCbCr
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::PipelineStatistics
+*
+* Show each pipeline stage's frames, how often it had to wait for one and
+* how much of the time it was busy, then start counting again.  The
+* busiest stage sets the frame rate.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::PipelineStatistics()
+   {
+   static const char* pStageNames[] = { "Categorize", "Label", "Render" };
+
+   QString strMsg = tr("Dropped frames: %1\n")
+         .arg(m_pPipeline->GetDroppedFrames());
+   for (int nStage = 0 ; nStage < m_pPipeline->GetStageCount() ; nStage++)
+      {
+      DBlobPipeline::DStageStats Stats = m_pPipeline->GetStageStats(nStage);
+      strMsg += tr("\n%1: %2 frames, %3 stalls, %4 queued, %5% busy")
+            .arg(pStageNames[nStage]).arg(Stats.nProcessed)
+            .arg(Stats.nStalls).arg(Stats.nQueued)
+            .arg(100.0 * Stats.dOccupancy, 0, 'f', 1);
+      } // end for
+   m_pPipeline->ResetStats();
+
+   QMessageBox::information(this, tr("Pipeline Statistics"), strMsg);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::PipelineStatistics
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::SetColorScheme
+ *
+ ****************************************************************************/
+
+void DBlobTrackerMainWindow::SetColorScheme(int nColorScheme)
+   {
+   DBlobPipeline::DPause Pause(*m_pPipeline);
+
+   m_Params.SetColorSet(nColorScheme);
+
+   // The colors may mean something else now
+   m_Tracks.Clear();
+
+   if (nColorScheme == DBlobTracker::eRGB)
+      {
+      delete m_pBlobFinder;
+      m_pBlobFinder = new DColorBlobFinder(&m_Params.GetColors());
+
+      m_HistogramWidgets[0]->SetLineColor(qRgb(255, 0, 0));
+      m_HistogramWidgets[1]->SetLineColor(qRgb(0, 255, 0));
+      m_HistogramWidgets[2]->SetLineColor(qRgb(0, 0, 255));
+      } // end if
+   else if (nColorScheme == DBlobTracker::eHSV)
+      {
+      delete m_pBlobFinder;
+      m_pBlobFinder = new DColorBlobFinderHSV(&m_Params.GetColors());
+
+      m_HistogramWidgets[0]->SetLineColor(qRgb(255, 0, 255));
+      m_HistogramWidgets[1]->SetLineColor(qRgb(0, 255, 255));
+      m_HistogramWidgets[2]->SetLineColor(qRgb(0, 0, 0));
+      } // end else if
+   else if (nColorScheme == DBlobTracker::eHSL)
+      {
+      delete m_pBlobFinder;
+      m_pBlobFinder = new DColorBlobFinderHSL(&m_Params.GetColors());
+
+      m_HistogramWidgets[0]->SetLineColor(qRgb(255, 0, 255));
+      m_HistogramWidgets[1]->SetLineColor(qRgb(0, 255, 255));
+      m_HistogramWidgets[2]->SetLineColor(qRgb(0, 0, 0));
+      } // end else if
+   else if (nColorScheme == DBlobTracker::eYCbCr)
+      {
+      delete m_pBlobFinder;
+      m_pBlobFinder = new DColorBlobFinderYCbCr(&m_Params.GetColors());
+
+      m_HistogramWidgets[0]->SetLineColor(qRgb(0, 0, 0));
+      m_HistogramWidgets[1]->SetLineColor(qRgb(0, 0, 255));
+      m_HistogramWidgets[2]->SetLineColor(qRgb(255, 0, 0));
+      } // end else if
+
+   m_pBlobFinder->SetClassifier(m_eClassifier);
+   m_pBlobFinder->SetThreadCount(m_nThreads);
+   m_pBlobFinder->SetStoreRuns(!m_bStatisticsOnly);
+   m_pBlobFinder->SetIncremental(m_bIncremental);
+   m_pBlobFinder->SetValidateIncremental(m_bValidateIncremental);
+   UpdateLargestCounts();
+
+   QStringList Names = m_ColorComponentNames[nColorScheme];
+   m_HistogramLabels[0]->setText(Names[0]);
+   m_HistogramLabels[1]->setText(Names[1]);
+   m_HistogramLabels[2]->setText(Names[2]);
+
+   m_pColorTableEditor->SetColorScheme(
+         static_cast<DBlobTracker::EColorScheme>(m_Params.GetColorSet()),
+         m_ColorSchemeNames[nColorScheme],
+         m_ColorComponentNames[nColorScheme]);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::SetColorScheme
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::CameraStarted
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::CameraStarted()
+   {
+   // Get what's currently in the color table
+   if (ExtractColorTable())
+      {
+      // Prohibit editing the color table while running
+      m_pColorTableEditor->setEnabled(false);
+
+      Base::CameraStarted();
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::CameraStarted
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::CameraStopped
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::CameraStopped()
+   {
+   Base::CameraStopped();
+\
+   // Let them edit away
+   m_pColorTableEditor->setEnabled(true);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::CameraStopped
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::ExtractColorTable
+*
+* Extract the data from the Color Table Editor Widget and store them in the
+* Blob parameters object for processing.
+*
+******************************************************************************/
+
+bool DBlobTrackerMainWindow::ExtractColorTable()
+   {
+   bool bRet = true;
+
+   // Just recreate the table, it's easier.  It's built on the side since
+   // the pipeline may be using the current one.
+   DBlobColor::Vector Colors;
+
+   DColorRangeTableWidget* pTable = m_pColorTableEditor->GetColorTable();
+
+   // Not currently using
+   QString strBlobName;
+
+   for (int r = DColorRangeTableWidget::eBackgroundRow ; bRet && (r < pTable->rowCount()) ; r++)
+      {
+      int nValues[6];
+      int nVal = 0;
+      bool bCircular = false;
+//      strBlobName = m_pColorGrid->GetRowLabelValue(r);
+
+      for (int c = DColorRangeTableWidget::eMin1 ;
+            bRet && (c <= DColorRangeTableWidget::eMax3) ; c++)
+         {
+         QTableWidgetItem* pItem = pTable->item(r, c);
+         if (pItem != nullptr)
+            {
+            if (c == DColorRangeTableWidget::eCirc1)
+               {
+               bCircular = (pItem->checkState() == Qt::Checked);
+               } // end if
+            else
+               {
+               nValues[nVal++] = pItem->text().toInt(&bRet);
+               } // end else
+            } // end if
+         else
+            {
+            bRet = false;
+            } // end else
+         } // end for
+
+      QTableWidgetItem* pColor = pTable->item(r, DColorRangeTableWidget::eDispColor);
+      QColor DisplayColor;
+      if (pColor != nullptr)
+         {
+         DisplayColor = pColor->backgroundColor();
+         } // end if
+
+      if (bRet)
+         {
+         if (bCircular && (nValues[0] < nValues[1]))
+            {
+            std::swap(nValues[0], nValues[1]);
+            } // end if
+
+         DBlob::DBlobColorRange::RangeTest Test1(nValues[0], nValues[1],
+               bCircular);
+         DBlob::DBlobColorRange::RangeTest Test2(nValues[2], nValues[3]);
+         DBlob::DBlobColorRange::RangeTest Test3(nValues[4], nValues[5]);
+
+         DBlob::DBlobColorRange ColorRange(Test1, Test2, Test3);
+
+         Colors.push_back(DBlobColor(strBlobName.toStdString(),
+               ColorRange, DCVRGB(DisplayColor)));
+         } // end if
+      } // end for
+
+      {
+      DBlobPipeline::DPause Pause(*m_pPipeline);
+      m_Params.GetColors().swap(Colors);
+      }
+
+   if (!bRet)
+      {
+      QMessageBox::critical(this, tr("Error"), tr("Failure to extract color table"), QMessageBox::Ok);
+      } // end if
+
+   return (bRet);
+
+   } // end of method DBlobTrackerMainWindow::ExtractColorTable
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::LoadColorTable
+*
+* Transfer a set of blob colors to the ColorRangeTableWidget for display and
+* editing.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::LoadColorTable()
+   {
+   DColorRangeTableWidget* pTable = m_pColorTableEditor->GetColorTable();
+   pTable->LoadColorTable(m_Params.GetColors());
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::LoadColorTable
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::ReprocessImage
+*
+* Handle reprocessing the last image.  Only applicable when the camera is
+* stopped.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::ReprocessImage()
+   {
+   // Extract the color table in case the user modified it
+   if (ExtractColorTable())
+      {
+      Base::ReprocessImage();
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::ReprocessImage
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::SaveParameters()
+*
+* Save the program parameters.  In this case, the Blob Color Table.
+*
+******************************************************************************/
+
+bool DBlobTrackerMainWindow::SaveParameters()
+   {
+
+   return (SaveBlobFile(GetParameterPath("xml").toStdString()));
+
+   } // end of method DBlobTrackerMainWindow::SaveParameters
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::LoadParameters()
+*
+* Load the program parameters.  In this case, the Blob Color Table.
+*
+******************************************************************************/
+
+bool DBlobTrackerMainWindow::LoadParameters()
+   {
+
+   return (m_Params.Read(GetParameterPath("xml").toStdString()));
+
+   } // end of method DBlobTrackerMainWindow::LoadParameters()
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::OnSaveBlobFile
+*
+* Handle the menu item for saving the Blob Color Table to file.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::OnSaveBlobFile()
+   {
+   QString strFileName = QFileDialog::getSaveFileName(this,
+         tr("Save Blob File As"), QDir::currentPath(),
+         tr("Blob files (*.xml)"));
+   if (!strFileName.isEmpty())
+      {
+      SaveBlobFile(strFileName.toStdString());
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::OnSaveBlobFile
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::OnLoadBlobFile
+*
+* Handle the menu item for loading the Blob Color Table from file.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::OnLoadBlobFile()
+   {
+   QString strFileName = QFileDialog::getOpenFileName(this,
+         tr("Load Blob files (*.xml)"));
+
+   if (!strFileName.isEmpty())
+      {
+      if (!LoadBlobFile(strFileName.toStdString()))
+         {
+         QString strMsg(tr("Failed to load blob file "));
+         strMsg += strFileName;
+         QMessageBox::warning(this, tr("Load Blob File"), strMsg);
+         } // end if
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::OnSaveLoadFile
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::SaveBlobFile
+*
+* Handle the mechanics of actually saving the Blob Color Table to file.
+*
+******************************************************************************/
+
+bool DBlobTrackerMainWindow::SaveBlobFile(const std::string& strPath)
+   {
+   bool bRet = ExtractColorTable();
+
+   if (bRet)
+      {
+      bRet = m_Params.Write(strPath);
+      } // end if
+
+   return (bRet);
+
+   } // end of method DBlobTrackerMainWindow::SaveBlobFile
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::LoadBlobFile
+*
+* Handle the mechanics of actually loading the Blob Color Table from file.
+*
+******************************************************************************/
+
+bool DBlobTrackerMainWindow::LoadBlobFile(const std::string& strPath)
+   {
+   bool bRet;
+      {
+      DBlobPipeline::DPause Pause(*m_pPipeline);
+      bRet = m_Params.Read(strPath);
+      }
+
+   if (bRet)
+      {
+      LoadColorTable();
+      ReprocessImage();
+      } // end if
+
+   return (bRet);
+
+   } // end of method DBlobTrackerMainWindow::LoadBlobFile
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::ProcessImage
+ *
+ *  Show the frame and hand it to the pipeline.  The blobs come back
+ *  through ShowResult.
+ *
+ ****************************************************************************/
+
+void DBlobTrackerMainWindow::ProcessImage(DCVImage& Image)
+   {
+   // Written once by the capture and read in place from here on
+   DCVImage Frame = m_FramePool.Publish(Image);
+   m_CapturedImage = Frame;
+
+   // Display the input image or camera capture in the input widget
+   DQImage InputImage = WrapFrame(Frame);
+   InputImage.SetROI(m_pInputImageWidget->GetImage().GetROI());
+   m_pInputImageWidget->SetImage(InputImage);
+
+   // The region of interest in image coordinates, empty if there isn't one
+   cv::Rect rcROI;
+   if (m_bFindInROI)
+      {
+      QRect rcInputROI = m_pInputImageWidget->GetImage().GetROI();
+      if (!rcInputROI.isEmpty())
+         {
+         rcROI = cv::Rect(rcInputROI.x(), rcInputROI.y(), rcInputROI.width(),
+               rcInputROI.height());
+         } // end if
+      } // end if
+
+   // Numbered even if it's dropped so the tracks know how far to predict
+   qint64 nFrame = ++m_nFrameCount;
+   int nSlot = m_pPipeline->AcquireSlot();
+   if (nSlot != -1)
+      {
+      DFrameSlot& Slot = m_Slots[nSlot];
+      Slot.Image = Frame;
+      Slot.rcROI = rcROI;
+      Slot.nFrame = nFrame;
+      m_pPipeline->Submit(nSlot);
+      } // end if
+   UpdatePipelineStatus();
+
+   UpdateHistograms();
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::ProcessImage
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::WrapFrame
+ *
+ *  A QImage reading the frame's pixels in place.  It holds a header of its
+ *  own on the frame, let go when Qt is done with the pixels, and since it's
+ *  made from const data anything that changes it gets a copy first.  Qt
+ *  only reads BGR from 5.14 on; before that, and for other pixel types,
+ *  the frame is converted.
+ *
+ ****************************************************************************/
+
+QImage DBlobTrackerMainWindow::WrapFrame(const DCVImage& Frame)
+   {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+   if (Frame.type() == CV_8UC3)
+      {
+      return (QImage(static_cast<const uchar*>(Frame.data), Frame.cols, Frame.rows,
+            static_cast<int>(Frame.step), QImage::Format_BGR888,
+            [](void* pFrame) { delete static_cast<DCVImage*>(pFrame); },
+            new DCVImage(Frame)));
+      } // end if
+#endif
+
+   DCVImage Convert = Frame;
+
+   return (cvMatToQImage(Convert));
+
+   } // end of method DBlobTrackerMainWindow::WrapFrame
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::CategorizeStage
+ *
+ *  First stage of the pipeline.  Categorize the frame's pixels and find
+ *  its runs, searching only where the tracks say the blobs will be when
+ *  that's on.  The tracks may be a few frames behind, since the frames
+ *  between are still in the later stages, so they're predicted that much
+ *  further ahead.
+ *
+ ****************************************************************************/
+
+void DBlobTrackerMainWindow::CategorizeStage(int nSlot)
+   {
+   DFrameSlot& Slot = m_Slots[nSlot];
+
+   QElapsedTimer Timer;
+   Timer.start();
+
+   Slot.bFullScan = true;
+   if (m_bPredictiveSearch)
+      {
+      std::lock_guard<std::mutex> Lock(m_TrackMutex);
+      int nFramesAhead = static_cast<int>(Slot.nFrame - m_nTrackedFrame);
+      Slot.bFullScan = m_Tracks.IsFullScanDue(nFramesAhead);
+      if (!Slot.bFullScan)
+         {
+         m_Tracks.GetSearchWindows(m_SearchWindows, nFramesAhead);
+         } // end if
+      } // end if
+
+   const std::vector<cv::Rect>* pWindows = nullptr;
+   if (!Slot.bFullScan)
+      {
+      if (Slot.rcROI.area() > 0)
+         {
+         for (auto& rcWindow : m_SearchWindows)
+            {
+            rcWindow &= Slot.rcROI;
+            } // end for
+         } // end if
+      pWindows = &m_SearchWindows;
+      } // end if
+   else if (Slot.rcROI.area() > 0)
+      {
+      m_SearchWindows.assign(1, Slot.rcROI);
+      pWindows = &m_SearchWindows;
+      } // end else if
+
+   m_pBlobFinder->FindFrameRuns(&Slot.Image, Slot.Runs, pWindows);
+   Slot.nElapsed = Timer.elapsed();
+
+   Slot.nValidationErrors = m_bValidateIncremental
+         ? m_pBlobFinder->GetValidationErrors() : 0;
+
+// Uncomment to debug the categorized image
+//   m_bDisplayCategories = true;
+   if (m_bDisplayCategories)
+      {
+      // Only this stage has the categories, so they're drawn here
+      Slot.OutputImage = DQImage(320, 240, QImage::Format_RGB32);
+      DQIBlobRenderer Renderer;
+      Renderer.SetImage(&Slot.OutputImage);
+      m_pBlobFinder->DisplayCategories(&Renderer);
+      Renderer.End();
+      } // end if
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::CategorizeStage
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::LabelStage
+ *
+ *  Second stage of the pipeline.  Join the frame's runs into blobs, which
+ *  the slot keeps, and follow them from the last frame.
+ *
+ ****************************************************************************/
+
+void DBlobTrackerMainWindow::LabelStage(int nSlot)
+   {
+   DFrameSlot& Slot = m_Slots[nSlot];
+
+   QElapsedTimer Timer;
+   Timer.start();
+   m_pBlobFinder->LabelFrameRuns(Slot.Runs);
+   m_pBlobFinder->SwapBlobs(Slot.Blobs);
+   Slot.nElapsed += Timer.elapsed();
+
+   std::lock_guard<std::mutex> Lock(m_TrackMutex);
+   m_Tracks.Update(Slot.Blobs, Slot.bFullScan);
+   m_nTrackedFrame = Slot.nFrame;
+   Slot.nTracks = static_cast<int>(m_Tracks.GetTracks().size());
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::LabelStage
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::RenderStage
+ *
+ *  Last stage of the pipeline.  Draw the frame's blobs for ShowResult.
+ *
+ ****************************************************************************/
+
+void DBlobTrackerMainWindow::RenderStage(int nSlot)
+   {
+   DFrameSlot& Slot = m_Slots[nSlot];
+   RenderOutput(Slot.Blobs, Slot.OutputImage, Slot.strBlobCount);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::RenderStage
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::ShowResult
+ *
+ *  The pipeline finished one or more frames.  Show the newest and hand
+ *  the slots back.
+ *
+ ****************************************************************************/
+
+void DBlobTrackerMainWindow::ShowResult()
+   {
+   int nShow = -1;
+   int nSlot;
+   while ((nSlot = m_pPipeline->TakeResult()) != -1)
+      {
+      if (nShow != -1)
+         {
+         m_pPipeline->ReleaseSlot(nShow);
+         } // end if
+      nShow = nSlot;
+      } // end while
+
+   if (nShow != -1)
+      {
+      DFrameSlot& Slot = m_Slots[nShow];
+      m_pOutputImageWidget->SetImage(Slot.OutputImage);
+      m_pBlobCount->setText(Slot.strBlobCount);
+      m_pProcessTime->setText(QString().setNum(Slot.nElapsed));
+      m_pTrackCount->setText(QString().setNum(Slot.nTracks));
+
+      if (Slot.nValidationErrors > 0)
+         {
+         statusBar()->showMessage(tr("Incremental update wrong in %1 rows")
+               .arg(Slot.nValidationErrors));
+         } // end if
+
+      // Kept for drawing again.  The slot gets the old blobs, which the
+      // label stage clears out.
+      m_ShownBlobs.swap(Slot.Blobs);
+      // Done with the frame, so its buffer can go back to the pool
+      Slot.Image.release();
+      m_pPipeline->ReleaseSlot(nShow);
+      } // end if
+
+   UpdatePipelineStatus();
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::ShowResult
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::UpdatePipelineStatus
+ *
+ *  Show how many frames the pipeline has had to drop and how many are
+ *  waiting in it.
+ *
+ ****************************************************************************/
+
+void DBlobTrackerMainWindow::UpdatePipelineStatus()
+   {
+   m_pDroppedFrames->setText(QString().setNum(m_pPipeline->GetDroppedFrames()));
+   m_pQueueDepth->setText(QString().setNum(m_pPipeline->GetQueuedFrames()));
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::UpdatePipelineStatus
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::DisplayOutput
+*
+* Draw the blobs shown again, for when the display settings change with
+* the camera stopped.  The settings are only changed on this thread so the
+* pipeline can carry on.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::DisplayOutput()
+   {
+   DQImage OutputImage;
+   QString strBlobCount;
+   RenderOutput(m_ShownBlobs, OutputImage, strBlobCount);
+
+   m_pOutputImageWidget->SetImage(OutputImage);
+   m_pBlobCount->setText(strBlobCount);
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::DisplayOutput
+
+/******************************************************************************
+*
+***  DBlobTrackerMainWindow::RenderOutput
+*
+* Draw the blobs and count them by color.  Only paints on a QImage so it's
+* safe on the render stage's thread.  The categories, when they're shown,
+* were drawn by the categorize stage.
+*
+******************************************************************************/
+
+void DBlobTrackerMainWindow::RenderOutput(const DBlobs& Blobs,
+      DQImage& OutputImage, QString& strBlobCount) const
+   {
+   const DBlobColor::Vector& Colors = m_Params.GetColors();
+
+   if (!m_bDisplayCategories)
+      {
+      OutputImage = DQImage(320, 240, QImage::Format_RGB32);
+      DQIBlobRenderer Renderer;
+
+      // Render directly to the QImage for display
+      Renderer.SetImage(&OutputImage);
+
+      if (!Colors.empty())
+         {
+         Renderer.ClearBackground(Colors[0].GetDisplayColor());
+         } // end if
+
+      // Blobs kept from before the color table changed can't be drawn with
+      // the new one
+      if (Blobs.size() <= Colors.size())
+         {
+         if (m_bDisplayLargest)
+            {
+            Blobs.DisplayLargestBlobs(&Renderer, Colors, m_nBlobDisplay,
+                  DCVRGB(255, 255, 255), 2);
+            } // end if
+         else
+            {
+            Blobs.DisplayBlobs(&Renderer, Colors, m_nBlobDisplay,
+                  DCVRGB(255, 255, 255), 2);
+            } // end else
+         } // end if
+
+      Renderer.End();
+      } // end if
+
+   // Handle the status bar process message
+//   int nBlobs = Blobs.size();
+
+   if (Blobs.size() < 2)
+     {
+      // Only background blob found. (Zero would be an error)
+     strBlobCount = "0";
+      } // end if
+   else
+      {
+      // Build a string showing the number of blobs in each category
+      strBlobCount.setNum(Blobs[1].size());
+
+      for (size_t i = 2 ; i < Blobs.size() ; i++)
+         {
+         QString strBlob;
+         strBlobCount += ", ";
+         strBlob.setNum(Blobs[i].size());
+         strBlobCount += strBlob;
+         } // end for
+      } // end else
+
+   return;
+
+   } // end of method DBlobTrackerMainWindow::RenderOutput
+
+/*****************************************************************************
+ *
+ ***  DBlobTrackerMainWindow::UpdateHistograms
+ *
+ ****************************************************************************/
+
+void DBlobTrackerMainWindow::UpdateHistograms()
+   {
+   DQImage& Image = m_pInputImageWidget->GetImage();
+
+   if (m_Params.GetColorSet() == DBlobTracker::eRGB)
+      {
+      Image.RedChannel().CalcHistogram(m_HistogramWidgets[0]->GetHistogram());
+      Image.GreenChannel().CalcHistogram(m_HistogramWidgets[1]->GetHistogram());
+      Image.BlueChannel().CalcHistogram(m_HistogramWidgets[2]->GetHistogram());
+
+      m_pColorTableEditor->GetColorTable()->hideColumn(2);
+      } // end if
+   else if (m_Params.GetColorSet() == DBlobTracker::eHSV)
+      {
+      Image.HSVHue8Channel().CalcHistogram(m_HistogramWidgets[0]->GetHistogram());
+      Image.HSVSaturationChannel().CalcHistogram(m_HistogramWidgets[1]->GetHistogram());
+      Image.HSVValueChannel().CalcHistogram(m_HistogramWidgets[2]->GetHistogram());
+
+      m_pColorTableEditor->GetColorTable()->showColumn(2);
+      } // end else if
+   else if (m_Params.GetColorSet() == DBlobTracker::eHSL)
+      {
+      Image.HSLHue8Channel().CalcHistogram(m_HistogramWidgets[0]->GetHistogram());
+      Image.HSLSaturationChannel().CalcHistogram(m_HistogramWidgets[1]->GetHistogram());
+      Image.HSLLightnessChannel().CalcHistogram(m_HistogramWidgets[2]->GetHistogram());
+
+      m_pColorTableEditor->GetColorTable()->showColumn(2);
+      } // end else if
+   else if (m_Params.GetColorSet() == DBlobTracker::eYCbCr)
+      {
+      // The image has no YCbCr channels to take histograms of, and there's
+      // no hue to wrap
+      m_pColorTableEditor->GetColorTable()->hideColumn(2);
+      } // end else if
+
+   update();
+
+   return;
+
+      } // end of method DBlobTrackerMainWindow::UpdateHistograms
@@ -1,167 +1,249 @@
-/*
- * DBlobTrackerMainWindow.h
- *
- *  Created on: May 25, 2014
- *      Author: Tim
- */
-
-#ifndef DBLOBTRACKERMAINWINDOW_H_
-#define DBLOBTRACKERMAINWINDOW_H_
-
-/*****************************************************************************
-******************************  I N C L U D E  ******************************
-****************************************************************************/
-
-#include "DCVCameraMainWindow.h"
-#include "DBlobs.h"
-#include "DQHistogramWidget.h"
-#include "DColorRangeTableWidget.h"
-#include "DBlobTracker.h"
-
-#include <QAction>
-#include <QLabel>
-#include <QElapsedTimer>
-
-/*****************************************************************************
-***************************** class DBlobParams ******************************
-*****************************************************************************/
-
-class DBlobParams
-   {
-   public :
-      static const unsigned int m_nVersion = 0;
-
-      DBlobParams() : m_nColorSet{0}
-         {
-         return;
-         }
-
-      DBlobParams(const DBlobParams& src) = delete;
-
-      ~DBlobParams() = default;
-
-      DBlobParams& operator=(const DBlobParams& rhs) = delete;
-
-      int GetColorSet() const
-         {
-         return (m_nColorSet);
-         }
-
-      void SetColorSet(int nColorSet)
-         {
-         m_nColorSet = nColorSet;
-
-         return;
-         }
-
-      DBlobColor::Vector& GetColors()
-         {
-         return (m_Colors);
-         }
-
-      bool Read(const std::string& strPath);
-      bool Write(const std::string& strPath) const;
-
-      template<class Archive>
-      void serialize(Archive & ar, const unsigned int /* nVersion */)
-         {
-         ar & boost::serialization::make_nvp("ColorSet", m_nColorSet);
-         ar & boost::serialization::make_nvp("Colors", m_Colors);
-
-         return;
-         }
-
-   protected :
-      int m_nColorSet;
-      DBlobColor::Vector m_Colors;
-
-   private :
-
-   };  // end of class DBlobParams
-
-BOOST_CLASS_VERSION(DBlobParams, DBlobParams::m_nVersion)
-
-/*****************************************************************************
-*
-***  class DBlobTrackerMainWindow
-*
-*****************************************************************************/
-
-class DBlobTrackerMainWindow : public DCVCameraMainWindow
-   {
-   Q_OBJECT
-
-   using Base = DCVCameraMainWindow;
-
-   public:
-       explicit DBlobTrackerMainWindow(QWidget* pParent  = nullptr);
-
-      DBlobTrackerMainWindow(const DBlobTrackerMainWindow& src) = delete;
-
-      ~DBlobTrackerMainWindow() = default;
-
-      DBlobTrackerMainWindow& operator=(const DBlobTrackerMainWindow& rhs) = delete;
-
-      virtual void Initialize(Qt::Orientation eOrientation = Qt::Vertical);
-
-   protected:
-      DColorBlobFinder* m_pBlobFinder;
-      DColorRangeTableEditor* m_pColorTableEditor;
-      mutable DBlobParams m_Params;
-      bool m_bDisplayCategories;
-      bool m_bDisplayLargest;
-      bool m_bShowBoundingBox;
-      bool m_bShowCrossHairs;
-      int m_nBlobDisplay;
-      QLabel* m_pBlobCount;
-      QLabel* m_pProcessTime;
-      QElapsedTimer m_Timer;
-
-      QAction* m_pActionSaveBlobFile;
-      QAction* m_pActionLoadBlobFile;
-
-      QVector<DQHistogramWidget*> m_HistogramWidgets;
-      QVector<QLabel*> m_HistogramLabels;
-      QVector<QStringList> m_ColorComponentNames;
-      QStringList m_ColorSchemeNames;
-
-      virtual void SetupCentralWidget();
-      virtual void SetupStatusBar();
-      virtual void ProcessImage(DCVImage& Image);
-      virtual void DisplayOutput();
-      virtual QMenu* AddBlobMenu();
-      virtual void CreateHistogramWidgets();
-      virtual void SetColorScheme(int nColorScheme);
-      virtual void CreateColorTable();
-      virtual void SetupColorStrings();
-      virtual void CameraStarted();
-      virtual void CameraStopped();
-      bool ExtractColorTable();
-      void LoadColorTable();
-
-      bool SaveBlobFile(const std::string& strPath);
-      bool LoadBlobFile(const std::string& strPath);
-
-   protected slots:
-      virtual void UpdateHistograms();
-      virtual void ChangeColorScheme(QAction* pAction);
-      virtual void DisplayLargestAction(bool bChecked);
-      virtual void ShowBoundingBoxAction(bool bChecked);
-      virtual void ShowCrossHairsAction(bool bChecked);
-      virtual void ReprocessImage();
-
-      virtual void OnSaveBlobFile();
-      virtual void OnLoadBlobFile();
-
-      virtual bool LoadParameters() override;
-      virtual bool SaveParameters() override;
-
-      virtual void UpdateFileActions();
-
-   private:
-
-   }; // end of class DBlobTrackerMainWindow
-
-
-
-#endif /* DBLOBTRACKERMAINWINDOW_H_ */
+/*
+ * DBlobTrackerMainWindow.h
+ *
+ *  Created on: May 25, 2014
+ *      Author: Tim
+ */
+
+#ifndef DBLOBTRACKERMAINWINDOW_H_
+#define DBLOBTRACKERMAINWINDOW_H_
+
+/*****************************************************************************
+******************************  I N C L U D E  ******************************
+****************************************************************************/
+
+#include "DCVCameraMainWindow.h"
+#include "DBlobs.h"
+#include "DBlobTracks.h"
+#include "DBlobPipeline.h"
+#include "DFramePool.h"
+#include "DQHistogramWidget.h"
+#include "DColorRangeTableWidget.h"
+#include "DBlobTracker.h"
+
+#include <QAction>
+#include <QLabel>
+#include <QElapsedTimer>
+
+#include <memory>
+#include <mutex>
+
+/*****************************************************************************
+***************************** class DBlobParams ******************************
+*****************************************************************************/
+
+class DBlobParams
+   {
+   public :
+      static const unsigned int m_nVersion = 0;
+
+      DBlobParams() : m_nColorSet{0}
+         {
+         return;
+         }
+
+      DBlobParams(const DBlobParams& src) = delete;
+
+      ~DBlobParams() = default;
+
+      DBlobParams& operator=(const DBlobParams& rhs) = delete;
+
+      int GetColorSet() const
+         {
+         return (m_nColorSet);
+         }
+
+      void SetColorSet(int nColorSet)
+         {
+         m_nColorSet = nColorSet;
+
+         return;
+         }
+
+      DBlobColor::Vector& GetColors()
+         {
+         return (m_Colors);
+         }
+
+      bool Read(const std::string& strPath);
+      bool Write(const std::string& strPath) const;
+
+      template<class Archive>
+      void serialize(Archive & ar, const unsigned int /* nVersion */)
+         {
+         ar & boost::serialization::make_nvp("ColorSet", m_nColorSet);
+         ar & boost::serialization::make_nvp("Colors", m_Colors);
+
+         return;
+         }
+
+   protected :
+      int m_nColorSet;
+      DBlobColor::Vector m_Colors;
+
+   private :
+
+   };  // end of class DBlobParams
+
+BOOST_CLASS_VERSION(DBlobParams, DBlobParams::m_nVersion)
+
+/*****************************************************************************
+*
+***  class DBlobTrackerMainWindow
+*
+*****************************************************************************/
+
+class DBlobTrackerMainWindow : public DCVCameraMainWindow
+   {
+   Q_OBJECT
+
+   using Base = DCVCameraMainWindow;
+
+   public:
+       explicit DBlobTrackerMainWindow(QWidget* pParent  = nullptr);
+
+      DBlobTrackerMainWindow(const DBlobTrackerMainWindow& src) = delete;
+
+      ~DBlobTrackerMainWindow() = default;
+
+      DBlobTrackerMainWindow& operator=(const DBlobTrackerMainWindow& rhs) = delete;
+
+      virtual void Initialize(Qt::Orientation eOrientation = Qt::Vertical);
+
+   protected:
+      DColorBlobFinder* m_pBlobFinder;
+      DColorRangeTableEditor* m_pColorTableEditor;
+      mutable DBlobParams m_Params;
+      bool m_bDisplayCategories;
+      bool m_bDisplayLargest;
+      bool m_bShowBoundingBox;
+      bool m_bShowCrossHairs;
+      int m_nBlobDisplay;
+      DColorBlobFinder::EClassifier m_eClassifier;
+      int m_nThreads;
+      bool m_bStatisticsOnly;
+      // Blobs followed from frame to frame
+      DBlobTracks m_Tracks;
+      // Search only around the tracked blobs between full frame scans
+      bool m_bPredictiveSearch;
+      // Windows being searched, only used by the categorize stage
+      std::vector<cv::Rect> m_SearchWindows;
+      // Search only the input image's region of interest
+      bool m_bFindInROI;
+      // Only recategorize the parts of the image that changed
+      bool m_bIncremental;
+      bool m_bValidateIncremental;
+      QLabel* m_pBlobCount;
+      QLabel* m_pTrackCount;
+      QLabel* m_pProcessTime;
+      QLabel* m_pDroppedFrames;
+      QLabel* m_pQueueDepth;
+
+      // Buffers the frames are captured into, read in place by the input
+      // widget, the pipeline slots and m_CapturedImage
+      DFramePool m_FramePool;
+
+      // One frame on its way through the pipeline.  Each stage fills in its
+      // own part.
+      struct DFrameSlot
+         {
+         // Capture.  Shares the frame's pixels with the frame pool.
+         DCVImage Image;
+         cv::Rect rcROI;
+         qint64 nFrame;
+         // Categorize
+         DColorBlobFinder::DFrameRuns Runs;
+         bool bFullScan;
+         int nValidationErrors;
+         // Categorize and label
+         qint64 nElapsed;
+         // Label
+         DBlobs Blobs;
+         int nTracks;
+         // Render
+         DQImage OutputImage;
+         QString strBlobCount;
+         };
+
+      std::vector<DFrameSlot> m_Slots;
+      // Frames captured so far, which numbers them
+      qint64 m_nFrameCount;
+      // The tracks are updated by the label stage and predicted from by the
+      // categorize stage, under this lock.  m_nTrackedFrame is the last
+      // frame they were updated with.
+      std::mutex m_TrackMutex;
+      qint64 m_nTrackedFrame;
+      // Blobs of the frame being shown, for drawing them again
+      DBlobs m_ShownBlobs;
+
+      QAction* m_pActionSaveBlobFile;
+      QAction* m_pActionLoadBlobFile;
+
+      QVector<DQHistogramWidget*> m_HistogramWidgets;
+      QVector<QLabel*> m_HistogramLabels;
+      QVector<QStringList> m_ColorComponentNames;
+      QStringList m_ColorSchemeNames;
+
+      virtual void SetupCentralWidget();
+      virtual void SetupStatusBar();
+      virtual void ProcessImage(DCVImage& Image);
+      static QImage WrapFrame(const DCVImage& Frame);
+      virtual void DisplayOutput();
+      void CategorizeStage(int nSlot);
+      void LabelStage(int nSlot);
+      void RenderStage(int nSlot);
+      void RenderOutput(const DBlobs& Blobs, DQImage& OutputImage,
+            QString& strBlobCount) const;
+      void UpdatePipelineStatus();
+      virtual QMenu* AddBlobMenu();
+      virtual void CreateHistogramWidgets();
+      virtual void SetColorScheme(int nColorScheme);
+      virtual void CreateColorTable();
+      virtual void SetupColorStrings();
+      virtual void CameraStarted();
+      virtual void CameraStopped();
+      void UpdateLargestCounts();
+      bool ExtractColorTable();
+      void LoadColorTable();
+
+      bool SaveBlobFile(const std::string& strPath);
+      bool LoadBlobFile(const std::string& strPath);
+
+   protected slots:
+      virtual void UpdateHistograms();
+      virtual void ChangeColorScheme(QAction* pAction);
+      virtual void ChangeClassifier(QAction* pAction);
+      virtual void ChangeThreadCount(QAction* pAction);
+      virtual void BenchmarkRunMatching();
+      virtual void BenchmarkThreadScaling();
+      virtual void BenchmarkYCbCr();
+      virtual void PipelineStatistics();
+      virtual void StatisticsOnlyAction(bool bChecked);
+      virtual void PredictiveSearchAction(bool bChecked);
+      virtual void FindInROIAction(bool bChecked);
+      virtual void IncrementalAction(bool bChecked);
+      virtual void ValidateIncrementalAction(bool bChecked);
+      virtual void InputROIChanged();
+      virtual void DisplayLargestAction(bool bChecked);
+      virtual void ShowBoundingBoxAction(bool bChecked);
+      virtual void ShowCrossHairsAction(bool bChecked);
+      virtual void ReprocessImage();
+      virtual void ShowResult();
+
+      virtual void OnSaveBlobFile();
+      virtual void OnLoadBlobFile();
+
+      virtual bool LoadParameters() override;
+      virtual bool SaveParameters() override;
+
+      virtual void UpdateFileActions();
+
+   private:
+      // Declared last so the stages stop before anything they use goes away
+      std::unique_ptr<DBlobPipeline> m_pPipeline;
+
+   }; // end of class DBlobTrackerMainWindow
+
+
+
+#endif /* DBLOBTRACKERMAINWINDOW_H_ */
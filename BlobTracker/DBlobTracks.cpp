@@ -0,0 +1,358 @@
+/*****************************************************************************
+ ****************************** DBlobTracks.cpp ******************************
+ *****************************************************************************/
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+#include "DBlobTracks.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*****************************************************************************
+ *
+ *  DBlobTracks::DBlobTracks
+ *
+ *****************************************************************************/
+
+DBlobTracks::DBlobTracks() :
+      m_nNextID(0),
+      m_dMaxDistance(32.0),
+      m_dMaxAreaRatio(2.0),
+      m_nMaxMissed(5),
+      m_dProcessNoise(1.0),
+      m_dMeasureNoise(1.0),
+      m_nRescanInterval(10),
+      m_nSearchPadding(8),
+      m_nSinceFullScan(0),
+      m_bTrackMissed(false),
+      m_nGridCols(0),
+      m_nGridRows(0)
+   {
+   return;
+
+   } // End of function DBlobTracks::DBlobTracks
+
+/*****************************************************************************
+ *
+ *  DBlobTracks::Clear
+ *
+ *****************************************************************************/
+
+void DBlobTracks::Clear()
+   {
+   m_Tracks.clear();
+   m_BlobTracks.clear();
+   m_nNextID = 0;
+   m_nSinceFullScan = 0;
+   m_bTrackMissed = false;
+
+   return;
+
+   } // End of function DBlobTracks::Clear
+
+/*****************************************************************************
+ *
+ *  DBlobTracks::Update
+ *
+ *  Pair the tracks with this frame's blobs, best matches first.  Ties go to
+ *  the older track and the lower blob so the result only depends on the
+ *  blobs.
+ *
+ *****************************************************************************/
+
+void DBlobTracks::Update(const DBlobs& Blobs, bool bFullScan /* = true */)
+   {
+   m_nSinceFullScan = bFullScan ? 0 : m_nSinceFullScan + 1;
+
+   // Move every track to where it should be in this frame
+   for (auto& Track : m_Tracks)
+      {
+      Track.m_X.Predict(m_dProcessNoise);
+      Track.m_Y.Predict(m_dProcessNoise);
+      } // end for
+
+   m_FrameBlobs.clear();
+   for (size_t nColor = 1 ; nColor < Blobs.size() ; nColor++)
+      {
+      for (const auto& Entry : Blobs[nColor])
+         {
+         m_FrameBlobs.push_back(&Entry.second);
+         } // end for
+      } // end for
+   m_FrameTracks.assign(m_FrameBlobs.size(), -1);
+
+   BuildGrid();
+   FindMatches();
+
+   std::sort(m_Matches.begin(), m_Matches.end(), [](const DMatch& Match1,
+         const DMatch& Match2)
+      {
+      return ((Match1.dCost < Match2.dCost) || ((Match1.dCost == Match2.dCost)
+            && ((Match1.nTrack < Match2.nTrack) || ((Match1.nTrack == Match2.nTrack)
+            && (Match1.nBlob < Match2.nBlob)))));
+      });
+
+   std::vector<bool> Matched(m_Tracks.size(), false);
+   for (const auto& Match : m_Matches)
+      {
+      if (!Matched[Match.nTrack] && (m_FrameTracks[Match.nBlob] == -1))
+         {
+         Matched[Match.nTrack] = true;
+         m_FrameTracks[Match.nBlob] = Match.nTrack;
+         } // end if
+      } // end for
+
+   // Bring the matched tracks up to the blobs
+   for (size_t nBlob = 0 ; nBlob < m_FrameBlobs.size() ; nBlob++)
+      {
+      int nTrack = m_FrameTracks[nBlob];
+      if (nTrack != -1)
+         {
+         const DBlob& Blob = *m_FrameBlobs[nBlob];
+         DBlobTrack& Track = m_Tracks[nTrack];
+         Track.m_X.Correct(Blob.GetCentroidX(), m_dMeasureNoise);
+         Track.m_Y.Correct(Blob.GetCentroidY(), m_dMeasureNoise);
+         Track.m_nArea = static_cast<int64_t>(Blob.GetArea());
+         Track.m_nWidth = Blob.GetBoundingRect().width;
+         Track.m_nHeight = Blob.GetBoundingRect().height;
+         Track.m_nBlobID = Blob.GetID();
+         Track.m_nMissed = 0;
+         Track.m_nAge++;
+         } // end if
+      } // end for
+
+   // The rest coast on the prediction
+   m_bTrackMissed = false;
+   for (size_t nTrack = 0 ; nTrack < m_Tracks.size() ; nTrack++)
+      {
+      if (!Matched[nTrack])
+         {
+         m_bTrackMissed = true;
+         DBlobTrack& Track = m_Tracks[nTrack];
+         Track.m_nBlobID = -1;
+         Track.m_nMissed++;
+         Track.m_nAge++;
+         } // end if
+      } // end for
+
+   int nMaxMissed = m_nMaxMissed;
+   m_Tracks.erase(std::remove_if(m_Tracks.begin(), m_Tracks.end(),
+         [nMaxMissed](const DBlobTrack& Track) { return (Track.m_nMissed > nMaxMissed); }),
+         m_Tracks.end());
+
+   // Blobs nobody claimed start new tracks
+   for (size_t nBlob = 0 ; nBlob < m_FrameBlobs.size() ; nBlob++)
+      {
+      if (m_FrameTracks[nBlob] == -1)
+         {
+         const DBlob& Blob = *m_FrameBlobs[nBlob];
+         DBlobTrack Track;
+         Track.m_nID = m_nNextID++;
+         Track.m_nColor = Blob.GetType();
+         Track.m_nAge = 1;
+         Track.m_nMissed = 0;
+         Track.m_nBlobID = Blob.GetID();
+         // Nothing is known of the velocity beyond the largest move allowed
+         double dVelocityVariance = m_dMaxDistance * m_dMaxDistance;
+         Track.m_X.Start(Blob.GetCentroidX(), m_dMeasureNoise, dVelocityVariance);
+         Track.m_Y.Start(Blob.GetCentroidY(), m_dMeasureNoise, dVelocityVariance);
+         Track.m_nArea = static_cast<int64_t>(Blob.GetArea());
+         Track.m_nWidth = Blob.GetBoundingRect().width;
+         Track.m_nHeight = Blob.GetBoundingRect().height;
+         m_Tracks.push_back(Track);
+         } // end if
+      } // end for
+
+   m_BlobTracks.clear();
+   for (size_t nTrack = 0 ; nTrack < m_Tracks.size() ; nTrack++)
+      {
+      int nBlobID = m_Tracks[nTrack].m_nBlobID;
+      if (nBlobID != -1)
+         {
+         if (nBlobID >= static_cast<int>(m_BlobTracks.size()))
+            {
+            m_BlobTracks.resize(nBlobID + 1, -1);
+            } // end if
+         m_BlobTracks[nBlobID] = static_cast<int>(nTrack);
+         } // end if
+      } // end for
+
+   return;
+
+   } // End of function DBlobTracks::Update
+
+/*****************************************************************************
+ *
+ *  DBlobTracks::BuildGrid
+ *
+ *  Bin the frame's blobs by centroid into cells m_dMaxDistance on a side.
+ *  The grid covers the blobs' centroids, counting sort style.
+ *
+ *****************************************************************************/
+
+void DBlobTracks::BuildGrid()
+   {
+   double dMaxX = 0.0;
+   double dMaxY = 0.0;
+   for (const DBlob* pBlob : m_FrameBlobs)
+      {
+      dMaxX = std::max(dMaxX, pBlob->GetCentroidX());
+      dMaxY = std::max(dMaxY, pBlob->GetCentroidY());
+      } // end for
+
+   m_nGridCols = static_cast<int>(dMaxX / m_dMaxDistance) + 1;
+   m_nGridRows = static_cast<int>(dMaxY / m_dMaxDistance) + 1;
+
+   std::vector<int> BlobCells(m_FrameBlobs.size());
+   m_FirstInCell.assign(m_nGridCols * m_nGridRows + 1, 0);
+   for (size_t nBlob = 0 ; nBlob < m_FrameBlobs.size() ; nBlob++)
+      {
+      const DBlob* pBlob = m_FrameBlobs[nBlob];
+      int nCol = static_cast<int>(std::max(pBlob->GetCentroidX(), 0.0) / m_dMaxDistance);
+      int nRow = static_cast<int>(std::max(pBlob->GetCentroidY(), 0.0) / m_dMaxDistance);
+      BlobCells[nBlob] = nRow * m_nGridCols + nCol;
+      m_FirstInCell[BlobCells[nBlob] + 1]++;
+      } // end for
+
+   for (size_t nCell = 1 ; nCell < m_FirstInCell.size() ; nCell++)
+      {
+      m_FirstInCell[nCell] += m_FirstInCell[nCell - 1];
+      } // end for
+
+   // Fill each cell in blob order
+   std::vector<int> Fill(m_FirstInCell.begin(), m_FirstInCell.end() - 1);
+   m_CellBlobs.resize(m_FrameBlobs.size());
+   for (size_t nBlob = 0 ; nBlob < m_FrameBlobs.size() ; nBlob++)
+      {
+      m_CellBlobs[Fill[BlobCells[nBlob]]++] = static_cast<int>(nBlob);
+      } // end for
+
+   return;
+
+   } // End of function DBlobTracks::BuildGrid
+
+/*****************************************************************************
+ *
+ *  DBlobTracks::FindMatches
+ *
+ *  List every track and blob of the same color close enough in position
+ *  and area.  Distance and area ratio each add up to one to the cost at
+ *  their limits.
+ *
+ *****************************************************************************/
+
+void DBlobTracks::FindMatches()
+   {
+   m_Matches.clear();
+
+   double dMaxDistance2 = m_dMaxDistance * m_dMaxDistance;
+   double dLogMaxRatio = std::log(m_dMaxAreaRatio);
+
+   for (size_t nTrack = 0 ; nTrack < m_Tracks.size() ; nTrack++)
+      {
+      const DBlobTrack& Track = m_Tracks[nTrack];
+
+      // Where the blob should be this frame
+      double dX = Track.m_X.dPosition;
+      double dY = Track.m_Y.dPosition;
+
+      int nFirstCol = std::max(static_cast<int>(std::floor(dX / m_dMaxDistance)) - 1, 0);
+      int nLastCol = std::min(static_cast<int>(std::floor(dX / m_dMaxDistance)) + 1,
+            m_nGridCols - 1);
+      int nFirstRow = std::max(static_cast<int>(std::floor(dY / m_dMaxDistance)) - 1, 0);
+      int nLastRow = std::min(static_cast<int>(std::floor(dY / m_dMaxDistance)) + 1,
+            m_nGridRows - 1);
+
+      for (int nRow = nFirstRow ; nRow <= nLastRow ; nRow++)
+         {
+         for (int nCol = nFirstCol ; nCol <= nLastCol ; nCol++)
+            {
+            int nCell = nRow * m_nGridCols + nCol;
+            for (int i = m_FirstInCell[nCell] ; i < m_FirstInCell[nCell + 1] ; i++)
+               {
+               int nBlob = m_CellBlobs[i];
+               const DBlob* pBlob = m_FrameBlobs[nBlob];
+               if (pBlob->GetType() != Track.m_nColor)
+                  {
+                  continue;
+                  } // end if
+
+               double dDX = pBlob->GetCentroidX() - dX;
+               double dDY = pBlob->GetCentroidY() - dY;
+               double dDistance2 = dDX * dDX + dDY * dDY;
+               if (dDistance2 > dMaxDistance2)
+                  {
+                  continue;
+                  } // end if
+
+               double dArea = pBlob->GetArea();
+               double dTrackArea = static_cast<double>(Track.m_nArea);
+               double dRatio = std::max(dArea, dTrackArea)
+                     / std::max(std::min(dArea, dTrackArea), 1.0);
+               if (dRatio > m_dMaxAreaRatio)
+                  {
+                  continue;
+                  } // end if
+
+               double dCost = dDistance2 / dMaxDistance2;
+               if (dLogMaxRatio > 0.0)
+                  {
+                  dCost += std::log(dRatio) / dLogMaxRatio;
+                  } // end if
+
+               m_Matches.push_back({ dCost, static_cast<int>(nTrack), nBlob });
+               } // end for
+            } // end for
+         } // end for
+      } // end for
+
+   return;
+
+   } // End of function DBlobTracks::FindMatches
+
+/*****************************************************************************
+ *
+ *  DBlobTracks::GetSearchWindows
+ *
+ *  Each track's window reaches its blob's last width and height from where
+ *  the prediction puts the centroid, which holds the whole box wherever
+ *  the centroid is in it.  Three standard deviations of the predicted
+ *  position and the padding are added on.  Predicting further ahead, as
+ *  for a frame already on its way when the tracks were updated, widens
+ *  the windows as the uncertainty grows.
+ *
+ *****************************************************************************/
+
+void DBlobTracks::GetSearchWindows(std::vector<cv::Rect>& Windows,
+      int nFramesAhead /* = 1 */) const
+   {
+   Windows.clear();
+   for (const auto& Track : m_Tracks)
+      {
+      const DBlobTrack::DAxisFilter* Axes[2] = { &Track.m_X, &Track.m_Y };
+      int nSize[2] = { Track.m_nWidth, Track.m_nHeight };
+      int nLow[2];
+      int nHigh[2];
+      for (int i = 0 ; i < 2 ; i++)
+         {
+         DBlobTrack::DAxisFilter Axis = *Axes[i];
+         for (int n = 0 ; n < std::max(nFramesAhead, 1) ; n++)
+            {
+            Axis.Predict(m_dProcessNoise);
+            } // end for
+         double dReach = nSize[i] + m_nSearchPadding
+               + 3.0 * std::sqrt(std::max(Axis.dP00, 0.0));
+         nLow[i] = static_cast<int>(std::floor(Axis.dPosition - dReach));
+         nHigh[i] = static_cast<int>(std::ceil(Axis.dPosition + dReach));
+         } // end for
+
+      Windows.emplace_back(nLow[0], nLow[1], nHigh[0] - nLow[0] + 1,
+            nHigh[1] - nLow[1] + 1);
+      } // end for
+
+   return;
+
+   } // End of function DBlobTracks::GetSearchWindows
@@ -0,0 +1,377 @@
+/*****************************************************************************
+ ******************************* DBlobTracks.h *******************************
+ *****************************************************************************/
+
+#if !defined(__DBLOBTRACKS_H__)
+#define __DBLOBTRACKS_H__
+
+#pragma once
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+#include "DBlobs.h"
+
+#include <vector>
+#include <cstdint>
+
+/*****************************************************************************
+ *
+ ***  class DBlobTrack
+ *
+ *  One blob followed from frame to frame.  Track IDs are never reused.
+ *  Position and velocity come from a constant velocity Kalman filter.  The
+ *  x and y axes don't interact in that model so each has its own two state
+ *  filter.  While no blob matches the track it coasts on the prediction.
+ *
+ *****************************************************************************/
+
+class DBlobTrack
+   {
+   friend class DBlobTracks;
+
+   public:
+      DBlobTrack() = default;
+
+      DBlobTrack(const DBlobTrack& src) = default;
+
+      ~DBlobTrack() = default;
+
+      DBlobTrack& operator=(const DBlobTrack& rhs) = default;
+
+      int GetID() const
+         {
+         return (m_nID);
+         }
+
+      int GetColor() const
+         {
+         return (m_nColor);
+         }
+
+      // Frames since the track started, the first one included
+      int GetAge() const
+         {
+         return (m_nAge);
+         }
+
+      // Frames in a row without a matching blob
+      int GetMissed() const
+         {
+         return (m_nMissed);
+         }
+
+      // ID of the matching blob in the latest frame, -1 if it was missed
+      int GetBlobID() const
+         {
+         return (m_nBlobID);
+         }
+
+      // Filtered centroid of the blob, or where it should be when missed
+      double GetX() const
+         {
+         return (m_X.dPosition);
+         }
+
+      double GetY() const
+         {
+         return (m_Y.dPosition);
+         }
+
+      // Pixels per frame
+      double GetVelocityX() const
+         {
+         return (m_X.dVelocity);
+         }
+
+      double GetVelocityY() const
+         {
+         return (m_Y.dVelocity);
+         }
+
+      // Size of the blob when last seen
+      int64_t GetArea() const
+         {
+         return (m_nArea);
+         }
+
+      int GetWidth() const
+         {
+         return (m_nWidth);
+         }
+
+      int GetHeight() const
+         {
+         return (m_nHeight);
+         }
+
+   protected:
+      // Kalman filter for one axis.  The state is position and velocity with
+      // covariance [dP00 dP01; dP01 dP11].  Frames are the time step.
+      struct DAxisFilter
+         {
+         double dPosition;
+         double dVelocity;
+         double dP00;
+         double dP01;
+         double dP11;
+
+         void Start(double dMeasured, double dMeasureNoise, double dVelocityVariance)
+            {
+            dPosition = dMeasured;
+            dVelocity = 0.0;
+            dP00 = dMeasureNoise;
+            dP01 = 0.0;
+            dP11 = dVelocityVariance;
+
+            return;
+            }
+
+         // Step ahead a frame.  dProcessNoise is the variance of the
+         // acceleration over a frame.
+         void Predict(double dProcessNoise)
+            {
+            dPosition += dVelocity;
+            dP00 += 2.0 * dP01 + dP11 + 0.25 * dProcessNoise;
+            dP01 += dP11 + 0.5 * dProcessNoise;
+            dP11 += dProcessNoise;
+
+            return;
+            }
+
+         void Correct(double dMeasured, double dMeasureNoise)
+            {
+            double dGain0 = dP00 / (dP00 + dMeasureNoise);
+            double dGain1 = dP01 / (dP00 + dMeasureNoise);
+            double dError = dMeasured - dPosition;
+            dPosition += dGain0 * dError;
+            dVelocity += dGain1 * dError;
+            dP11 -= dGain1 * dP01;
+            dP01 -= dGain0 * dP01;
+            dP00 -= dGain0 * dP00;
+
+            return;
+            }
+         };
+
+      int m_nID;
+      int m_nColor;
+      int m_nAge;
+      int m_nMissed;
+      int m_nBlobID;
+      DAxisFilter m_X;
+      DAxisFilter m_Y;
+      int64_t m_nArea;
+      int m_nWidth;
+      int m_nHeight;
+
+   private:
+
+   }; // end of class DBlobTrack
+
+/*****************************************************************************
+ *
+ ***  class DBlobTracks
+ *
+ *  Follows the blobs of successive frames.  Each frame's blobs are matched
+ *  to the tracks by color, distance from where the track should be and
+ *  area.  The blobs are binned in a uniform grid with cells the size of the
+ *  largest allowed move, so each track only looks at the blobs in the 3 x 3
+ *  cells around it.  Candidate pairs are taken best first; blobs left over
+ *  start new tracks and tracks missed for too long are dropped.
+ *
+ *  The predictions also give search windows so the finder can skip most of
+ *  the frame while the blobs are locked on.
+ *
+ *****************************************************************************/
+
+class DBlobTracks
+   {
+   public:
+      using DTrackVector = std::vector<DBlobTrack>;
+
+      DBlobTracks();
+
+      DBlobTracks(const DBlobTracks& src) = default;
+
+      ~DBlobTracks() = default;
+
+      DBlobTracks& operator=(const DBlobTracks& rhs) = default;
+
+      // Match the next frame's blobs to the tracks.  bFullScan says if the
+      // whole frame was searched or only the search windows.
+      void Update(const DBlobs& Blobs, bool bFullScan = true);
+
+      // Drop every track.  IDs start over too.
+      void Clear();
+
+      // Tracks in the order they were started
+      const DTrackVector& GetTracks() const
+         {
+         return (m_Tracks);
+         }
+
+      // Track matching the blob with this ID in the latest frame, null if
+      // there isn't one
+      const DBlobTrack* FindTrack(int nBlobID) const
+         {
+         return (((nBlobID >= 0) && (nBlobID < static_cast<int>(m_BlobTracks.size()))
+               && (m_BlobTracks[nBlobID] != -1)) ? &m_Tracks[m_BlobTracks[nBlobID]] : nullptr);
+         }
+
+      // Farthest in pixels a blob may be from where its track should be
+      void SetMaxDistance(double dMaxDistance)
+         {
+         m_dMaxDistance = std::max(dMaxDistance, 1.0);
+
+         return;
+         }
+
+      double GetMaxDistance() const
+         {
+         return (m_dMaxDistance);
+         }
+
+      // Largest ratio of the larger to the smaller area of a match
+      void SetMaxAreaRatio(double dMaxAreaRatio)
+         {
+         m_dMaxAreaRatio = std::max(dMaxAreaRatio, 1.0);
+
+         return;
+         }
+
+      double GetMaxAreaRatio() const
+         {
+         return (m_dMaxAreaRatio);
+         }
+
+      // Frames a track may go unmatched before it's dropped
+      void SetMaxMissed(int nMaxMissed)
+         {
+         m_nMaxMissed = std::max(nMaxMissed, 0);
+
+         return;
+         }
+
+      int GetMaxMissed() const
+         {
+         return (m_nMaxMissed);
+         }
+
+      // Variance of a blob's change in velocity from frame to frame
+      void SetProcessNoise(double dProcessNoise)
+         {
+         m_dProcessNoise = std::max(dProcessNoise, 0.0);
+
+         return;
+         }
+
+      double GetProcessNoise() const
+         {
+         return (m_dProcessNoise);
+         }
+
+      // Variance of the measured centroids, at least a little above zero
+      void SetMeasureNoise(double dMeasureNoise)
+         {
+         m_dMeasureNoise = std::max(dMeasureNoise, 0.01);
+
+         return;
+         }
+
+      double GetMeasureNoise() const
+         {
+         return (m_dMeasureNoise);
+         }
+
+      // Once blobs are being tracked only windows around them need to be
+      // searched.  The whole frame is still searched every so many frames,
+      // or right after a track goes missing, to pick up new blobs.
+      void SetRescanInterval(int nRescanInterval)
+         {
+         m_nRescanInterval = std::max(nRescanInterval, 1);
+
+         return;
+         }
+
+      int GetRescanInterval() const
+         {
+         return (m_nRescanInterval);
+         }
+
+      // Pixels added around each blob's box beyond its position uncertainty
+      void SetSearchPadding(int nSearchPadding)
+         {
+         m_nSearchPadding = std::max(nSearchPadding, 0);
+
+         return;
+         }
+
+      int GetSearchPadding() const
+         {
+         return (m_nSearchPadding);
+         }
+
+      // True when the frame nFramesAhead after the last one updated should
+      // be searched in full
+      bool IsFullScanDue(int nFramesAhead = 1) const
+         {
+         return (m_Tracks.empty() || m_bTrackMissed
+               || (m_nSinceFullScan + nFramesAhead >= m_nRescanInterval));
+         }
+
+      // Windows around where each track's blob should be nFramesAhead frames
+      // after the last one updated
+      void GetSearchWindows(std::vector<cv::Rect>& Windows,
+            int nFramesAhead = 1) const;
+
+   protected:
+      DTrackVector m_Tracks;
+      int m_nNextID;
+
+      double m_dMaxDistance;
+      double m_dMaxAreaRatio;
+      int m_nMaxMissed;
+      double m_dProcessNoise;
+      double m_dMeasureNoise;
+
+      int m_nRescanInterval;
+      int m_nSearchPadding;
+      // Frames searched by window since the last full scan
+      int m_nSinceFullScan;
+      // Some track wasn't matched in the latest frame
+      bool m_bTrackMissed;
+
+      // The frame's blobs and the track each was matched to, -1 if none
+      std::vector<const DBlob*> m_FrameBlobs;
+      std::vector<int> m_FrameTracks;
+
+      // Uniform grid of the frame's blobs by centroid.  The blobs of cell n
+      // are m_CellBlobs[m_FirstInCell[n]] up to the next cell's first.
+      int m_nGridCols;
+      int m_nGridRows;
+      std::vector<int> m_FirstInCell;
+      std::vector<int> m_CellBlobs;
+
+      // Possible pairing of a track and a frame blob, lower cost is better
+      struct DMatch
+         {
+         double dCost;
+         int nTrack;
+         int nBlob;
+         };
+
+      std::vector<DMatch> m_Matches;
+
+      // Index in m_Tracks of each blob ID's track, -1 if none
+      std::vector<int> m_BlobTracks;
+
+      void BuildGrid();
+      void FindMatches();
+
+   private:
+
+   }; // end of class DBlobTracks
+
+#endif // __DBLOBTRACKS_H__
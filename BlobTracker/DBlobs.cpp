@@ -1,870 +1,3290 @@
-/*****************************************************************************
- ********************************* DBlobs.cpp *********************************
- *****************************************************************************/
-
-/*****************************************************************************
- ******************************  I N C L U D E  *******************************
- *****************************************************************************/
-
-#include "DBlobs.h"
-
-/*****************************************************************************
- ************************* Class DRun Implementation **************************
- *****************************************************************************/
-
-/*****************************************************************************
- ************************* Class DBlob Implementation *************************
- *****************************************************************************/
-
-/*****************************************************************************
- *
- *  DBlob::DBlob
- *
- *****************************************************************************/
-
-DBlob::DBlob()
-   {
-   Init();
-
-   return;
-
-   } // End of function DBlob::DBlob 
-
-/*****************************************************************************
- *
- *  DBlob::DBlob
- *
- *****************************************************************************/
-
-DBlob::DBlob(int nID, int nType)
-   {
-   Init();
-   m_nID = nID;
-   m_nType = nType;
-
-   return;
-
-   } // End of function DBlob::DBlob 
-
-/*****************************************************************************
- *
- *  DBlob::Init
- *
- *  Common initialization.
- *
- *****************************************************************************/
-
-void DBlob::Init()
-   {
-   m_nID = -1;
-   m_nType = -1;
-   m_fPerimeter = 0.0f;
-
-   return;
-
-   } // End of function DBlob::Init
-
-/*****************************************************************************
- *
- *  DBlob::Copy
- *
- *****************************************************************************/
-
-void DBlob::Copy(const DBlob& src)
-   {
-   m_nID = src.m_nID;
-   m_nType = src.m_nType;
-   m_fPerimeter = src.m_fPerimeter;
-   m_Moments = src.m_Moments;
-   m_rcBound = src.m_rcBound;
-   m_Pixels = src.m_Pixels;
-
-   return;
-
-   } // End of function DBlob::Copy 
-
-/*****************************************************************************
- *
- *  DBlob::AddRun
- *
- *  Add a pixel run to this blob and update the properties.
- *
- *****************************************************************************/
-
-void DBlob::AddRun(DRun& Run)
-   {
-   Run.SetBlob(m_nID);
-
-   // The area of a run is only 1 pixel tall
-   int nRunArea = Run.GetEnd() - Run.GetStart() + 1;
-   m_Moments.m00 += nRunArea;
-
-   // Update first moment data
-   m_Moments.m10 += nRunArea * ((Run.GetStart() + Run.GetEnd()) / 2.0f);
-   m_Moments.m01 += nRunArea * Run.GetRow();
-
-   // Update the bounding rectangle
-   if (m_Pixels.empty())
-      {
-      // First run so initialize the rectangle
-      m_rcBound.x = Run.GetStart();
-      m_rcBound.width = nRunArea;
-      m_rcBound.y = Run.GetRow();
-      m_rcBound.height = 1;
-      } // end if
-   else
-      {
-      m_rcBound.InflateXLeft(Run.GetStart());
-      m_rcBound.InflateXRight(Run.GetEnd());
-      m_rcBound.InflateYTop(Run.GetRow());
-      m_rcBound.InflateYBottom(Run.GetRow());
-      } // end else
-
-   m_Pixels.push_back(Run);
-
-   return;
-
-   } // End of function DBlob::AddRun 
-
-/*****************************************************************************
- *
- *  DBlob::Merge
- *
- *  Two blobs have been found that touch and are the same color.  One gets
- *  absorbed by the other.
- *
- *****************************************************************************/
-
-void DBlob::Merge(DBlob& Blob)
-   {
-   // Absorb the passed blob's pixel runs
-   for (auto& Run : Blob.m_Pixels)
-      {
-      Run.SetBlob(m_nID);
-      AddRun(Run);
-      } // end for
-   Blob.m_Pixels.clear();
-
-   return;
-
-   } // End of function DBlob::Merge 
-
-/*****************************************************************************
- *
- *  DBlob::Display
- *
- *****************************************************************************/
-
-void DBlob::Display(DBlobRenderer* pRenderer, cv::Scalar Color,
-      int nDisplay /* = eBlob */,
-      cv::Scalar CHColor /* = cv::Scalar(255, 255, 255) */,
-      int nThickness /* = 1 */) const
-      {
-   if ((nDisplay & eBlob) != 0)
-      {
-      // Draw horizontal lines for the pixel runs
-      for (const auto& Run : m_Pixels)
-         {
-         pRenderer->Line(Run.GetStart(), Run.GetRow(), Run.GetEnd(),
-               Run.GetRow(), Color);
-         } // end for
-      } // end if
-
-   if ((nDisplay & eBoundingRect) != 0)
-      {
-      DisplayBoundingRect(pRenderer, Color);
-      } // end if
-
-   if ((nDisplay & eCrossHairs) != 0)
-      {
-      DisplayCrossHairs(pRenderer, CHColor, nThickness);
-      } // end if
-
-   return;
-
-   } // End of function DBlob::Display 
-
-/*****************************************************************************
- ********************** Class DBlobColor Implementation ***********************
- *****************************************************************************/
-
-/*****************************************************************************
- *
- *  DBlobColor::DBlobColor
- *
- *****************************************************************************/
-
-DBlobColor::DBlobColor(const std::string& strName, const DBlob::DBlobColorRange& ColorRange,
-      const DCVRGB& DisplayColor) :
-      m_strName(strName),
-      m_ColorRange(ColorRange),
-      m_DisplayColor(DisplayColor)
-   {
-
-   return;
-
-   } // End of function DBlobColor::DBlobColor 
-
-/*****************************************************************************
- *********************** Class DBlobMap Implementation ************************
- *****************************************************************************/
-
-/*****************************************************************************
- *
- *  DBlobMap::RemoveSmallBlobs
- *
- *  Remove blobs smaller than fMinArea in this map which holds the blobs of
- *  one color.
- *
- *****************************************************************************/
-
-int DBlobMap::RemoveSmallBlobs(double dMinArea)
-   {
-   int nCount = 0;
-
-   iterator i = begin();
-   while (i != end())
-      {
-      if (i->second.GetArea() < dMinArea)
-         {
-         i = this->erase(i);
-         nCount++;
-         } // end if
-      else
-         {
-         ++i;
-         } // end else
-      } // end while
-
-   return (nCount);
-
-   } // End of function DBlobMap::RemoveSmallBlobs 
-
-/*****************************************************************************
- *
- *  DBlobMap::FindLargestBlob
- *
- *  Find the largest blob in this category.  Return its ID or -1 if none is
- *  found.
- *
- *****************************************************************************/
-
-int DBlobMap::FindLargestBlob() const
-   {
-   int nID = -1;
-   double dMaxArea = 0.0;
-
-   for (const_iterator i = begin() ; i != end() ; ++i)
-      {
-      if (i->second.GetArea() > dMaxArea)
-         {
-         dMaxArea = i->second.GetArea();
-         nID = i->second.GetID();
-         } // end if
-      } // end for
-
-   return (nID);
-
-   } // End of function DBlobMap::FindLargestBlob 
-
-/*****************************************************************************
- ************************ Class DBlobs Implementation *************************
- *****************************************************************************/
-
-/*****************************************************************************
- *
- *  DBlobs::FindBlob
- *
- *  Find a particular blob by blob ID.  ID is unique across all colors.
- *
- *****************************************************************************/
-
-DBlobMap::DSearchPair DBlobs::FindBlob(int nID)
-   {
-   DBlobMap::DSearchPair Result;
-   Result.first = false;
-
-   // Start with 1, 0 is background, and check each color
-   for (size_t c = 1 ; !Result.first && (c < size()) ; c++)
-      {
-      DBlobMap& Map = (*this)[c];
-      Result.second = Map.find(nID);
-      if (Result.second != Map.end())
-         {
-         Result.first = true;
-         } // end if
-      } // end for
-
-   return (Result);
-
-   } // End of function DBlobs::FindBlob 
-
-/*****************************************************************************
- *
- *  DBlobs::FindBlob
- *
- *  Find a particular blob by blob ID const version.  ID is unique across all
- *  colors.
- *
- *****************************************************************************/
-
-DBlobMap::DConstSearchPair DBlobs::FindBlob(int nID) const
-      {
-   DBlobMap::DConstSearchPair Result;
-   Result.first = false;
-
-   // Start with 1, 0 is background, and check each color
-   for (size_t c = 1 ; !Result.first && (c < size()) ; c++)
-      {
-      const DBlobMap& Map = (*this)[c];
-      Result.second = Map.find(nID);
-      if (Result.second != Map.end())
-         {
-         Result.first = true;
-         } // end if
-      } // end for
-
-   return (Result);
-
-   } // End of function DBlobs::FindBlob 
-
-/*****************************************************************************
- *
- *  DBlobs::FindLargestBlobs
- *
- *  Find the largest blob for each color category and return the IDs by
- *  filling in the passed vector.  Element 0 of the array will contain -1 since
- *  by convention this is the background.  -1 is used to indicate a category
- *  has no blobs found.
- *
- *****************************************************************************/
-
-void DBlobs::FindLargestBlobs(DBlob::DIDVector& Largest) const
-      {
-   Largest.resize(this->size());
-   if (Largest.size() > 0)
-      {
-      // Element 0 is background and has no members
-      Largest[0] = -1;
-
-      // Start with 1, 0 is background, and check each color
-      for (size_t c = 1 ; c < this->size() ; c++)
-         {
-         const DBlobMap& Map = (*this)[c];
-         Largest[c] = Map.FindLargestBlob();
-         } // end for
-      } // end if
-
-   return;
-
-   } // End of function DBlobs::FindLargestBlobs 
-
-/*****************************************************************************
- *
- *  DBlobs::RemoveSmallBlobs
- *
- *  Remove blobs smaller than the specified area.  Return the number of blobs
- *  removed.
- *
- *****************************************************************************/
-
-int DBlobs::RemoveSmallBlobs(double dMinArea)
-   {
-   int nCount = 0;
-
-   // Start with 1, 0 is background, and check each color
-   for (size_t c = 1 ; c < this->size() ; c++)
-      {
-      DBlobMap& Map = (*this)[c];
-      nCount += Map.RemoveSmallBlobs(dMinArea);
-      } // end for
-
-   return (nCount);
-
-   } // End of function DBlobs::RemoveSmallBlobs 
-
-/*****************************************************************************
- *
- *  DBlobs::RemoveSmallBlobs
- *
- *  Remove blobs of the specified color smaller than the specified area.
- *  Return the number of blobs removed.
- *
- *****************************************************************************/
-
-int DBlobs::RemoveSmallBlobs(int nColor, double dMinArea)
-   {
-   DBlobMap& Map = (*this)[nColor];
-
-   return (Map.RemoveSmallBlobs(dMinArea));
-
-   } // End of function DBlobs::RemoveSmallBlobs 
-
-/*****************************************************************************
- *
- *  DBlobs::DisplayBlobs
- *
- *  Display all the blobs of one color and optionally their decoration.
- *
- *****************************************************************************/
-
-void DBlobs::DisplayBlobs(DBlobRenderer* pRenderer, const DBlobMap& BlobMap,
-      cv::Scalar BlobColor, int nDisplay /* = DBlob:: eBlob */,
-      cv::Scalar CHColor /* = cv::Scalar(255, 255, 255) */,
-      int nThickness /* = 1 */) const
-      {
-   for (DBlobMap::const_iterator b = BlobMap.begin() ; b != BlobMap.end()
-         ; ++b)
-      {
-      b->second.Display(pRenderer, BlobColor, nDisplay, CHColor, nThickness);
-      } // end for
-
-   return;
-
-   } // End of function DBlobs::DisplayBlobs 
-
-/*****************************************************************************
- *
- *  DBlobs::DisplayBlobs
- *
- *  Display all the blobs and optionally their decoration.
- *
- *****************************************************************************/
-
-void DBlobs::DisplayBlobs(DBlobRenderer* pRenderer,
-      const DBlobColor::Vector& Colors, int nDisplay /* = DBlobs::eBlob */,
-      cv::Scalar CHColor /* = cv::Scalar(255, 255, 255) */,
-      int nThickness /* = 1 */) const
-      {
-   for (size_t c = 1 ; c < size() ; c++)
-      {
-      DisplayBlobs(pRenderer, (*this)[c], Colors[c].GetDisplayColor(), nDisplay,
-            CHColor, nThickness);
-      } // end for
-
-   return;
-
-   } // End of function DBlobs::DisplayBlobs 
-
-/*****************************************************************************
- *
- *  DBlobs::DisplayBlob
- *
- *****************************************************************************/
-
-bool DBlobs::DisplayBlob(DBlobRenderer* pRenderer, int nBlobID, cv::Scalar BlobColor,
-      int nDisplay /* = DBlob::eBlob */,
-      cv::Scalar CHColor /* = cv::Scalar(255, 255, 255) */,
-      int nThickness /* = 1 */) const
-      {
-   DBlobMap::DConstSearchPair Pair = FindBlob(nBlobID);
-   if (Pair.first)
-      {
-      Pair.second->second.Display(pRenderer, BlobColor, nDisplay,
-            CHColor, nThickness);
-      } // end if
-
-   return (Pair.first);
-
-   } // End of function DBlobs::DisplayBlob 
-
-/*****************************************************************************
- *
- *  DBlobs::DisplayBlobs
- *
- *  Display blobs from a vector of IDs.  Optionally, display their decoration.
- *  Return a count of the blobs actually displayed.
- *
- *****************************************************************************/
-
-int DBlobs::DisplayBlobs(DBlobRenderer* pRenderer, const DBlob::DIDVector& BlobIDs,
-      cv::Scalar BlobColor /* = cv::Scalar(255, 0, 0) */,
-      int nDisplay /* = DBlobs::eBlob */,
-      cv::Scalar CHColor /* = cv::Scalar(255, 255, 255) */,
-      int nThickness /* = 1 */) const
-      {
-   int nCount = 0;
-   for (auto& BlobID : BlobIDs)
-      {
-      if (DisplayBlob(pRenderer, BlobID, BlobColor, nDisplay, CHColor,
-            nThickness))
-         {
-         nCount++;
-         } // end if
-      } // end for
-
-   return (nCount);
-
-   } // End of function DBlobs::DisplayBlobs 
-
-/*****************************************************************************
- ******************* Class DColorBlobFinder Implementation ********************
- *****************************************************************************/
-
-/*****************************************************************************
- *
- *  DColorBlobFinder::DColorBlobFinder
- *
- *****************************************************************************/
-
-DColorBlobFinder::DColorBlobFinder(DBlobColor::Vector* pColors)
-   {
-   Init();
-
-   m_pColors = pColors;
-
-   return;
-
-   } // End of function DColorBlobFinder::DColorBlobFinder 
-
-/*****************************************************************************
- *
- *  DColorBlobFinder::Init
- *
- *  Handle common initialization.
- *
- *****************************************************************************/
-
-void DColorBlobFinder::Init()
-   {
-   m_pColors = nullptr;
-   m_pImage = nullptr;
-
-   return;
-
-   } // End of function DColorBlobFinder::Init 
-
-/*****************************************************************************
- *
- *  DColorBlobFinder::ConvertRGBPixel
- *
- *  Convert the RGB pixel from the original image to the color space to be
- *  used for testing.
- *
- *  This default implementation simply does a copy so testing would be RGB.
- *
- *****************************************************************************/
-
-void DColorBlobFinder::ConvertRGBPixel(unsigned char RGBPixel[3],
-      unsigned char Pixel[3])
-   {
-   for (int i = 0 ; i < 3 ; i++)
-      {
-      Pixel[i] = RGBPixel[i];
-      } // end for
-
-   return;
-
-   } // End of function DColorBlobFinder::ConvertRGBPixel 
-
-/*****************************************************************************
- *
- *  DColorBlobFinder::AllocateMemory
- *
- *  Allocate or reallocate the memory necessary to support finding the blobs.
- *
- *****************************************************************************/
-
-bool DColorBlobFinder::AllocateMemory()
-   {
-   // (Re)Create the matrix of pixel color categories
-   m_ColorMat.Resize(m_pImage->GetNumRows(), m_pImage->GetNumCols());
-
-   // Clear out the old blobs
-   for (auto& Blob : m_Blobs)
-      {
-      Blob.clear();
-      } // end for
-
-   m_Blobs.resize(m_pColors->size());
-
-   return (true);
-
-   } // End of function DColorBlobFinder::AllocateMemory 
-
-/*****************************************************************************
- *
- *  DColorBlobFinder::Find
- *
- *  The primary entry point of find color blobs.
- *
- *****************************************************************************/
-
-bool DColorBlobFinder::Find()
-   {
-   bool bRet = (m_pImage != nullptr) && (m_pColors != nullptr) && AllocateMemory();
-   if (bRet)
-      {
-      CategorizePixels();
-      FindRuns();
-      } // end if
-
-   return (bRet);
-
-   } // End of function DColorBlobFinder::Find 
-
-/*****************************************************************************
- *
- *  DColorBlobFinder::Find
- *
- *  The external find entry point.  Assumes the finder is initialized and
- *  ready to process an image.
- *
- *****************************************************************************/
-
-bool DColorBlobFinder::Find(DCVImage* pImage)
-   {
-   m_pImage = pImage;
-
-   return (Find());
-
-   } // End of function DColorBlobFinder::Find 
-
-/*****************************************************************************
- *
- *  DColorBlobFinder::CategorizePixels
- *
- *  Apply the color thresholds and categorize each pixel into background or
- *  color category.  Background is always category zero.
- *
- *****************************************************************************/
-
-void DColorBlobFinder::CategorizePixels()
-   {
-   // Check each pixel in the input and catgorize it as to color
-   for (int r = 0 ; r < m_pImage->GetNumRows() ; r++)
-      {
-      unsigned char* pRow = m_pImage->GetRow(r);
-      COLORTYPE*  ColorRow = m_ColorMat[r];
-//      unsigned char* ColorRow = m_ColorMat[r];
-
-      for (int c = 0 ; c < m_pImage->GetNumCols() ; c++)
-         {
-         // Set the pixel to background as a default
-         ColorRow[c] = 0;
-
-         // Convert the RGB image pixel to the testing color space         
-         unsigned char Pixel[3];
-         ConvertRGBPixel(m_pImage->GetPixel(pRow, c), Pixel);
-
-         // Check each color.  No distance metric is used.
-         // First match wins!
-         for (size_t i = 1 ; i < m_pColors->size() ; i++)
-            {
-            if ((*m_pColors)[i].ComparePixel(Pixel))
-               {
-               ColorRow[c] = static_cast<COLORTYPE>(i);
-               break;
-               } // end if
-            } // end for
-         } // end for
-      } // end for
-
-   return;
-
-   } // End of function DColorBlobFinder::CategorizePixels 
-
-/*****************************************************************************
- *
- *  DColorBlobFinder::FindRuns
- *
- *  Find all the runs of pixels for each color.
- *
- *****************************************************************************/
-
-void DColorBlobFinder::FindRuns()
-   {
-   // Provide storage for two image rows of horizontal color run data
-   size_t nColorCount = m_pColors->size();
-   int nPrevRuns = 0;
-   int nCurRuns = 1;
-   std::vector<std::vector<DRun> > ColorRuns[2];
-   ColorRuns[0].resize(nColorCount);
-   ColorRuns[1].resize(nColorCount);
-
-   // Each blob found will have a unique number
-   int nNextBlob = 0;
-
-   // Check the color of each pixel and keep track of horizontal contiguous
-   // runs
-   for (int r = 0 ; r < m_pImage->GetNumRows() ; r++)
-      {
-      COLORTYPE* ColorRow = m_ColorMat[r];
-      // New row starting so a new color run is starting, too
-      COLORTYPE nCurColor = ColorRow[0];
-      int nStart = 0;
-      for (int c = 1 ; c < m_pImage->GetNumCols() ; c++)
-         {
-         // If the current pixel color isn't the same as the current run,
-         // a new run is starting
-         if (ColorRow[c] != nCurColor)
-            {
-            //  New run starting
-            if (nCurColor != 0)
-               {
-               // Current run is not background so save it
-               ColorRuns[nCurRuns][nCurColor].push_back(
-                     DRun(r, nStart, c - 1, nCurColor));
-               } // end if
-
-            // Mark a new color run starting   
-            nCurColor = ColorRow[c];
-            nStart = c;
-            } // end if
-         } // end for Column Loop
-
-      // At end of a row so save the current run if not background
-      if (nCurColor != 0)
-         {
-         ColorRuns[nCurRuns][nCurColor].push_back(
-               DRun(r, nStart, m_pImage->GetNumCols() - 1, nCurColor));
-         } // end if          `
-
-      // If runs found in this row, try to match them with existing blobs in 
-      // the  previous row.
-      for (size_t nColor = 1 ; nColor < nColorCount ; nColor++)
-         {
-         size_t nCurCount = ColorRuns[nCurRuns][nColor].size();
-         size_t nPrevCount = ColorRuns[nPrevRuns][nColor].size();
-         for (size_t c = 0 ; c < nCurCount ; c++)
-            {
-            DRun& CurRun = ColorRuns[nCurRuns][nColor][c];
-            for (size_t p = 0 ; p < nPrevCount ; p++)
-               {
-               DRun& PrevRun = ColorRuns[nPrevRuns][nColor][p];
-               if (CurRun.Overlap(PrevRun))
-                  {
-                  // We have overlap so decide what to do with it
-                  if (CurRun.GetBlob() == -1)
-                     {
-                     // Aren't part of a blob so join the existing blob
-                     int nBlob = PrevRun.GetBlob();
-                     m_Blobs[nColor][nBlob].AddRun(CurRun);
-                     } // end if
-                  else
-                     {
-                     // Two blobs may be in contact
-                     if (CurRun.GetBlob() != PrevRun.GetBlob())
-                        {
-                        // Two blobs are in contact, merge them otherwise it's
-                        // just another point of contact on a complex blob
-                        int nPrevBlob = PrevRun.GetBlob();
-                        int nCurBlob = CurRun.GetBlob();
-                        DBlob& PrevBlob = m_Blobs[nColor][nPrevBlob];
-                        m_Blobs[nColor][nCurBlob].Merge(PrevBlob);
-                        m_Blobs[nColor].erase(nPrevBlob);
-
-                        // Update the runs of the eliminated blob
-                        for (size_t i = 0 ; i < nPrevCount ; i++)
-                           {
-                           DRun& Run = ColorRuns[nPrevRuns][nColor][i];
-                           if (Run.GetBlob() == nPrevBlob)
-                              {
-                              Run.SetBlob(nCurBlob);
-                              } // end if
-                           } // end for
-
-                        for (size_t i = 0 ; i < nCurCount ; i++)
-                           {
-                           DRun& Run = ColorRuns[nCurRuns][nColor][i];
-                           if (Run.GetBlob() == nPrevBlob)
-                              {
-                              Run.SetBlob(nCurBlob);
-                              } // end if
-                           } // end for
-                        } // end if
-                     } // end else
-                  } // end if
-               } // end for
-
-            // Is the current run assigned to a blob?      
-            if (CurRun.GetBlob() == -1)
-               {
-               // Wasn't joined to an existing blob so start a new one
-               DBlob Blob(nNextBlob, CurRun.GetColor());
-               Blob.AddRun(CurRun);
-               m_Blobs[CurRun.GetColor()].insert(
-                     DBlobMap::value_type(nNextBlob, Blob));
-               nNextBlob++;
-               } // end if   
-            } // end for   
-         } // end for Color Loop
-
-      // Make the current row runs the previous row runs
-      nCurRuns ^= 1;
-      nPrevRuns ^= 1;
-
-      // Clear the previous row's runs which is now the current row
-      for (auto& ColorRun : ColorRuns[nCurRuns])
-         {
-         ColorRun.clear();
-         } // end for
-      } // end for Row Loop
-
-   return;
-
-   } // End of function DColorBlobFinder::FindRuns 
-
-/*****************************************************************************
- *
- *  DColorBlobFinder::DisplayCategories
- *
- *  Build an Image where each pixel's color indicates the blob color.  This
- *  routine is relatively slow but is mostly for debugging.
- *
- *****************************************************************************/
-
-void DColorBlobFinder::DisplayCategories(DBlobRenderer* pRenderer) const
-      {
-   if ((m_pImage != nullptr) && (m_pColors != nullptr))
-      {
-      for (int r = 0 ; r < m_pImage->GetNumRows() ; r++)
-         {
-         const COLORTYPE* ColorRow = m_ColorMat[r];
-         for (int c = 0 ; c < m_pImage->GetNumCols() ; c++)
-            {
-            DBlobColor BlobColor = (*m_pColors)[ColorRow[c]];
-            pRenderer->Point(r, c, BlobColor.GetDisplayColor());
-            } // end for
-         } // end for
-      } // end if
-
-   return;
-
-   } // End of function DColorBlobFinder::DisplayCategories 
-
-/*****************************************************************************
- *
- *  DColorBlobFinder::DisplayLargestBlobs
- *
- *****************************************************************************/
-
-int DColorBlobFinder::DisplayLargestBlobs(DBlobRenderer* pRenderer,
-      int nDisplay /* = DBlob::eBlob */,
-      cv::Scalar CHColor /* = cv::Scalar(255, 255, 255) */,
-      int nThickness /* = 1 */) const
-      {
-   int nCount = 0;
-   DBlob::DIDVector Largest;
-
-   if (m_pColors != nullptr)
-      {
-      FindLargestBlobs(Largest);
-      for (size_t i = 1 ; i < Largest.size() ; i++)
-         {
-         if (Largest[i] != -1)
-            {
-            m_Blobs.DisplayBlob(pRenderer, Largest[i],
-                  (*m_pColors)[i].GetDisplayColor(), nDisplay,
-                  CHColor, nThickness);
-            nCount++;
-            } // end if
-         } // end for
-      } // end if
-
-   return (nCount);
-
-   } // End of function DColorBlobFinder::DisplayLargestBlobs
-
-
-
+/*****************************************************************************
+ ********************************* DBlobs.cpp *********************************
+ *****************************************************************************/
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+#include "DBlobs.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+/*****************************************************************************
+ ************************* Class DRun Implementation **************************
+ *****************************************************************************/
+
+/*****************************************************************************
+ ************************* Class DBlob Implementation *************************
+ *****************************************************************************/
+
+/*****************************************************************************
+ *
+ *  DBlob::DBlob
+ *
+ *****************************************************************************/
+
+DBlob::DBlob()
+   {
+   Init();
+
+   return;
+
+   } // End of function DBlob::DBlob 
+
+/*****************************************************************************
+ *
+ *  DBlob::DBlob
+ *
+ *****************************************************************************/
+
+DBlob::DBlob(int nID, int nType)
+   {
+   Init();
+   m_nID = nID;
+   m_nType = static_cast<int16_t>(nType);
+
+   return;
+
+   } // End of function DBlob::DBlob 
+
+/*****************************************************************************
+ *
+ *  DBlob::Init
+ *
+ *  Common initialization.
+ *
+ *****************************************************************************/
+
+void DBlob::Init()
+   {
+   m_nID = -1;
+   m_nType = -1;
+   m_nArea = 0;
+   m_nSumX = 0;
+   m_nSumY = 0;
+   m_rcBound = DCVRect();
+   m_nFirstRun = 0;
+   m_nRunCount = 0;
+   m_nPerimeter = 0;
+   m_nEuler = 0;
+   m_bStoreRuns = true;
+   m_bHigherMoments = false;
+
+   return;
+
+   } // End of function DBlob::Init
+
+/*****************************************************************************
+ *
+ *  DBlob::Copy
+ *
+ *****************************************************************************/
+
+void DBlob::Copy(const DBlob& src)
+   {
+   m_nID = src.m_nID;
+   m_nType = src.m_nType;
+   m_nArea = src.m_nArea;
+   m_nSumX = src.m_nSumX;
+   m_nSumY = src.m_nSumY;
+   m_rcBound = src.m_rcBound;
+   m_nFirstRun = src.m_nFirstRun;
+   m_nRunCount = src.m_nRunCount;
+   m_nPerimeter = src.m_nPerimeter;
+   m_nEuler = src.m_nEuler;
+   m_bStoreRuns = src.m_bStoreRuns;
+   m_bHigherMoments = src.m_bHigherMoments;
+
+   return;
+
+   } // End of function DBlob::Copy 
+
+/*****************************************************************************
+ *
+ *  DBlob::AddRun
+ *
+ *  Add a pixel run to this blob and update the properties.
+ *
+ *****************************************************************************/
+
+void DBlob::AddRun(DRun& Run)
+   {
+   Run.SetBlob(m_nID);
+
+   // The area of a run is only 1 pixel tall
+   int64_t nRunArea = Run.GetEnd() - Run.GetStart() + 1;
+
+   // Update the bounding rectangle
+   if (m_nArea == 0)
+      {
+      // First run so initialize the rectangle
+      m_rcBound.x = Run.GetStart();
+      m_rcBound.width = static_cast<int>(nRunArea);
+      m_rcBound.y = Run.GetRow();
+      m_rcBound.height = 1;
+      } // end if
+   else
+      {
+      m_rcBound.InflateXLeft(Run.GetStart());
+      m_rcBound.InflateXRight(Run.GetEnd());
+      m_rcBound.InflateYTop(Run.GetRow());
+      m_rcBound.InflateYBottom(Run.GetRow());
+      } // end else
+
+   // Start + End and the run length can't both be odd so the sum of the
+   // columns is exact
+   m_nArea += nRunArea;
+   m_nSumX += nRunArea * (Run.GetStart() + Run.GetEnd()) / 2;
+   m_nSumY += nRunArea * Run.GetRow();
+   m_nRunCount++;
+
+   // On its own the run is a rectangle one pixel tall.  AddContacts takes
+   // off the edges shared with runs above and below.
+   m_nPerimeter += static_cast<int>(2 * nRunArea + 2);
+   m_nEuler++;
+
+   return;
+
+   } // End of function DBlob::AddRun 
+
+/*****************************************************************************
+ *
+ *  DBlob::Reset
+ *
+ *****************************************************************************/
+
+void DBlob::Reset(int nID, int nType, bool bStoreRuns /* = true */,
+      bool bHigherMoments /* = false */)
+   {
+   Init();
+   m_nID = nID;
+   m_nType = static_cast<int16_t>(nType);
+   m_bStoreRuns = bStoreRuns;
+   m_bHigherMoments = bHigherMoments;
+
+   return;
+
+   } // End of function DBlob::Reset
+
+/*****************************************************************************
+ *
+ *  DBlob::swap
+ *
+ *****************************************************************************/
+
+void DBlob::swap(DBlob& Blob)
+   {
+   std::swap(*this, Blob);
+
+   return;
+
+   } // End of function DBlob::swap
+
+/*****************************************************************************
+ *
+ *  DBlob::GetMoments
+ *
+ *****************************************************************************/
+
+cv::Moments DBlob::GetMoments(const DBlobMoments* pHigher /* = nullptr */) const
+   {
+   if (pHigher == nullptr)
+      {
+      cv::Moments Moments;
+      Moments.m00 = static_cast<double>(m_nArea);
+      Moments.m10 = static_cast<double>(m_nSumX);
+      Moments.m01 = static_cast<double>(m_nSumY);
+
+      return (Moments);
+      } // end if
+
+   return (cv::Moments(static_cast<double>(m_nArea),
+         static_cast<double>(m_nSumX), static_cast<double>(m_nSumY),
+         pHigher->m20, pHigher->m11, pHigher->m02,
+         pHigher->m30, pHigher->m21, pHigher->m12, pHigher->m03));
+
+   } // End of function DBlob::GetMoments
+
+/*****************************************************************************
+ *
+ *  DBlob::GetOrientation
+ *
+ *****************************************************************************/
+
+double DBlob::GetOrientation(const DBlobMoments& Higher) const
+   {
+   cv::Moments Moments = GetMoments(&Higher);
+
+   return (0.5 * std::atan2(2.0 * Moments.mu11, Moments.mu20 - Moments.mu02));
+
+   } // End of function DBlob::GetOrientation
+
+/*****************************************************************************
+ *
+ *  DBlob::GetAxes
+ *
+ *  The eigenvalues of the covariance matrix are the variances along the
+ *  principal axes.  A solid ellipse with semi-axis a has variance a^2 / 4
+ *  along it, so each full axis is 4 * sqrt(variance).
+ *
+ *****************************************************************************/
+
+void DBlob::GetAxes(const DBlobMoments& Higher, double& dMajor,
+      double& dMinor) const
+   {
+   dMajor = 0.0;
+   dMinor = 0.0;
+
+   if (m_nArea > 0)
+      {
+      cv::Moments Moments = GetMoments(&Higher);
+      double dXX = Moments.mu20 / Moments.m00;
+      double dXY = Moments.mu11 / Moments.m00;
+      double dYY = Moments.mu02 / Moments.m00;
+
+      double dMean = (dXX + dYY) / 2.0;
+      double dSpread = std::sqrt(((dXX - dYY) / 2.0) * ((dXX - dYY) / 2.0)
+            + dXY * dXY);
+
+      dMajor = 4.0 * std::sqrt(std::max(dMean + dSpread, 0.0));
+      dMinor = 4.0 * std::sqrt(std::max(dMean - dSpread, 0.0));
+      } // end if
+
+   return;
+
+   } // End of function DBlob::GetAxes
+
+/*****************************************************************************
+ *
+ *  DBlob::GetHuMoments
+ *
+ *****************************************************************************/
+
+void DBlob::GetHuMoments(const DBlobMoments& Higher, double Hu[7]) const
+   {
+   cv::HuMoments(GetMoments(&Higher), Hu);
+
+   return;
+
+   } // End of function DBlob::GetHuMoments
+
+/*****************************************************************************
+ *
+ *  DBlob::Display
+ *
+ *****************************************************************************/
+
+void DBlob::Display(DBlobRenderer* pRenderer, const DRun* pRuns,
+      cv::Scalar Color, int nDisplay /* = eBlob */,
+      cv::Scalar CHColor /* = cv::Scalar(255, 255, 255) */,
+      int nThickness /* = 1 */) const
+      {
+   if (((nDisplay & eBlob) != 0) && (pRuns == nullptr))
+      {
+      // No runs kept so the bounding box has to stand in for the blob
+      nDisplay |= eBoundingRect;
+      } // end if
+   else if ((nDisplay & eBlob) != 0)
+      {
+      // Draw horizontal lines for the pixel runs
+      for (int i = 0 ; i < m_nRunCount ; i++)
+         {
+         const DRun& Run = pRuns[i];
+         pRenderer->Line(Run.GetStart(), Run.GetRow(), Run.GetEnd(),
+               Run.GetRow(), Color);
+         } // end for
+      } // end if
+
+   if ((nDisplay & eBoundingRect) != 0)
+      {
+      DisplayBoundingRect(pRenderer, Color);
+      } // end if
+
+   if ((nDisplay & eCrossHairs) != 0)
+      {
+      DisplayCrossHairs(pRenderer, CHColor, nThickness);
+      } // end if
+
+   return;
+
+   } // End of function DBlob::Display 
+
+/*****************************************************************************
+ ********************* Class DBlobMoments Implementation **********************
+ *****************************************************************************/
+
+/*****************************************************************************
+ *
+ *  DBlobMoments::AddRun
+ *
+ *  With S1, S2 and S3 the sums of x, x^2 and x^3 over the run's columns, the
+ *  run adds S2, y S1, y^2 n, S3, y S2, y^2 S1 and y^3 n to the raw moments.
+ *  Each power sum is the difference of the closed forms up to End and up to
+ *  Start - 1, done in integers so it's exact.
+ *
+ *****************************************************************************/
+
+void DBlobMoments::AddRun(const DRun& Run)
+   {
+   auto SumX = [](int64_t k) { return (k * (k + 1) / 2); };
+   auto SumX2 = [](int64_t k) { return (k * (k + 1) * (2 * k + 1) / 6); };
+   auto SumX3 = [&SumX](int64_t k) { return (SumX(k) * SumX(k)); };
+
+   int64_t nStart = Run.GetStart() - 1;
+   int64_t nEnd = Run.GetEnd();
+   double dN = static_cast<double>(nEnd - nStart);
+   double dS1 = static_cast<double>(SumX(nEnd) - SumX(nStart));
+   double dS2 = static_cast<double>(SumX2(nEnd) - SumX2(nStart));
+   double dS3 = static_cast<double>(SumX3(nEnd) - SumX3(nStart));
+   double dY = Run.GetRow();
+
+   m20 += dS2;
+   m11 += dY * dS1;
+   m02 += dY * dY * dN;
+   m30 += dS3;
+   m21 += dY * dS2;
+   m12 += dY * dY * dS1;
+   m03 += dY * dY * dY * dN;
+
+   return;
+
+   } // End of function DBlobMoments::AddRun
+
+/*****************************************************************************
+ ********************** Class DBlobColor Implementation ***********************
+ *****************************************************************************/
+
+/*****************************************************************************
+ *
+ *  DBlobColor::DBlobColor
+ *
+ *****************************************************************************/
+
+DBlobColor::DBlobColor(const std::string& strName, const DBlob::DBlobColorRange& ColorRange,
+      const DCVRGB& DisplayColor) :
+      m_strName(strName),
+      m_ColorRange(ColorRange),
+      m_DisplayColor(DisplayColor)
+   {
+
+   return;
+
+   } // End of function DBlobColor::DBlobColor 
+
+/*****************************************************************************
+ *********************** Class DBlobMap Implementation ************************
+ *****************************************************************************/
+
+/*****************************************************************************
+ *
+ *  DBlobMap::clear
+ *
+ *****************************************************************************/
+
+void DBlobMap::clear()
+   {
+   for (size_t i = 0 ; i < m_nSize ; i++)
+      {
+      m_Index[m_Blobs[i].GetID()] = -1;
+      } // end for
+
+   m_nSize = 0;
+   m_Runs.clear();
+   m_Largest.clear();
+   m_bLargestValid = false;
+
+   return;
+
+   } // End of function DBlobMap::clear
+
+/*****************************************************************************
+ *
+ *  DBlobMap::Add
+ *
+ *  Put a new empty blob in the next free slot, reusing a spare one if there
+ *  is one.
+ *
+ *****************************************************************************/
+
+DBlob& DBlobMap::Add(int nID, int nType, bool bStoreRuns /* = true */,
+      bool bHigherMoments /* = false */)
+   {
+   if (nID >= static_cast<int>(m_Index.size()))
+      {
+      m_Index.resize(nID + 1, -1);
+      } // end if
+
+   if (m_nSize < m_Blobs.size())
+      {
+      m_Blobs[m_nSize].Reset(nID, nType, bStoreRuns, bHigherMoments);
+      } // end if
+   else
+      {
+      m_Blobs.emplace_back();
+      m_Blobs.back().Reset(nID, nType, bStoreRuns, bHigherMoments);
+      } // end else
+
+   if (bHigherMoments)
+      {
+      if (m_HigherMoments.size() <= m_nSize)
+         {
+         m_HigherMoments.resize(m_nSize + 1);
+         } // end if
+      m_HigherMoments[m_nSize].Clear();
+      } // end if
+
+   m_Index[nID] = static_cast<int>(m_nSize);
+
+   return (m_Blobs[m_nSize++]);
+
+   } // End of function DBlobMap::Add
+
+/*****************************************************************************
+ *
+ *  DBlobMap::ReserveRuns
+ *
+ *  Give each blob keeping runs its range in the run storage now that the run
+ *  counts are known.
+ *
+ *****************************************************************************/
+
+void DBlobMap::ReserveRuns()
+   {
+   int nTotal = 0;
+   for (size_t i = 0 ; i < m_nSize ; i++)
+      {
+      DBlob& Blob = m_Blobs[i];
+      if (Blob.HasRuns())
+         {
+         Blob.m_nFirstRun = nTotal;
+         nTotal += Blob.m_nRunCount;
+         } // end if
+      } // end for
+
+   m_Runs.resize(nTotal);
+   m_RunFill.assign(m_nSize, 0);
+
+   return;
+
+   } // End of function DBlobMap::ReserveRuns
+
+/*****************************************************************************
+ *
+ *  DBlobMap::StoreRun
+ *
+ *****************************************************************************/
+
+void DBlobMap::StoreRun(const DRun& Run)
+   {
+   int nSlot = m_Index[Run.GetBlob()];
+   const DBlob& Blob = m_Blobs[nSlot];
+   if (Blob.HasRuns())
+      {
+      m_Runs[Blob.m_nFirstRun + m_RunFill[nSlot]++] = Run;
+      } // end if
+
+   return;
+
+   } // End of function DBlobMap::StoreRun
+
+/*****************************************************************************
+ *
+ *  DBlobMap::RemoveSmallBlobs
+ *
+ *  Remove blobs smaller than fMinArea in this map which holds the blobs of
+ *  one color.  The survivors are packed down in order and the removed blobs
+ *  become spares.
+ *
+ *****************************************************************************/
+
+int DBlobMap::RemoveSmallBlobs(double dMinArea)
+   {
+   size_t nKeep = 0;
+
+   for (size_t i = 0 ; i < m_nSize ; i++)
+      {
+      if (m_Blobs[i].GetArea() < dMinArea)
+         {
+         m_Index[m_Blobs[i].GetID()] = -1;
+         } // end if
+      else
+         {
+         if (nKeep != i)
+            {
+            m_Blobs[nKeep].swap(m_Blobs[i]);
+            if (m_Blobs[nKeep].HasHigherMoments())
+               {
+               m_HigherMoments[nKeep] = m_HigherMoments[i];
+               } // end if
+            } // end if
+         m_Index[m_Blobs[nKeep].GetID()] = static_cast<int>(nKeep);
+         nKeep++;
+         } // end else
+      } // end for
+
+   int nCount = static_cast<int>(m_nSize - nKeep);
+   m_nSize = nKeep;
+
+   // Anything smaller than a removed blob went too, so what's left of the
+   // largest blob list is still the largest of the rest
+   m_Largest.erase(std::remove_if(m_Largest.begin(), m_Largest.end(),
+         [this](int nID) { return (find(nID) == end()); }), m_Largest.end());
+
+   return (nCount);
+
+   } // End of function DBlobMap::RemoveSmallBlobs 
+
+/*****************************************************************************
+ *
+ *  DBlobMap::FindLargestBlob
+ *
+ *  Find the largest blob in this category.  Return its ID or -1 if none is
+ *  found.
+ *
+ *****************************************************************************/
+
+int DBlobMap::FindLargestBlob() const
+   {
+   if (m_bLargestValid)
+      {
+      return (m_Largest.empty() ? -1 : m_Largest.front());
+      } // end if
+
+   int nID = -1;
+   double dMaxArea = 0.0;
+
+   for (const_iterator i = begin() ; i != end() ; ++i)
+      {
+      if (i->second.GetArea() > dMaxArea)
+         {
+         dMaxArea = i->second.GetArea();
+         nID = i->first;
+         } // end if
+      } // end for
+
+   return (nID);
+
+   } // End of function DBlobMap::FindLargestBlob 
+
+/*****************************************************************************
+ ************************ Class DBlobs Implementation *************************
+ *****************************************************************************/
+
+/*****************************************************************************
+ *
+ *  DBlobs::FindBlob
+ *
+ *  Find a particular blob by blob ID.  ID is unique across all colors.
+ *
+ *****************************************************************************/
+
+DBlobMap::DSearchPair DBlobs::FindBlob(int nID)
+   {
+   DBlobMap::DSearchPair Result;
+   Result.first = false;
+
+   // Start with 1, 0 is background, and check each color
+   for (size_t c = 1 ; !Result.first && (c < size()) ; c++)
+      {
+      DBlobMap& Map = (*this)[c];
+      Result.second = Map.find(nID);
+      if (Result.second != Map.end())
+         {
+         Result.first = true;
+         } // end if
+      } // end for
+
+   return (Result);
+
+   } // End of function DBlobs::FindBlob 
+
+/*****************************************************************************
+ *
+ *  DBlobs::FindBlob
+ *
+ *  Find a particular blob by blob ID const version.  ID is unique across all
+ *  colors.
+ *
+ *****************************************************************************/
+
+DBlobMap::DConstSearchPair DBlobs::FindBlob(int nID) const
+      {
+   DBlobMap::DConstSearchPair Result;
+   Result.first = false;
+
+   // Start with 1, 0 is background, and check each color
+   for (size_t c = 1 ; !Result.first && (c < size()) ; c++)
+      {
+      const DBlobMap& Map = (*this)[c];
+      Result.second = Map.find(nID);
+      if (Result.second != Map.end())
+         {
+         Result.first = true;
+         } // end if
+      } // end for
+
+   return (Result);
+
+   } // End of function DBlobs::FindBlob 
+
+/*****************************************************************************
+ *
+ *  DBlobs::FindLargestBlobs
+ *
+ *  Find the largest blob for each color category and return the IDs by
+ *  filling in the passed vector.  Element 0 of the array will contain -1 since
+ *  by convention this is the background.  -1 is used to indicate a category
+ *  has no blobs found.
+ *
+ *****************************************************************************/
+
+void DBlobs::FindLargestBlobs(DBlob::DIDVector& Largest) const
+      {
+   Largest.resize(this->size());
+   if (Largest.size() > 0)
+      {
+      // Element 0 is background and has no members
+      Largest[0] = -1;
+
+      // Start with 1, 0 is background, and check each color
+      for (size_t c = 1 ; c < this->size() ; c++)
+         {
+         const DBlobMap& Map = (*this)[c];
+         Largest[c] = Map.FindLargestBlob();
+         } // end for
+      } // end if
+
+   return;
+
+   } // End of function DBlobs::FindLargestBlobs
+
+/*****************************************************************************
+ *
+ *  DBlobs::SetParents
+ *
+ *  Take over the parent of each blob ID and index the children.
+ *
+ *****************************************************************************/
+
+void DBlobs::SetParents(std::vector<int>& Parents)
+   {
+   m_Parents.swap(Parents);
+
+   size_t nIDs = m_Parents.size();
+   m_FirstChild.assign(nIDs + 1, 0);
+   for (int nParent : m_Parents)
+      {
+      if (nParent >= 0)
+         {
+         m_FirstChild[nParent + 1]++;
+         } // end if
+      } // end for
+
+   for (size_t i = 0 ; i < nIDs ; i++)
+      {
+      m_FirstChild[i + 1] += m_FirstChild[i];
+      } // end for
+
+   // Fill from the back of each range so the children end up in ID order
+   m_Children.resize(m_FirstChild[nIDs]);
+   std::vector<int> Fill(m_FirstChild.begin() + 1, m_FirstChild.end());
+   for (int nID = static_cast<int>(nIDs) - 1 ; nID >= 0 ; nID--)
+      {
+      int nParent = m_Parents[nID];
+      if (nParent >= 0)
+         {
+         m_Children[--Fill[nParent]] = nID;
+         } // end if
+      } // end for
+
+   return;
+
+   } // End of function DBlobs::SetParents
+
+/*****************************************************************************
+ *
+ *  DBlobs::ClearTree
+ *
+ *****************************************************************************/
+
+void DBlobs::ClearTree()
+   {
+   m_Parents.clear();
+   m_FirstChild.clear();
+   m_Children.clear();
+
+   return;
+
+   } // End of function DBlobs::ClearTree
+
+/*****************************************************************************
+ *
+ *  DBlobs::PruneTree
+ *
+ *  Take the blobs that are gone out of the containment tree.  Each blob
+ *  that's left moves up to its nearest ancestor that's left.
+ *
+ *****************************************************************************/
+
+void DBlobs::PruneTree()
+   {
+   if (m_Parents.empty())
+      {
+      return;
+      } // end if
+
+   std::vector<char> Kept(m_Parents.size(), 0);
+   for (size_t c = 1 ; c < this->size() ; c++)
+      {
+      for (const auto& Entry : (*this)[c])
+         {
+         if (Entry.first < static_cast<int>(Kept.size()))
+            {
+            Kept[Entry.first] = 1;
+            } // end if
+         } // end for
+      } // end for
+
+   std::vector<int> Parents(m_Parents.size(), -1);
+   for (size_t nID = 0 ; nID < m_Parents.size() ; nID++)
+      {
+      if (Kept[nID])
+         {
+         int nParent = m_Parents[nID];
+         while ((nParent >= 0) && !Kept[nParent])
+            {
+            nParent = m_Parents[nParent];
+            } // end while
+         Parents[nID] = nParent;
+         } // end if
+      } // end for
+   SetParents(Parents);
+
+   return;
+
+   } // End of function DBlobs::PruneTree
+
+/*****************************************************************************
+ *
+ *  DBlobs::GetChildren
+ *
+ *****************************************************************************/
+
+void DBlobs::GetChildren(int nID, DBlob::DIDVector& Children) const
+   {
+   Children.clear();
+   if ((nID >= 0) && (nID < static_cast<int>(m_Parents.size())))
+      {
+      Children.assign(m_Children.begin() + m_FirstChild[nID],
+            m_Children.begin() + m_FirstChild[nID + 1]);
+      } // end if
+
+   return;
+
+   } // End of function DBlobs::GetChildren 
+
+/*****************************************************************************
+ *
+ *  DBlobs::RemoveSmallBlobs
+ *
+ *  Remove blobs smaller than the specified area.  Return the number of blobs
+ *  removed.
+ *
+ *****************************************************************************/
+
+int DBlobs::RemoveSmallBlobs(double dMinArea)
+   {
+   int nCount = 0;
+
+   // Start with 1, 0 is background, and check each color
+   for (size_t c = 1 ; c < this->size() ; c++)
+      {
+      DBlobMap& Map = (*this)[c];
+      nCount += Map.RemoveSmallBlobs(dMinArea);
+      } // end for
+
+   if (nCount > 0)
+      {
+      PruneTree();
+      } // end if
+
+   return (nCount);
+
+   } // End of function DBlobs::RemoveSmallBlobs 
+
+/*****************************************************************************
+ *
+ *  DBlobs::RemoveSmallBlobs
+ *
+ *  Remove blobs of the specified color smaller than the specified area.
+ *  Return the number of blobs removed.
+ *
+ *****************************************************************************/
+
+int DBlobs::RemoveSmallBlobs(int nColor, double dMinArea)
+   {
+   DBlobMap& Map = (*this)[nColor];
+   int nCount = Map.RemoveSmallBlobs(dMinArea);
+   if (nCount > 0)
+      {
+      PruneTree();
+      } // end if
+
+   return (nCount);
+
+   } // End of function DBlobs::RemoveSmallBlobs 
+
+/*****************************************************************************
+ *
+ *  DBlobs::DisplayBlobs
+ *
+ *  Display all the blobs of one color and optionally their decoration.
+ *
+ *****************************************************************************/
+
+void DBlobs::DisplayBlobs(DBlobRenderer* pRenderer, const DBlobMap& BlobMap,
+      cv::Scalar BlobColor, int nDisplay /* = DBlob:: eBlob */,
+      cv::Scalar CHColor /* = cv::Scalar(255, 255, 255) */,
+      int nThickness /* = 1 */) const
+      {
+   for (DBlobMap::const_iterator b = BlobMap.begin() ; b != BlobMap.end()
+         ; ++b)
+      {
+      b->second.Display(pRenderer, BlobMap.GetRuns(b->second), BlobColor,
+            nDisplay, CHColor, nThickness);
+      } // end for
+
+   return;
+
+   } // End of function DBlobs::DisplayBlobs 
+
+/*****************************************************************************
+ *
+ *  DBlobs::DisplayBlobs
+ *
+ *  Display all the blobs and optionally their decoration.
+ *
+ *****************************************************************************/
+
+void DBlobs::DisplayBlobs(DBlobRenderer* pRenderer,
+      const DBlobColor::Vector& Colors, int nDisplay /* = DBlobs::eBlob */,
+      cv::Scalar CHColor /* = cv::Scalar(255, 255, 255) */,
+      int nThickness /* = 1 */) const
+      {
+   for (size_t c = 1 ; c < size() ; c++)
+      {
+      DisplayBlobs(pRenderer, (*this)[c], Colors[c].GetDisplayColor(), nDisplay,
+            CHColor, nThickness);
+      } // end for
+
+   return;
+
+   } // End of function DBlobs::DisplayBlobs 
+
+/*****************************************************************************
+ *
+ *  DBlobs::DisplayBlob
+ *
+ *****************************************************************************/
+
+bool DBlobs::DisplayBlob(DBlobRenderer* pRenderer, int nBlobID, cv::Scalar BlobColor,
+      int nDisplay /* = DBlob::eBlob */,
+      cv::Scalar CHColor /* = cv::Scalar(255, 255, 255) */,
+      int nThickness /* = 1 */) const
+      {
+   DBlobMap::DConstSearchPair Pair = FindBlob(nBlobID);
+   if (Pair.first)
+      {
+      const DBlob& Blob = Pair.second->second;
+      Blob.Display(pRenderer, (*this)[Blob.GetType()].GetRuns(Blob),
+            BlobColor, nDisplay, CHColor, nThickness);
+      } // end if
+
+   return (Pair.first);
+
+   } // End of function DBlobs::DisplayBlob 
+
+/*****************************************************************************
+ *
+ *  DBlobs::DisplayBlobs
+ *
+ *  Display blobs from a vector of IDs.  Optionally, display their decoration.
+ *  Return a count of the blobs actually displayed.
+ *
+ *****************************************************************************/
+
+int DBlobs::DisplayBlobs(DBlobRenderer* pRenderer, const DBlob::DIDVector& BlobIDs,
+      cv::Scalar BlobColor /* = cv::Scalar(255, 0, 0) */,
+      int nDisplay /* = DBlobs::eBlob */,
+      cv::Scalar CHColor /* = cv::Scalar(255, 255, 255) */,
+      int nThickness /* = 1 */) const
+      {
+   int nCount = 0;
+   for (auto& BlobID : BlobIDs)
+      {
+      if (DisplayBlob(pRenderer, BlobID, BlobColor, nDisplay, CHColor,
+            nThickness))
+         {
+         nCount++;
+         } // end if
+      } // end for
+
+   return (nCount);
+
+   } // End of function DBlobs::DisplayBlobs 
+
+/*****************************************************************************
+ *
+ *  DBlobs::DisplayLargestBlobs
+ *
+ *  Display the largest blob of each color in the color's display color.
+ *  Returns the count of blobs displayed.
+ *
+ *****************************************************************************/
+
+int DBlobs::DisplayLargestBlobs(DBlobRenderer* pRenderer,
+      const DBlobColor::Vector& Colors, int nDisplay /* = DBlob::eBlob */,
+      cv::Scalar CHColor /* = cv::Scalar(255, 255, 255) */,
+      int nThickness /* = 1 */) const
+   {
+   int nCount = 0;
+   DBlob::DIDVector Largest;
+
+   FindLargestBlobs(Largest);
+   for (size_t i = 1 ; (i < Largest.size()) && (i < Colors.size()) ; i++)
+      {
+      if (Largest[i] != -1)
+         {
+         const DBlobMap& BlobMap = (*this)[i];
+         const DBlob& Blob = BlobMap.find(Largest[i])->second;
+         Blob.Display(pRenderer, BlobMap.GetRuns(Blob), Colors[i].GetDisplayColor(),
+               nDisplay, CHColor, nThickness);
+         nCount++;
+         } // end if
+      } // end for
+
+   return (nCount);
+
+   } // End of function DBlobs::DisplayLargestBlobs 
+
+/*****************************************************************************
+ ******************* Class DColorBlobFinder Implementation ********************
+ *****************************************************************************/
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::DColorBlobFinder
+ *
+ *****************************************************************************/
+
+DColorBlobFinder::DColorBlobFinder(DBlobColor::Vector* pColors)
+   {
+   Init();
+
+   m_pColors = pColors;
+
+   return;
+
+   } // End of function DColorBlobFinder::DColorBlobFinder 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::Init
+ *
+ *  Handle common initialization.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::Init()
+   {
+   m_pColors = nullptr;
+   SetImage(nullptr);
+   m_eClassifier = eClassifyLoop;
+   m_eActiveClassifier = eClassifyLoop;
+   m_nMaxColors = 64;
+   m_bStreaming = true;
+   m_bIncremental = false;
+   m_nTileSize = 32;
+   m_bTilesValid = false;
+   m_eTileFormat = eBGR24;
+   m_nChangedTiles = 0;
+   m_bValidateIncremental = false;
+   m_nValidationErrors = 0;
+   m_bLinearOverlap = true;
+   m_bStoreRuns = true;
+   m_bHigherMoments = false;
+   m_bContainment = false;
+   m_bColorMatValid = false;
+   m_pWindows = nullptr;
+   m_bCompiled = false;
+   m_bSIMDUsable = false;
+
+   // The CPU doesn't change so only ask once
+   static const DBlobSIMD::ELevel eLevel = DBlobSIMD::DetectLevel();
+   m_eSIMDLevel = eLevel;
+
+   for (auto& Masks : m_ChannelMasks)
+      {
+      std::fill(std::begin(Masks), std::end(Masks), 0);
+      } // end for
+
+   return;
+
+   } // End of function DColorBlobFinder::Init 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::ConvertRGBPixel
+ *
+ *  Convert the RGB pixel from the original image to the color space to be
+ *  used for testing.
+ *
+ *  This default implementation simply does a copy so testing would be RGB.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::ConvertRGBPixel(const unsigned char RGBPixel[3],
+      unsigned char Pixel[3]) const
+   {
+   for (int i = 0 ; i < 3 ; i++)
+      {
+      Pixel[i] = RGBPixel[i];
+      } // end for
+
+   return;
+
+   } // End of function DColorBlobFinder::ConvertRGBPixel 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::ConvertRGBRow
+ *
+ *  Convert a row of image pixels to the testing color space as three planes.
+ *  Must give the same result as ConvertRGBPixel.
+ *
+ *  This default implementation splits out the channels so testing would be
+ *  RGB.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::ConvertRGBRow(const unsigned char* pRow,
+      EPixelFormat eFormat, int nCols, unsigned char* const pPlanes[3]) const
+   {
+   WithLayout(eFormat, [=](auto Layout)
+      {
+      using DLayout = decltype(Layout);
+      const unsigned char* pPixel = pRow;
+      for (int c = 0 ; c < nCols ; c++, pPixel += DLayout::nSize)
+         {
+         pPlanes[0][c] = pPixel[DLayout::nBlue];
+         pPlanes[1][c] = pPixel[DLayout::nGreen];
+         pPlanes[2][c] = pPixel[DLayout::nRed];
+         } // end for
+      });
+
+   return;
+
+   } // End of function DColorBlobFinder::ConvertRGBRow 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::BuildHueTables
+ *
+ *  Build the tables for the fixed point hue conversion from ConvertRGBPixel.
+ *  Only 256 grey levels and 32K max, min pairs are converted.
+ *
+ *****************************************************************************/
+
+DBlobSIMD::DHueTables DColorBlobFinder::BuildHueTables() const
+   {
+   DBlobSIMD::DHueTables Tables;
+
+   const int nRGB[3] = { DCVImage::EColor::eRed, DCVImage::EColor::eGreen,
+         DCVImage::EColor::eBlue };
+
+   unsigned char Pixel[3];
+   unsigned char Value[3];
+   for (int v = 0 ; v < 256 ; v++)
+      {
+      Pixel[0] = Pixel[1] = Pixel[2] = static_cast<unsigned char>(v);
+      ConvertRGBPixel(Pixel, Value);
+      Tables.Grey[v] = Value[0];
+      } // end for
+
+   Tables.MaxMin[0].assign(256 * 256, 0);
+   Tables.MaxMin[1].assign(256 * 256, 0);
+   for (int nMax = 0 ; nMax < 256 ; nMax++)
+      {
+      for (int nMin = 0 ; nMin <= nMax ; nMin++)
+         {
+         Pixel[nRGB[0]] = static_cast<unsigned char>(nMax);
+         Pixel[nRGB[1]] = Pixel[nRGB[2]] = static_cast<unsigned char>(nMin);
+         ConvertRGBPixel(Pixel, Value);
+         Tables.MaxMin[0][(nMax << 8) | nMin] = Value[1];
+         Tables.MaxMin[1][(nMax << 8) | nMin] = Value[2];
+         } // end for
+      } // end for
+
+   return (Tables);
+
+   } // End of function DColorBlobFinder::BuildHueTables 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::AllocateMemory
+ *
+ *  Allocate or reallocate the memory necessary to support finding the blobs.
+ *  The runs go in Bands.
+ *
+ *****************************************************************************/
+
+bool DColorBlobFinder::AllocateMemory(std::vector<DBand>& Bands)
+   {
+   BuildSpans();
+
+   // (Re)Create the matrix of pixel color categories for the part of the
+   // image being searched.  Streaming leaves that to GetCategories.  The
+   // incremental mode keeps the last frame's matrix unless the size changed.
+   m_bColorMatValid = false;
+   if (UsingTiles())
+      {
+      size_t nImageBytes = static_cast<size_t>(m_rcSpans.height) * m_rcSpans.width
+            * m_Image.nPixelSize;
+      if ((m_ColorMat.GetNumRows() != m_rcSpans.height)
+            || (m_ColorMat.GetNumCols() != m_rcSpans.width)
+            || (m_PrevPixels.size() != nImageBytes)
+            || (m_eTileFormat != m_Image.eFormat))
+         {
+         m_ColorMat.Resize(m_rcSpans.height, m_rcSpans.width);
+         m_PrevPixels.resize(nImageBytes);
+         m_eTileFormat = m_Image.eFormat;
+         m_bTilesValid = false;
+         } // end if
+      m_ptColorMat = cv::Point(0, 0);
+      m_CachedRuns.resize(m_rcSpans.height);
+      m_ChangedTiles.resize(static_cast<size_t>((m_rcSpans.height + m_nTileSize - 1)
+            / m_nTileSize) * ((m_rcSpans.width + m_nTileSize - 1) / m_nTileSize));
+      } // end if
+   else
+      {
+      // Anything else may leave the matrix for another image
+      m_bTilesValid = false;
+      if (!m_bStreaming)
+         {
+         m_ColorMat.Resize(m_rcSpans.height, m_rcSpans.width);
+         m_ptColorMat = m_rcSpans.tl();
+         } // end if
+      } // end else
+
+   // Several bands per thread keeps the threads busy when some bands have
+   // more colored pixels than others.  Rows outside the windows are skipped.
+   // Incremental bands hold whole rows of tiles.
+   int nRowStep = UsingTiles() ? m_nTileSize : 1;
+   int nRows = m_rcSpans.height;
+   int nSteps = (nRows + nRowStep - 1) / nRowStep;
+   int nBands = std::max(1, std::min(nSteps, 4 * GetThreadCount()));
+   if (GetThreadCount() == 1)
+      {
+      nBands = 1;
+      } // end if
+
+   Bands.resize(nBands);
+   for (int b = 0 ; b < nBands ; b++)
+      {
+      DBand& Band = Bands[b];
+      Band.nFirstRow = m_rcSpans.y + std::min(nRows, nRowStep
+            * static_cast<int>(static_cast<int64_t>(nSteps) * b / nBands));
+      Band.nEndRow = m_rcSpans.y + std::min(nRows, nRowStep
+            * static_cast<int>(static_cast<int64_t>(nSteps) * (b + 1) / nBands));
+      Band.Planes.resize(3 * m_rcSpans.width);
+      Band.ColorRow.resize(m_bStreaming ? m_rcSpans.width : 0);
+      } // end for
+
+   return (true);
+
+   } // End of function DColorBlobFinder::AllocateMemory 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::Find
+ *
+ *  The primary entry point of find color blobs.
+ *
+ *****************************************************************************/
+
+bool DColorBlobFinder::Find()
+   {
+   bool bRet = FindBandRuns(m_Bands);
+   if (bRet)
+      {
+      ClearBlobs();
+      LabelRuns(m_Bands, m_Image.nCols, true);
+      } // end if
+
+   return (bRet);
+
+   } // End of function DColorBlobFinder::Find 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::FindBandRuns
+ *
+ *  Categorize the pixels of m_Image and extract the runs into Bands, which
+ *  is everything Find does before labeling.
+ *
+ *****************************************************************************/
+
+bool DColorBlobFinder::FindBandRuns(std::vector<DBand>& Bands)
+   {
+   bool bRet = (m_Image.pData != nullptr) && (m_pColors != nullptr)
+         && AllocateMemory(Bands);
+   if (bRet)
+      {
+      if (UsingTiles())
+         {
+         PrepareClassifier();
+         m_nChangedTiles = 0;
+         ForEachBand(Bands, [this](DBand& Band) { UpdateTiles(Band); });
+         m_nChangedTiles = static_cast<int>(std::count(m_ChangedTiles.begin(),
+               m_ChangedTiles.end(), 1));
+         m_bTilesValid = true;
+         m_bColorMatValid = true;
+         if (m_bValidateIncremental)
+            {
+            ValidateTiles(Bands);
+            } // end if
+         } // end if
+      else if (m_bStreaming)
+         {
+         PrepareClassifier();
+         ForEachBand(Bands, [this](DBand& Band) { StreamRuns(Band); });
+         } // end if
+      else
+         {
+         CategorizeBands(Bands);
+         ForEachBand(Bands, [this](DBand& Band) { ExtractRuns(Band); });
+         } // end else
+      } // end if
+
+   return (bRet);
+
+   } // End of function DColorBlobFinder::FindBandRuns 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::ClearBlobs
+ *
+ *  Empty the blobs before labeling a frame, one map per color.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::ClearBlobs()
+   {
+   for (auto& Blob : m_Blobs)
+      {
+      Blob.clear();
+      } // end for
+   m_Blobs.ClearTree();
+
+   m_Blobs.resize(m_pColors->size());
+
+   return;
+
+   } // End of function DColorBlobFinder::ClearBlobs 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::Find
+ *
+ *  The external find entry point.  Assumes the finder is initialized and
+ *  ready to process an image.
+ *
+ *****************************************************************************/
+
+bool DColorBlobFinder::Find(DCVImage* pImage)
+   {
+   SetImage(pImage);
+
+   return (Find());
+
+   } // End of function DColorBlobFinder::Find 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::Find
+ *
+ *  Find the blobs in a buffer of pixels in one of the supported formats,
+ *  categorizing them where they are.
+ *
+ *****************************************************************************/
+
+bool DColorBlobFinder::Find(const uint8_t* pData, int nWidth, int nHeight,
+      size_t nStride, EPixelFormat eFormat)
+   {
+   SetImage(pData, nWidth, nHeight, nStride, eFormat);
+
+   return (Find());
+
+   } // End of function DColorBlobFinder::Find 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::SetImage
+ *
+ *  Search a DCVImage.  8 bit images of 3, 4 and 1 channels are eBGR24,
+ *  eBGRA32 and eGray8.  Any other image leaves no image and Find fails, so a
+ *  2 channel frame isn't taken for YUYV, which might be some other layout.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::SetImage(DCVImage* pImage)
+   {
+   int nType = ((pImage != nullptr) && (pImage->GetNumRows() > 0))
+         ? pImage->type() : -1;
+   if ((nType == CV_8UC3) || (nType == CV_8UC4) || (nType == CV_8UC1))
+      {
+      EPixelFormat eFormat = (nType == CV_8UC4) ? eBGRA32
+            : ((nType == CV_8UC1) ? eGray8 : eBGR24);
+      SetImage(pImage->GetRow(0), pImage->GetNumCols(), pImage->GetNumRows(),
+            pImage->step, eFormat);
+      } // end if
+   else
+      {
+      SetImage(nullptr, 0, 0, 0, eBGR24);
+      } // end else
+
+   return;
+
+   } // End of function DColorBlobFinder::SetImage 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::SetImage
+ *
+ *  Search the caller's pixels.  Anything that doesn't describe an image,
+ *  rows overlapping say, leaves no image and Find fails.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::SetImage(const uint8_t* pData, int nWidth, int nHeight,
+      size_t nStride, EPixelFormat eFormat)
+   {
+   m_Image.nPixelSize = GetPixelSize(eFormat);
+   // A YUYV row ends on a whole pair
+   size_t nRowBytes = static_cast<size_t>((eFormat == eYUYV) ? (nWidth + 1) & ~1 : nWidth)
+         * m_Image.nPixelSize;
+   bool bValid = (pData != nullptr) && (nWidth > 0) && (nHeight > 0)
+         && (nStride >= nRowBytes);
+
+   m_Image.pData = bValid ? pData : nullptr;
+   m_Image.nRows = bValid ? nHeight : 0;
+   m_Image.nCols = bValid ? nWidth : 0;
+   m_Image.nStride = nStride;
+   m_Image.eFormat = eFormat;
+   m_Image.pChroma = (bValid && (eFormat == eNV12)) ? pData + nHeight * nStride : nullptr;
+
+   return;
+
+   } // End of function DColorBlobFinder::SetImage 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::Find
+ *
+ *  Find the blobs inside the windows only.  Goes through the virtual Find
+ *  so derived classes get to prepare as usual.
+ *
+ *****************************************************************************/
+
+bool DColorBlobFinder::Find(DCVImage* pImage,
+      const std::vector<cv::Rect>& Windows)
+   {
+   m_pWindows = &Windows;
+   bool bRet = Find(pImage);
+   m_pWindows = nullptr;
+
+   return (bRet);
+
+   } // End of function DColorBlobFinder::Find 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::Find
+ *
+ *  Find the blobs inside one window, such as a region of interest.
+ *
+ *****************************************************************************/
+
+bool DColorBlobFinder::Find(DCVImage* pImage, const cv::Rect& rcWindow)
+   {
+   m_SingleWindow.assign(1, rcWindow);
+
+   return (Find(pImage, m_SingleWindow));
+
+   } // End of function DColorBlobFinder::Find 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::FindFrameRuns
+ *
+ *  The first half of Find.  Categorize the image, inside the windows if
+ *  there are any, and leave the runs in Runs for LabelFrameRuns.
+ *
+ *****************************************************************************/
+
+bool DColorBlobFinder::FindFrameRuns(DCVImage* pImage, DFrameRuns& Runs,
+      const std::vector<cv::Rect>* pWindows /* = nullptr */)
+   {
+   SetImage(pImage);
+   m_pWindows = pWindows;
+   bool bRet = FindBandRuns(Runs.Bands);
+   m_pWindows = nullptr;
+
+   Runs.nNumCols = bRet ? m_Image.nCols : 0;
+
+   return (bRet);
+
+   } // End of function DColorBlobFinder::FindFrameRuns 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::LabelFrameRuns
+ *
+ *  The second half of Find.  Join the runs FindFrameRuns left in Runs into
+ *  the finder's blobs.  The bands are labeled in order on the calling
+ *  thread since the thread pool may be busy categorizing the next frame.
+ *
+ *****************************************************************************/
+
+bool DColorBlobFinder::LabelFrameRuns(DFrameRuns& Runs)
+   {
+   bool bRet = (m_pColors != nullptr) && (Runs.nNumCols > 0);
+   if (bRet)
+      {
+      ClearBlobs();
+      LabelRuns(Runs.Bands, Runs.nNumCols, false);
+      } // end if
+
+   return (bRet);
+
+   } // End of function DColorBlobFinder::LabelFrameRuns 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::BuildSpans
+ *
+ *  Work out the columns of each row to search.  Windows meeting or
+ *  overlapping in a row become one span so no run is split between them.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::BuildSpans()
+   {
+   int nRows = m_Image.nRows;
+   int nCols = m_Image.nCols;
+
+   m_Spans.clear();
+   m_RowSpans.resize(nRows + 1);
+
+   if (m_pWindows == nullptr)
+      {
+      m_Spans.assign(nRows, { 0, nCols });
+      for (int r = 0 ; r <= nRows ; r++)
+         {
+         m_RowSpans[r] = r;
+         } // end for
+      m_rcSpans = cv::Rect(0, 0, nCols, nRows);
+      } // end if
+   else
+      {
+      std::vector<cv::Rect> Windows;
+      cv::Rect rcImage(0, 0, nCols, nRows);
+      for (const auto& rcWindow : *m_pWindows)
+         {
+         cv::Rect rcClipped = rcWindow & rcImage;
+         if (rcClipped.area() > 0)
+            {
+            Windows.push_back(rcClipped);
+            } // end if
+         } // end for
+
+      std::sort(Windows.begin(), Windows.end(), [](const cv::Rect& rc1,
+            const cv::Rect& rc2) { return (rc1.x < rc2.x); });
+
+      m_rcSpans = cv::Rect();
+      for (const auto& rcWindow : Windows)
+         {
+         m_rcSpans = (m_rcSpans.area() > 0) ? (m_rcSpans | rcWindow) : rcWindow;
+         } // end for
+
+      for (int r = 0 ; r < nRows ; r++)
+         {
+         size_t nFirst = m_Spans.size();
+         m_RowSpans[r] = nFirst;
+         for (const auto& rcWindow : Windows)
+            {
+            if ((r >= rcWindow.y) && (r < rcWindow.y + rcWindow.height))
+               {
+               int nEndCol = rcWindow.x + rcWindow.width;
+               if ((m_Spans.size() > nFirst) && (rcWindow.x <= m_Spans.back().nEndCol))
+                  {
+                  m_Spans.back().nEndCol = std::max(m_Spans.back().nEndCol, nEndCol);
+                  } // end if
+               else
+                  {
+                  m_Spans.push_back({ rcWindow.x, nEndCol });
+                  } // end else
+               } // end if
+            } // end for
+         } // end for
+      m_RowSpans[nRows] = m_Spans.size();
+      } // end else
+
+   return;
+
+   } // End of function DColorBlobFinder::BuildSpans 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::CategorizePixels
+ *
+ *  Apply the color thresholds and categorize each pixel into background or
+ *  color category.  Background is always category zero.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::CategorizePixels()
+   {
+   CategorizeBands(m_Bands);
+
+   return;
+
+   } // End of function DColorBlobFinder::CategorizePixels 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::CategorizeBands
+ *
+ *  Categorize the rows of each band into the category matrix.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::CategorizeBands(std::vector<DBand>& Bands)
+   {
+   PrepareClassifier();
+
+   // Check each pixel in the input and catgorize it as to color
+   ForEachBand(Bands, [this](DBand& Band)
+      {
+      for (int r = Band.nFirstRow ; r < Band.nEndRow ; r++)
+         {
+         for (size_t s = m_RowSpans[r] ; s < m_RowSpans[r + 1] ; s++)
+            {
+            const DSpan& Span = m_Spans[s];
+            CategorizeImageRow(r, Span.nFirstCol,
+                  m_ColorMat[r - m_ptColorMat.y] + (Span.nFirstCol - m_ptColorMat.x),
+                  Span.nEndCol - Span.nFirstCol, Band.Planes.data());
+            } // end for
+         } // end for
+      });
+
+   // Outside the windows is left as it was
+   m_bColorMatValid = (m_pWindows == nullptr);
+
+   return;
+
+   } // End of function DColorBlobFinder::CategorizeBands 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::SetThreadCount
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::SetThreadCount(int nThreads)
+   {
+   if (nThreads != GetThreadCount())
+      {
+      m_pThreadPool.reset((nThreads > 1) ? new DThreadPool(nThreads) : nullptr);
+      } // end if
+
+   return;
+
+   } // End of function DColorBlobFinder::SetThreadCount 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::ForEachBand
+ *
+ *  Run the task on every one of Bands, spread across the thread pool if
+ *  there is one.  Bands are independent so the task must only touch its own band's
+ *  rows and storage.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::ForEachBand(std::vector<DBand>& Bands,
+      const std::function<void (DBand&)>& Task)
+   {
+   if (m_pThreadPool != nullptr)
+      {
+      m_pThreadPool->Run(static_cast<int>(Bands.size()),
+            [&](int nBand) { Task(Bands[nBand]); });
+      } // end if
+   else
+      {
+      for (auto& Band : Bands)
+         {
+         Task(Band);
+         } // end for
+      } // end else
+
+   return;
+
+   } // End of function DColorBlobFinder::ForEachBand 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::CategorizeRow
+ *
+ *  Categorize nCols pixels of a row in the given format using the current
+ *  classifier.  pBuffer is scratch space for 3 * nCols converted pixel
+ *  values.  Each format has a kernel of its own so the pixels are never
+ *  converted to a DCVImage's layout first.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::CategorizeRow(const unsigned char* pRow,
+      EPixelFormat eFormat, COLORTYPE* pColorRow, int nCols,
+      unsigned char* pBuffer) const
+   {
+   if (eFormat == eGray8)
+      {
+      // There are only 256 grey levels and they're categorized up front
+      for (int c = 0 ; c < nCols ; c++)
+         {
+         pColorRow[c] = m_GreyLookup[pRow[c]];
+         } // end for
+      } // end if
+   else if (m_eActiveClassifier == eClassifyLookup24)
+      {
+      const COLORTYPE* pLookup = m_Lookup.data();
+      WithLayout(eFormat, [=](auto Layout)
+         {
+         using DLayout = decltype(Layout);
+         const unsigned char* pPixel = pRow;
+         for (int c = 0 ; c < nCols ; c++, pPixel += DLayout::nSize)
+            {
+            pColorRow[c] = pLookup[(pPixel[DLayout::nBlue] << 16)
+                  | (pPixel[DLayout::nGreen] << 8) | pPixel[DLayout::nRed]];
+            } // end for
+         });
+      } // end else if
+   else if (m_eActiveClassifier == eClassifyLookup565)
+      {
+      const COLORTYPE* pLookup = m_Lookup.data();
+      WithLayout(eFormat, [=](auto Layout)
+         {
+         using DLayout = decltype(Layout);
+         const unsigned char* pPixel = pRow;
+         for (int c = 0 ; c < nCols ; c++, pPixel += DLayout::nSize)
+            {
+            pColorRow[c] = pLookup[((pPixel[DLayout::nBlue] >> 3) << 11)
+                  | ((pPixel[DLayout::nGreen] >> 2) << 5) | (pPixel[DLayout::nRed] >> 3)];
+            } // end for
+         });
+      } // end else if
+   else
+      {
+      unsigned char* const pPlanes[3] = { pBuffer, pBuffer + nCols,
+            pBuffer + 2 * nCols };
+      int nStart = 0;
+
+      bool bSIMD = (m_eActiveClassifier == eClassifySIMD) && m_bSIMDUsable;
+      if (bSIMD && (GetColorScheme() == DBlobTracker::eRGB))
+         {
+         // RGB is tested in place, the bitmask test finishes the row
+         int nBGR[3];
+         GetBGROffsets(eFormat, nBGR);
+         nStart = DBlobSIMD::CategorizeRow(m_eSIMDLevel, pRow,
+               GetPixelSize(eFormat), nBGR, pColorRow, nCols, m_SIMDRanges);
+         unsigned char* const pTail[3] = { pPlanes[0] + nStart,
+               pPlanes[1] + nStart, pPlanes[2] + nStart };
+         ConvertRGBRow(pRow + nStart * GetPixelSize(eFormat), eFormat,
+               nCols - nStart, pTail);
+         } // end if
+      else
+         {
+         // Convert the RGB image pixels to the testing color space
+         ConvertRGBRow(pRow, eFormat, nCols, pPlanes);
+         if (bSIMD)
+            {
+            nStart = DBlobSIMD::CategorizePlanes(m_eSIMDLevel, pPlanes, pColorRow,
+                  nCols, m_SIMDRanges);
+            } // end if
+         } // end else
+
+      if (m_eActiveClassifier == eClassifyLoop)
+         {
+         for (int c = 0 ; c < nCols ; c++)
+            {
+            // Set the pixel to background as a default
+            pColorRow[c] = 0;
+
+            unsigned char Pixel[3] = { pPlanes[0][c], pPlanes[1][c], pPlanes[2][c] };
+
+            // Check each color.  No distance metric is used.
+            // First match wins!
+            for (size_t i = 1 ; i < m_pColors->size() ; i++)
+               {
+               if ((*m_pColors)[i].ComparePixel(Pixel))
+                  {
+                  pColorRow[c] = static_cast<COLORTYPE>(i);
+                  break;
+                  } // end if
+               } // end for
+            } // end for
+         } // end if
+      else
+         {
+         for (int c = nStart ; c < nCols ; c++)
+            {
+            unsigned char Pixel[3] = { pPlanes[0][c], pPlanes[1][c], pPlanes[2][c] };
+            pColorRow[c] = ClassifyPixel(Pixel);
+            } // end for
+         } // end else
+      } // end else
+
+   return;
+
+   } // End of function DColorBlobFinder::CategorizeRow
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::CategorizeImageRow
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::CategorizeImageRow(int nRow, int nFirstCol,
+      COLORTYPE* pColorRow, int nCols, unsigned char* pBuffer) const
+   {
+   if (IsYCbCrFormat(m_Image.eFormat))
+      {
+      CategorizeYCbCrRow(nRow, nFirstCol, pColorRow, nCols, pBuffer);
+      } // end if
+   else
+      {
+      CategorizeRow(m_Image.GetRow(nRow) + nFirstCol * m_Image.nPixelSize,
+            m_Image.eFormat, pColorRow, nCols, pBuffer);
+      } // end else
+
+   return;
+
+   } // End of function DColorBlobFinder::CategorizeImageRow
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::CategorizeYCbCrRow
+ *
+ *  Categorize part of a row of a YUYV or NV12 image.  A finder testing
+ *  YCbCr uses the pixels as they are.  Each pair's chroma is looked up in
+ *  the channel masks once for both pixels, whatever the classifier short of
+ *  the per color test since the masks are exact and the lookup tables and
+ *  SIMD ranges are indexed by BGR.  Other finders see the pixels converted
+ *  to BGR, as they would in a converted frame.  The columns are counted
+ *  from the left edge of the image so the pairs line up.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::CategorizeYCbCrRow(int nRow, int nFirstCol,
+      COLORTYPE* pColorRow, int nCols, unsigned char* pBuffer) const
+   {
+   const unsigned char* pLuma = m_Image.GetRow(nRow);
+   const unsigned char* pChroma = (m_Image.eFormat == eNV12)
+         ? m_Image.GetChromaRow(nRow) : pLuma + 1;
+   int nEndCol = nFirstCol + nCols;
+   bool bYCbCr = (GetColorScheme() == DBlobTracker::eYCbCr);
+
+   if (bYCbCr && (m_eActiveClassifier != eClassifyLoop))
+      {
+      WithYCbCrLayout(m_Image.eFormat, [=](auto Layout)
+         {
+         using DLayout = decltype(Layout);
+         COLORTYPE* pColor = pColorRow - nFirstCol;
+         int c = nFirstCol;
+         while (c < nEndCol)
+            {
+            const unsigned char* pPair = pChroma + (c >> 1) * DLayout::nPairSize;
+            uint64_t nChroma = m_ChannelMasks[1][pPair[0]]
+                  & m_ChannelMasks[2][pPair[DLayout::nCr]];
+            int nPairEnd = std::min((c | 1) + 1, nEndCol);
+            for ( ; c < nPairEnd ; c++)
+               {
+               uint64_t nMask = m_ChannelMasks[0][pLuma[c * DLayout::nLumaSize]] & nChroma;
+               pColor[c] = (nMask != 0) ? static_cast<COLORTYPE>(LowestBit(nMask) + 1) : 0;
+               } // end for
+            } // end while
+         });
+      } // end if
+   else
+      {
+      // Spread the chroma over the pixels as three planes
+      unsigned char* const pPlanes[3] = { pBuffer, pBuffer + nCols,
+            pBuffer + 2 * nCols };
+      WithYCbCrLayout(m_Image.eFormat, [=](auto Layout)
+         {
+         using DLayout = decltype(Layout);
+         for (int c = nFirstCol ; c < nEndCol ; c++)
+            {
+            const unsigned char* pPair = pChroma + (c >> 1) * DLayout::nPairSize;
+            pPlanes[0][c - nFirstCol] = pLuma[c * DLayout::nLumaSize];
+            pPlanes[1][c - nFirstCol] = pPair[0];
+            pPlanes[2][c - nFirstCol] = pPair[DLayout::nCr];
+            } // end for
+         });
+
+      if (bYCbCr)
+         {
+         for (int c = 0 ; c < nCols ; c++)
+            {
+            pColorRow[c] = 0;
+
+            unsigned char Pixel[3] = { pPlanes[0][c], pPlanes[1][c], pPlanes[2][c] };
+            for (size_t i = 1 ; i < m_pColors->size() ; i++)
+               {
+               if ((*m_pColors)[i].ComparePixel(Pixel))
+                  {
+                  pColorRow[c] = static_cast<COLORTYPE>(i);
+                  break;
+                  } // end if
+               } // end for
+            } // end for
+         } // end if
+      else
+         {
+         // Through BGR in pieces small enough for the stack, which keeps
+         // this safe to call from several threads
+         const int nPiece = 256;
+         unsigned char BGRRow[3 * nPiece];
+         unsigned char Buffer[3 * nPiece];
+         for (int nFirst = 0 ; nFirst < nCols ; nFirst += nPiece)
+            {
+            int nPieceCols = std::min(nPiece, nCols - nFirst);
+            for (int c = 0 ; c < nPieceCols ; c++)
+               {
+               const unsigned char YCbCr[3] = { pPlanes[0][nFirst + c],
+                     pPlanes[1][nFirst + c], pPlanes[2][nFirst + c] };
+               ConvertYCbCrPixel(YCbCr, &BGRRow[3 * c]);
+               } // end for
+
+            CategorizeRow(BGRRow, eBGR24, pColorRow + nFirst, nPieceCols, Buffer);
+            } // end for
+         } // end else
+      } // end else
+
+   return;
+
+   } // End of function DColorBlobFinder::CategorizeYCbCrRow
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::BuildChannelMasks
+ *
+ *  Evaluate every color's range tests for every value of each color axis.
+ *  Since a color range is the AND of three independent axis tests, the masks
+ *  reproduce DColorRange::Apply exactly.  Return true if the masks changed
+ *  since they were last built.
+ *
+ *****************************************************************************/
+
+bool DColorBlobFinder::BuildChannelMasks()
+   {
+   uint64_t Masks[3][256] = {};
+
+   // Bit (i - 1) represents color i, 0 is background.  Colors beyond what
+   // the masks hold are left to the per color loop.
+   size_t nColors = std::min(m_pColors->size(), static_cast<size_t>(m_nMaxColors) + 1);
+   for (size_t i = 1 ; i < nColors ; i++)
+      {
+      DBlob::DBlobColorRange& Range = (*m_pColors)[i].GetColorRange();
+      uint64_t nBit = static_cast<uint64_t>(1) << (i - 1);
+      for (int v = 0 ; v < 256 ; v++)
+         {
+         unsigned char Value = static_cast<unsigned char>(v);
+         if (Range.GetColor1().Apply(Value))
+            {
+            Masks[0][v] |= nBit;
+            } // end if
+         if (Range.GetColor2().Apply(Value))
+            {
+            Masks[1][v] |= nBit;
+            } // end if
+         if (Range.GetColor3().Apply(Value))
+            {
+            Masks[2][v] |= nBit;
+            } // end if
+         } // end for
+      } // end for
+
+   bool bChanged = (std::memcmp(Masks, m_ChannelMasks, sizeof(Masks)) != 0);
+   if (bChanged)
+      {
+      std::memcpy(m_ChannelMasks, Masks, sizeof(Masks));
+      } // end if
+
+   return (bChanged);
+
+   } // End of function DColorBlobFinder::BuildChannelMasks
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::BuildLookup
+ *
+ *  Compile the color table into a table indexed by the raw image pixel.  Each
+ *  entry runs the same color space conversion and first match rule as the
+ *  per pixel loop so categorization reduces to a single load.  The quantized
+ *  table classifies each 5/6/5 cell by its center value.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::BuildLookup()
+   {
+   // Converted a row at a time, the last channel varying fastest
+   unsigned char RGBRow[3 * 256];
+   unsigned char Converted[3 * 256];
+   unsigned char* const pPlanes[3] = { Converted, Converted + 256,
+         Converted + 512 };
+
+   if (m_eActiveClassifier == eClassifyLookup24)
+      {
+      m_Lookup.resize(1 << 24);
+      COLORTYPE* pLookup = m_Lookup.data();
+      for (int c0 = 0 ; c0 < 256 ; c0++)
+         {
+         for (int c1 = 0 ; c1 < 256 ; c1++)
+            {
+            for (int c2 = 0 ; c2 < 256 ; c2++)
+               {
+               RGBRow[3 * c2] = static_cast<unsigned char>(c0);
+               RGBRow[3 * c2 + 1] = static_cast<unsigned char>(c1);
+               RGBRow[3 * c2 + 2] = static_cast<unsigned char>(c2);
+               } // end for
+
+            ConvertRGBRow(RGBRow, eBGR24, 256, pPlanes);
+            for (int c2 = 0 ; c2 < 256 ; c2++)
+               {
+               unsigned char Pixel[3] = { pPlanes[0][c2], pPlanes[1][c2],
+                     pPlanes[2][c2] };
+               *pLookup++ = ClassifyPixel(Pixel);
+               } // end for
+            } // end for
+         } // end for
+      } // end if
+   else if (m_eActiveClassifier == eClassifyLookup565)
+      {
+      m_Lookup.resize(1 << 16);
+      COLORTYPE* pLookup = m_Lookup.data();
+      for (int c0 = 0 ; c0 < 32 ; c0++)
+         {
+         for (int c1 = 0 ; c1 < 64 ; c1++)
+            {
+            for (int c2 = 0 ; c2 < 32 ; c2++)
+               {
+               RGBRow[3 * c2] = static_cast<unsigned char>((c0 << 3) | 0x04);
+               RGBRow[3 * c2 + 1] = static_cast<unsigned char>((c1 << 2) | 0x02);
+               RGBRow[3 * c2 + 2] = static_cast<unsigned char>((c2 << 3) | 0x04);
+               } // end for
+
+            ConvertRGBRow(RGBRow, eBGR24, 32, pPlanes);
+            for (int c2 = 0 ; c2 < 32 ; c2++)
+               {
+               unsigned char Pixel[3] = { pPlanes[0][c2], pPlanes[1][c2],
+                     pPlanes[2][c2] };
+               *pLookup++ = ClassifyPixel(Pixel);
+               } // end for
+            } // end for
+         } // end for
+      } // end else if
+   else
+      {
+      // Release the memory if the lookup isn't being used
+      std::vector<COLORTYPE>().swap(m_Lookup);
+      } // end else
+
+   m_bCompiled = true;
+
+   return;
+
+   } // End of function DColorBlobFinder::BuildLookup
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::BuildGreyLookup
+ *
+ *  Categorize every grey level with the current classifier, as the same
+ *  grey would be in a DCVImage.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::BuildGreyLookup()
+   {
+   unsigned char GreyRow[3 * 256];
+   unsigned char Buffer[3 * 256];
+   for (int v = 0 ; v < 256 ; v++)
+      {
+      GreyRow[3 * v] = GreyRow[3 * v + 1] = GreyRow[3 * v + 2]
+            = static_cast<unsigned char>(v);
+      } // end for
+
+   CategorizeRow(GreyRow, eBGR24, m_GreyLookup, 256, Buffer);
+
+   return;
+
+   } // End of function DColorBlobFinder::BuildGreyLookup 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::BuildSIMDRanges
+ *
+ *  Reduce each color's channel masks to the interval tests the SIMD kernel
+ *  uses.  An axis accepting one contiguous run of values is a plain interval
+ *  and one rejecting a single contiguous run is a wrapped (circular)
+ *  interval.  Colors that can't match anything are dropped.  Return false if
+ *  some axis can't be expressed either way.
+ *
+ *****************************************************************************/
+
+bool DColorBlobFinder::BuildSIMDRanges()
+   {
+   bool bRet = true;
+
+   m_SIMDRanges.clear();
+
+   size_t nColors = std::min(m_pColors->size(), static_cast<size_t>(m_nMaxColors) + 1);
+   for (size_t i = 1 ; bRet && (i < nColors) ; i++)
+      {
+      uint64_t nBit = static_cast<uint64_t>(1) << (i - 1);
+      DBlobSIMD::DColorRange Range;
+      Range.nCategory = static_cast<unsigned char>(i);
+      bool bEmpty = false;
+
+      for (int k = 0 ; bRet && (k < 3) ; k++)
+         {
+         // Count the accepted values and the starts of accepted runs
+         int nAccepted = 0;
+         int nRuns = 0;
+         int nFirst = -1;
+         int nLast = -1;
+         for (int v = 0 ; v < 256 ; v++)
+            {
+            bool bIn = (m_ChannelMasks[k][v] & nBit) != 0;
+            if (bIn)
+               {
+               nAccepted++;
+               if ((v == 0) || ((m_ChannelMasks[k][v - 1] & nBit) == 0))
+                  {
+                  nRuns++;
+                  } // end if
+               if (nFirst == -1)
+                  {
+                  nFirst = v;
+                  } // end if
+               nLast = v;
+               } // end if
+            } // end for
+
+         if (nAccepted == 0)
+            {
+            bEmpty = true;
+            } // end if
+         else if (nRuns == 1)
+            {
+            Range.Low[k] = static_cast<unsigned char>(nFirst);
+            Range.High[k] = static_cast<unsigned char>(nLast);
+            Range.Wrap[k] = false;
+            } // end else if
+         else if ((nRuns == 2) && (nFirst == 0) && (nLast == 255))
+            {
+            // Accepted at both ends, find the rejected gap
+            int nGapStart = 0;
+            while ((m_ChannelMasks[k][nGapStart] & nBit) != 0)
+               {
+               nGapStart++;
+               } // end while
+            int nGapEnd = nGapStart;
+            while ((m_ChannelMasks[k][nGapEnd + 1] & nBit) == 0)
+               {
+               nGapEnd++;
+               } // end while
+
+            Range.Low[k] = static_cast<unsigned char>(nGapEnd + 1);
+            Range.High[k] = static_cast<unsigned char>(nGapStart - 1);
+            Range.Wrap[k] = true;
+            } // end else if
+         else
+            {
+            bRet = false;
+            } // end else
+         } // end for
+
+      if (bRet && !bEmpty)
+         {
+         m_SIMDRanges.push_back(Range);
+         } // end if
+      } // end for
+
+   return (bRet);
+
+   } // End of function DColorBlobFinder::BuildSIMDRanges
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::PrepareClassifier
+ *
+ *  Make sure the classifier reflects the current color table.  The bitmask
+ *  and lookup modes depend on the channel masks which can only hold
+ *  m_nMaxColors (at most 64) colors, so larger color tables use the per
+ *  color loop until the table shrinks again.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::PrepareClassifier()
+   {
+   EClassifier eClassifier = m_eClassifier;
+   if (m_pColors->size() > static_cast<size_t>(m_nMaxColors) + 1)
+      {
+      eClassifier = eClassifyLoop;
+      // The masks don't see every color so changes can't be detected
+      m_bTilesValid = false;
+      } // end if
+
+   if (eClassifier != m_eActiveClassifier)
+      {
+      m_eActiveClassifier = eClassifier;
+      m_bCompiled = false;
+      } // end if
+
+   if (BuildChannelMasks())
+      {
+      m_bCompiled = false;
+      } // end if
+
+   if (!m_bCompiled)
+      {
+      // The categories kept for the incremental mode are stale
+      m_bTilesValid = false;
+      BuildLookup();
+
+      m_bSIMDUsable = (m_eActiveClassifier == eClassifySIMD)
+            && (m_eSIMDLevel != DBlobSIMD::eNone) && BuildSIMDRanges();
+      } // end if
+
+   // Cheap enough to do every frame, which also catches edits to colors
+   // beyond what the channel masks hold
+   if (m_Image.eFormat == eGray8)
+      {
+      BuildGreyLookup();
+      } // end if
+
+   return;
+
+   } // End of function DColorBlobFinder::PrepareClassifier
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::CompileColors
+ *
+ *  Compile the classifier for the current color table now rather than on the
+ *  next frame.  Building the 24 bit table takes a noticeable fraction of a
+ *  second.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::CompileColors()
+   {
+   if (m_pColors != nullptr)
+      {
+      m_bCompiled = false;
+      PrepareClassifier();
+      } // end if
+
+   return;
+
+   } // End of function DColorBlobFinder::CompileColors
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::ExtractRowRuns
+ *
+ *  Append the horizontal runs of each color in nCols categories of a row,
+ *  the first of them for column nFirstCol.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::ExtractRowRuns(int nRow, const COLORTYPE* ColorRow,
+      int nFirstCol, int nCols, std::vector<DRun>& Runs) const
+   {
+   // New row starting so a new color run is starting, too
+   COLORTYPE nCurColor = ColorRow[0];
+   int nStart = 0;
+   for (int c = 1 ; c < nCols ; c++)
+      {
+      // If the current pixel color isn't the same as the current run,
+      // a new run is starting
+      if (ColorRow[c] != nCurColor)
+         {
+         //  New run starting
+         if (nCurColor != 0)
+            {
+            // Current run is not background so save it
+            Runs.push_back(DRun(nRow, nFirstCol + nStart, nFirstCol + c - 1,
+                  nCurColor));
+            } // end if
+
+         // Mark a new color run starting   
+         nCurColor = ColorRow[c];
+         nStart = c;
+         } // end if
+      } // end for Column Loop
+
+   // At end of a row so save the current run if not background
+   if (nCurColor != 0)
+      {
+      Runs.push_back(DRun(nRow, nFirstCol + nStart, nFirstCol + nCols - 1,
+            nCurColor));
+      } // end if
+
+   return;
+
+   } // End of function DColorBlobFinder::ExtractRowRuns
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::ExtractRuns
+ *
+ *  Find the horizontal runs of each color in a band of the category matrix.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::ExtractRuns(DBand& Band)
+   {
+   Band.Runs.clear();
+   Band.RowRuns.clear();
+
+   for (int r = Band.nFirstRow ; r < Band.nEndRow ; r++)
+      {
+      Band.RowRuns.push_back(Band.Runs.size());
+      for (size_t s = m_RowSpans[r] ; s < m_RowSpans[r + 1] ; s++)
+         {
+         const DSpan& Span = m_Spans[s];
+         ExtractRowRuns(r, m_ColorMat[r - m_ptColorMat.y]
+               + (Span.nFirstCol - m_ptColorMat.x), Span.nFirstCol,
+               Span.nEndCol - Span.nFirstCol, Band.Runs);
+         } // end for
+      } // end for
+
+   Band.RowRuns.push_back(Band.Runs.size());
+
+   return;
+
+   } // End of function DColorBlobFinder::ExtractRuns
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::StreamRuns
+ *
+ *  Categorize a band a row at a time and extract each row's runs while its
+ *  categories are still in cache.  Only one row of categories is kept.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::StreamRuns(DBand& Band)
+   {
+   Band.Runs.clear();
+   Band.RowRuns.clear();
+
+   for (int r = Band.nFirstRow ; r < Band.nEndRow ; r++)
+      {
+      Band.RowRuns.push_back(Band.Runs.size());
+      for (size_t s = m_RowSpans[r] ; s < m_RowSpans[r + 1] ; s++)
+         {
+         const DSpan& Span = m_Spans[s];
+         int nCols = Span.nEndCol - Span.nFirstCol;
+         CategorizeImageRow(r, Span.nFirstCol, Band.ColorRow.data(), nCols,
+               Band.Planes.data());
+         ExtractRowRuns(r, Band.ColorRow.data(), Span.nFirstCol, nCols, Band.Runs);
+         } // end for
+      } // end for
+
+   Band.RowRuns.push_back(Band.Runs.size());
+
+   return;
+
+   } // End of function DColorBlobFinder::StreamRuns
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::UpdateTiles
+ *
+ *  Compare a band's tiles with the previous frame and categorize the ones
+ *  that changed, side by side changed tiles in one go.  Rows crossing a
+ *  changed tile get new runs, the rest copy their runs from the last frame.
+ *  Bands are whole rows of tiles so no tile is shared between threads.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::UpdateTiles(DBand& Band)
+   {
+   Band.Runs.clear();
+   Band.RowRuns.clear();
+
+   int nCols = m_Image.nCols;
+   int nPixelSize = m_Image.nPixelSize;
+   size_t nRowBytes = static_cast<size_t>(nCols) * nPixelSize;
+   int nTileCols = (nCols + m_nTileSize - 1) / m_nTileSize;
+
+   for (int nTileRow = Band.nFirstRow ; nTileRow < Band.nEndRow ;
+         nTileRow += m_nTileSize)
+      {
+      int nEndRow = std::min(nTileRow + m_nTileSize, Band.nEndRow);
+      unsigned char* pChanged = &m_ChangedTiles[static_cast<size_t>(nTileRow
+            / m_nTileSize) * nTileCols];
+
+      // memcmp is vectorized and stops at the first difference
+      bool bRowChanged = false;
+      for (int t = 0 ; t < nTileCols ; t++)
+         {
+         size_t nOffset = static_cast<size_t>(t) * m_nTileSize * nPixelSize;
+         size_t nBytes = std::min(nRowBytes - nOffset,
+               static_cast<size_t>(m_nTileSize) * nPixelSize);
+         bool bChanged = !m_bTilesValid;
+         for (int r = nTileRow ; (r < nEndRow) && !bChanged ; r++)
+            {
+            bChanged = (std::memcmp(m_Image.GetRow(r) + nOffset,
+                  &m_PrevPixels[r * nRowBytes + nOffset], nBytes) != 0);
+            } // end for
+         pChanged[t] = bChanged ? 1 : 0;
+         bRowChanged = bRowChanged || bChanged;
+         } // end for
+
+      for (int r = nTileRow ; r < nEndRow ; r++)
+         {
+         if (bRowChanged)
+            {
+            const unsigned char* pRow = m_Image.GetRow(r);
+            for (int t = 0 ; t < nTileCols ; t++)
+               {
+               if (pChanged[t] != 0)
+                  {
+                  int nFirstCol = t * m_nTileSize;
+                  while ((t + 1 < nTileCols) && (pChanged[t + 1] != 0))
+                     {
+                     t++;
+                     } // end while
+                  int nEndCol = std::min((t + 1) * m_nTileSize, nCols);
+
+                  size_t nOffset = static_cast<size_t>(nFirstCol) * nPixelSize;
+                  CategorizeImageRow(r, nFirstCol, m_ColorMat[r] + nFirstCol,
+                        nEndCol - nFirstCol, Band.Planes.data());
+                  std::memcpy(&m_PrevPixels[r * nRowBytes + nOffset], pRow + nOffset,
+                        static_cast<size_t>(nEndCol - nFirstCol) * nPixelSize);
+                  } // end if
+               } // end for
+
+            m_CachedRuns[r].clear();
+            ExtractRowRuns(r, m_ColorMat[r], 0, nCols, m_CachedRuns[r]);
+            } // end if
+
+         Band.RowRuns.push_back(Band.Runs.size());
+         Band.Runs.insert(Band.Runs.end(), m_CachedRuns[r].begin(),
+               m_CachedRuns[r].end());
+         } // end for
+      } // end for
+
+   Band.RowRuns.push_back(Band.Runs.size());
+
+   return;
+
+   } // End of function DColorBlobFinder::UpdateTiles
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::ValidateTiles
+ *
+ *  Categorize the whole image again and check the incremental categories
+ *  and runs against it.  A wrong row is counted and replaced, and the runs
+ *  are then taken from the corrected matrix.  The next frame starts over.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::ValidateTiles(std::vector<DBand>& Bands)
+   {
+   int nRows = m_Image.nRows;
+   int nCols = m_Image.nCols;
+
+   std::vector<COLORTYPE> ColorRow(nCols);
+   std::vector<unsigned char> Planes(3 * nCols);
+   std::vector<DRun> Runs;
+   bool bValid = true;
+
+   for (int r = 0 ; r < nRows ; r++)
+      {
+      CategorizeImageRow(r, 0, ColorRow.data(), nCols, Planes.data());
+      Runs.clear();
+      ExtractRowRuns(r, ColorRow.data(), 0, nCols, Runs);
+
+      bool bSame = (std::memcmp(ColorRow.data(), m_ColorMat[r], nCols) == 0)
+            && std::equal(Runs.begin(), Runs.end(), m_CachedRuns[r].begin(),
+            m_CachedRuns[r].end(), [](const DRun& Run1, const DRun& Run2)
+            {
+            return ((Run1.GetStart() == Run2.GetStart())
+                  && (Run1.GetEnd() == Run2.GetEnd())
+                  && (Run1.GetColor() == Run2.GetColor()));
+            });
+      if (!bSame)
+         {
+         m_nValidationErrors++;
+         std::memcpy(m_ColorMat[r], ColorRow.data(), nCols);
+         m_CachedRuns[r].swap(Runs);
+         bValid = false;
+         } // end if
+      } // end for
+
+   if (!bValid)
+      {
+      ForEachBand(Bands, [this](DBand& Band) { ExtractRuns(Band); });
+      m_bTilesValid = false;
+      } // end if
+
+   return;
+
+   } // End of function DColorBlobFinder::ValidateTiles
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::LabelRuns
+ *
+ *  Join the runs of Bands, which cover images nNumCols wide, into blobs.
+ *  Each run gets a provisional label from
+ *  the first run it touches in the previous row, or a new one.  Touching a
+ *  second blob only records that the two labels are the same blob, so
+ *  merging never copies runs.  Once every row is labeled the runs are added
+ *  to the blob of their label's root, in raster order.
+ *
+ *  With more than one band and bParallel the bands are labeled at the same
+ *  time, each from zero, and then stitched together where they meet.  Labels are laid
+ *  out band after band so a root is still the label of its blob's first
+ *  run, and the blobs are numbered in root order.  The IDs are the same for
+ *  any number of bands.
+ *
+ *  Each pair of touching runs and the columns they share are counted under
+ *  the label at hand, which later gives the blobs their perimeter and Euler
+ *  number.  For containment the gaps between each color's runs are labeled
+ *  the same way with 8 connectivity, along with the gap of every other
+ *  color holding each blob's first run.  The gaps have to be followed down
+ *  the whole frame, so containment visits the rows in order across the
+ *  bands instead.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::LabelRuns(std::vector<DBand>& Bands, int nNumCols,
+      bool bParallel)
+   {
+   size_t nColorCount = m_pColors->size();
+
+   m_Labels.Clear();
+   m_LabelStats.clear();
+
+   // Only follow the blobs' areas and close them when something needs it
+   bool bClose = false;
+   m_MinAreas.resize(nColorCount, 0.0);
+   m_LargestCounts.resize(nColorCount, 0);
+   m_LargestHeaps.resize(nColorCount);
+   for (size_t nColor = 1 ; nColor < nColorCount ; nColor++)
+      {
+      bClose = bClose || (m_MinAreas[nColor] > 0.0) || (m_LargestCounts[nColor] > 0);
+      m_LargestHeaps[nColor].clear();
+      } // end for
+
+   if ((Bands.size() > 1) && !m_bContainment && bParallel)
+      {
+      ForEachBand(Bands, [this](DBand& Band) { LabelBand(Band); });
+      StitchBands(Bands);
+
+      if (bClose)
+         {
+         // The bands kept the area under each label, so add the pieces up
+         // at the roots.  A root is always below its other labels.
+         for (int nLabel = 0 ; nLabel < m_Labels.GetCount() ; nLabel++)
+            {
+            int nRoot = m_Labels.Find(nLabel);
+            if (nRoot != nLabel)
+               {
+               m_LabelStats[nRoot].nArea += m_LabelStats[nLabel].nArea;
+               } // end if
+            } // end for
+
+         for (int nLabel = 0 ; nLabel < m_Labels.GetCount() ; nLabel++)
+            {
+            if (m_Labels.Find(nLabel) == nLabel)
+               {
+               CloseBlob(nLabel);
+               } // end if
+            } // end for
+         } // end if
+      } // end if
+   else
+      {
+      // Storage for two image rows of runs sorted by color
+      int nPrevRuns = 0;
+      int nCurRuns = 1;
+      std::vector<std::vector<DRun*> > ColorRuns[2];
+      ColorRuns[0].resize(nColorCount);
+      ColorRuns[1].resize(nColorCount);
+
+      // Runs given a new label in the current row
+      std::vector<DRun*> NewRuns;
+      // Everything outside the searched rows is background, so the first
+      // and last of them are on the border as far as holes go
+      int nFirstRow = Bands.front().nFirstRow;
+      int nLastRow = Bands.back().nEndRow - 1;
+
+      if (m_bContainment)
+         {
+         m_GapLabels.Clear();
+         m_GapInfo.clear();
+         m_Enclosures.clear();
+         for (auto& ColorGaps : m_ColorGaps)
+            {
+            ColorGaps.resize(nColorCount);
+            for (auto& Gaps : ColorGaps)
+               {
+               Gaps.clear();
+               } // end for
+            } // end for
+         } // end if
+
+      for (auto& Band : Bands)
+         {
+         for (size_t nRow = 0 ; nRow + 1 < Band.RowRuns.size() ; nRow++)
+            {
+            NewRuns.clear();
+            int nImageRow = Band.nFirstRow + static_cast<int>(nRow);
+
+            // Sort this row's runs by color
+            for (size_t i = Band.RowRuns[nRow] ; i < Band.RowRuns[nRow + 1] ; i++)
+               {
+               DRun& Run = Band.Runs[i];
+               ColorRuns[nCurRuns][Run.GetColor()].push_back(&Run);
+               } // end for
+
+            LabelRow(ColorRuns[nPrevRuns].data(), ColorRuns[nCurRuns].data(),
+                  nImageRow, bClose, m_Labels, m_LabelStats, &NewRuns);
+
+            if (bClose)
+               {
+               // Blobs of the previous row that didn't reach this one are done
+               for (size_t nColor = 1 ; nColor < nColorCount ; nColor++)
+                  {
+                  for (const DRun* pRun : ColorRuns[nPrevRuns][nColor])
+                     {
+                     int nRoot = m_Labels.Find(pRun->GetBlob());
+                     if (!m_LabelStats[nRoot].bClosed
+                           && (m_LabelStats[nRoot].nLastRow < nImageRow))
+                        {
+                        CloseBlob(nRoot);
+                        } // end if
+                     } // end for
+                  } // end for
+               } // end if
+
+            if (m_bContainment)
+               {
+               bool bBorderRow = (nImageRow == nFirstRow) || (nImageRow == nLastRow);
+               for (size_t nColor = 1 ; nColor < nColorCount ; nColor++)
+                  {
+                  LinkGaps(nNumCols, bBorderRow, ColorRuns[nCurRuns][nColor],
+                        m_ColorGaps[nPrevRuns][nColor], m_ColorGaps[nCurRuns][nColor]);
+                  } // end for
+
+               // Note the gap of each other color that a new blob starts in
+               for (const DRun* pRun : NewRuns)
+                  {
+                  for (size_t nColor = 1 ; nColor < nColorCount ; nColor++)
+                     {
+                     if (static_cast<int>(nColor) != pRun->GetColor())
+                        {
+                        const std::vector<DGap>& Gaps = m_ColorGaps[nCurRuns][nColor];
+                        auto itGap = std::upper_bound(Gaps.begin(), Gaps.end(),
+                              pRun->GetStart(), [](int nCol, const DGap& Gap)
+                              { return (nCol < Gap.nStart); });
+                        m_Enclosures.emplace_back(pRun->GetBlob(), (itGap - 1)->nLabel);
+                        } // end if
+                     } // end for
+                  } // end for
+               } // end if
+
+            // Make the current row runs the previous row runs
+            nCurRuns ^= 1;
+            nPrevRuns ^= 1;
+
+            // Clear the previous row's runs which is now the current row
+            for (auto& ColorRun : ColorRuns[nCurRuns])
+               {
+               ColorRun.clear();
+               } // end for
+            } // end for Row Loop
+         } // end for Band Loop
+
+      if (bClose)
+         {
+         // Whatever reached the last row is done now too
+         for (size_t nColor = 1 ; nColor < nColorCount ; nColor++)
+            {
+            for (const DRun* pRun : ColorRuns[nPrevRuns][nColor])
+               {
+               int nRoot = m_Labels.Find(pRun->GetBlob());
+               if (!m_LabelStats[nRoot].bClosed)
+                  {
+                  CloseBlob(nRoot);
+                  } // end if
+               } // end for
+            } // end for
+         } // end if
+      } // end else
+
+   int nBlobCount = NumberBlobs();
+
+   if (bClose)
+      {
+      // Hand over the largest blobs, best first.  IDs are in the same order
+      // as the root labels so the ranking holds.
+      DBlob::DIDVector Largest;
+      for (size_t nColor = 1 ; nColor < nColorCount ; nColor++)
+         {
+         if (m_LargestCounts[nColor] > 0)
+            {
+            std::vector<DAreaID>& Heap = m_LargestHeaps[nColor];
+            std::sort_heap(Heap.begin(), Heap.end(), IsLarger);
+            Largest.clear();
+            for (const auto& AreaID : Heap)
+               {
+               Largest.push_back(m_BlobIDs[AreaID.second]);
+               } // end for
+            m_Blobs[nColor].SetLargest(Largest);
+            } // end if
+         } // end for
+      } // end if
+
+   // Build the blobs
+   for (auto& Band : Bands)
+      {
+      for (auto& Run : Band.Runs)
+         {
+         int nBlob = m_BlobIDs[Run.GetBlob()];
+         if (nBlob == -1)
+            {
+            // Too small so no blob
+            Run.SetBlob(-1);
+            continue;
+            } // end if
+
+         DBlobMap& BlobMap = m_Blobs[Run.GetColor()];
+         auto itBlob = BlobMap.find(nBlob);
+         DBlob& Blob = (itBlob != BlobMap.end()) ? itBlob->second
+               : BlobMap.Add(nBlob, Run.GetColor(), m_bStoreRuns,
+               m_bHigherMoments);
+
+         BlobMap.AddRun(Blob, Run);
+         } // end for
+      } // end for
+
+   for (int nLabel = 0 ; nLabel < m_Labels.GetCount() ; nLabel++)
+      {
+      const DLabelStats& Stats = m_LabelStats[nLabel];
+      int nBlob = m_BlobIDs[nLabel];
+      if ((Stats.nContacts > 0) && (nBlob != -1))
+         {
+         DBlobMap& BlobMap = m_Blobs[Stats.nColor];
+         BlobMap.find(nBlob)->second.AddContacts(Stats.nContacts, Stats.nOverlap);
+         } // end if
+      } // end for
+
+   if (m_bContainment)
+      {
+      BuildContainment(nBlobCount);
+      } // end if
+
+   if (m_bStoreRuns)
+      {
+      // AddRun left the blob ID in each run
+      for (auto& BlobMap : m_Blobs)
+         {
+         BlobMap.ReserveRuns();
+         } // end for
+
+      for (const auto& Band : Bands)
+         {
+         for (const auto& Run : Band.Runs)
+            {
+            if (Run.GetBlob() != -1)
+               {
+               m_Blobs[Run.GetColor()].StoreRun(Run);
+               } // end if
+            } // end for
+         } // end for
+      } // end if
+
+   return;
+
+   } // End of function DColorBlobFinder::LabelRuns 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::LabelRow
+ *
+ *  Label one row's runs from the runs they touch in the previous row.  Both
+ *  rows are given as runs sorted by color.  Runs without a label yet join
+ *  the first blob they touch or start a new one, which is added to
+ *  pNewRuns if there is one.  When bClose is set the roots carry the area
+ *  and last row of their blobs.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::LabelRow(std::vector<DRun*>* pPrevRuns,
+      std::vector<DRun*>* pCurRuns, int nImageRow, bool bClose,
+      DUnionFind& Labels, std::vector<DLabelStats>& LabelStats,
+      std::vector<DRun*>* pNewRuns)
+   {
+   size_t nColorCount = m_pColors->size();
+   for (size_t nColor = 1 ; nColor < nColorCount ; nColor++)
+      {
+      const std::vector<DRun*>& PrevRuns = pPrevRuns[nColor];
+      size_t nPrevCount = PrevRuns.size();
+      size_t nFirstPrev = 0;
+      for (DRun* pCurRun : pCurRuns[nColor])
+         {
+         size_t p = 0;
+         if (m_bLinearOverlap)
+            {
+            // Both rows are in column order.  Previous runs ending left of
+            // this run can't touch it or any later run.
+            while ((nFirstPrev < nPrevCount)
+                  && (PrevRuns[nFirstPrev]->GetEnd() < pCurRun->GetStart()))
+               {
+               nFirstPrev++;
+               } // end while
+            p = nFirstPrev;
+            } // end if
+
+         for ( ; p < nPrevCount ; p++)
+            {
+            const DRun* pPrevRun = PrevRuns[p];
+            if (m_bLinearOverlap && (pPrevRun->GetStart() > pCurRun->GetEnd()))
+               {
+               // This and the rest are to the right
+               break;
+               } // end if
+
+            if (pCurRun->Overlap(*pPrevRun))
+               {
+               if (pCurRun->GetBlob() == -1)
+                  {
+                  // Aren't part of a blob so join the existing blob
+                  pCurRun->SetBlob(pPrevRun->GetBlob());
+                  } // end if
+               else if (!bClose)
+                  {
+                  // Two blobs may be in contact, if so they're one
+                  Labels.Union(pCurRun->GetBlob(), pPrevRun->GetBlob());
+                  } // end else if
+               else
+                  {
+                  // Same but the root carries the area of both
+                  int nRoot1 = Labels.Find(pCurRun->GetBlob());
+                  int nRoot2 = Labels.Find(pPrevRun->GetBlob());
+                  if (nRoot1 != nRoot2)
+                     {
+                     int64_t nArea = LabelStats[nRoot1].nArea + LabelStats[nRoot2].nArea;
+                     LabelStats[Labels.Union(nRoot1, nRoot2)].nArea = nArea;
+                     } // end if
+                  } // end else
+
+               DLabelStats& Stats = LabelStats[pCurRun->GetBlob()];
+               Stats.nContacts++;
+               Stats.nOverlap += std::min(pCurRun->GetEnd(), pPrevRun->GetEnd())
+                     - std::max(pCurRun->GetStart(), pPrevRun->GetStart()) + 1;
+               } // end if
+            } // end for
+
+         // Wasn't joined to an existing blob so start a new one
+         if (pCurRun->GetBlob() == -1)
+            {
+            pCurRun->SetBlob(Labels.NewLabel());
+            LabelStats.push_back({ static_cast<int>(nColor), 0, 0, 0,
+                  nImageRow, false, false });
+            if (pNewRuns != nullptr)
+               {
+               pNewRuns->push_back(pCurRun);
+               } // end if
+            } // end if
+
+         if (bClose)
+            {
+            DLabelStats& Root = LabelStats[Labels.Find(pCurRun->GetBlob())];
+            Root.nArea += pCurRun->GetEnd() - pCurRun->GetStart() + 1;
+            Root.nLastRow = nImageRow;
+            } // end if
+         } // end for
+      } // end for Color Loop
+
+   return;
+
+   } // End of function DColorBlobFinder::LabelRow 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::LabelBand
+ *
+ *  Label the band's runs on their own with labels counted from zero.  The
+ *  band's first row touches nothing yet, StitchBands joins it to the band
+ *  above.  Each label keeps the area of its own runs.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::LabelBand(DBand& Band)
+   {
+   size_t nColorCount = m_pColors->size();
+
+   Band.Labels.Clear();
+   Band.LabelStats.clear();
+   for (auto& ColorRuns : Band.ColorRuns)
+      {
+      ColorRuns.resize(nColorCount);
+      for (auto& Runs : ColorRuns)
+         {
+         Runs.clear();
+         } // end for
+      } // end for
+
+   int nPrevRuns = 0;
+   int nCurRuns = 1;
+   for (size_t nRow = 0 ; nRow + 1 < Band.RowRuns.size() ; nRow++)
+      {
+      int nImageRow = Band.nFirstRow + static_cast<int>(nRow);
+
+      // Sort this row's runs by color
+      for (size_t i = Band.RowRuns[nRow] ; i < Band.RowRuns[nRow + 1] ; i++)
+         {
+         DRun& Run = Band.Runs[i];
+         Band.ColorRuns[nCurRuns][Run.GetColor()].push_back(&Run);
+         } // end for
+
+      LabelRow(Band.ColorRuns[nPrevRuns].data(), Band.ColorRuns[nCurRuns].data(),
+            nImageRow, false, Band.Labels, Band.LabelStats, nullptr);
+
+      for (size_t i = Band.RowRuns[nRow] ; i < Band.RowRuns[nRow + 1] ; i++)
+         {
+         const DRun& Run = Band.Runs[i];
+         Band.LabelStats[Run.GetBlob()].nArea += Run.GetEnd() - Run.GetStart() + 1;
+         } // end for
+
+      nCurRuns ^= 1;
+      nPrevRuns ^= 1;
+      for (auto& Runs : Band.ColorRuns[nCurRuns])
+         {
+         Runs.clear();
+         } // end for
+      } // end for
+
+   Band.nLastRuns = nPrevRuns;
+
+   return;
+
+   } // End of function DColorBlobFinder::LabelBand 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::StitchBands
+ *
+ *  Put the separately labeled Bands' labels end to end in m_Labels and join
+ *  each band's first row to the last row of the band above.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::StitchBands(std::vector<DBand>& Bands)
+   {
+   for (auto& Band : Bands)
+      {
+      Band.nFirstLabel = m_Labels.GetCount();
+      m_Labels.Append(Band.Labels);
+      m_LabelStats.insert(m_LabelStats.end(), Band.LabelStats.begin(),
+            Band.LabelStats.end());
+      } // end for
+
+   ForEachBand(Bands, [](DBand& Band)
+      {
+      for (auto& Run : Band.Runs)
+         {
+         Run.SetBlob(Run.GetBlob() + Band.nFirstLabel);
+         } // end for
+      });
+
+   // The seams are labeled like any other row, except that every run of
+   // the lower row already has a label
+   std::vector<std::vector<DRun*> > FirstRuns(m_pColors->size());
+   for (size_t b = 1 ; b < Bands.size() ; b++)
+      {
+      DBand& Band = Bands[b];
+      DBand& BandAbove = Bands[b - 1];
+
+      for (auto& Runs : FirstRuns)
+         {
+         Runs.clear();
+         } // end for
+      for (size_t i = Band.RowRuns[0] ; i < Band.RowRuns[1] ; i++)
+         {
+         DRun& Run = Band.Runs[i];
+         FirstRuns[Run.GetColor()].push_back(&Run);
+         } // end for
+
+      LabelRow(BandAbove.ColorRuns[BandAbove.nLastRuns].data(), FirstRuns.data(),
+            Band.nFirstRow, false, m_Labels, m_LabelStats, nullptr);
+      } // end for
+
+   return;
+
+   } // End of function DColorBlobFinder::StitchBands 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::NumberBlobs
+ *
+ *  Give each root label the next blob ID and every other label the ID of
+ *  its root.  Pruned blobs use up their ID so the others keep the IDs they
+ *  would have without pruning.  Returns the number of IDs given out.
+ *
+ *****************************************************************************/
+
+int DColorBlobFinder::NumberBlobs()
+   {
+   int nBlobCount = 0;
+   m_BlobIDs.resize(m_Labels.GetCount());
+   for (int nLabel = 0 ; nLabel < m_Labels.GetCount() ; nLabel++)
+      {
+      int nRoot = m_Labels.Find(nLabel);
+      if (nRoot != nLabel)
+         {
+         // Roots come first so this one is numbered already
+         m_BlobIDs[nLabel] = m_BlobIDs[nRoot];
+         } // end if
+      else
+         {
+         m_BlobIDs[nLabel] = m_LabelStats[nLabel].bPruned ? -1 : nBlobCount;
+         nBlobCount++;
+         } // end else
+      } // end for
+
+   return (nBlobCount);
+
+   } // End of function DColorBlobFinder::NumberBlobs 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::LinkGaps
+ *
+ *  Split a row nCols wide into the gaps between one color's runs and join them to the
+ *  gaps they touch in the previous row, diagonals included.  Gaps on the
+ *  image border are open since they can't be holes.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::LinkGaps(int nCols, bool bBorderRow,
+      const std::vector<DRun*>& Runs, const std::vector<DGap>& PrevGaps,
+      std::vector<DGap>& CurGaps)
+   {
+   CurGaps.clear();
+   int nStart = 0;
+   int nOwner = -1;
+   for (const DRun* pRun : Runs)
+      {
+      if (pRun->GetStart() > nStart)
+         {
+         CurGaps.push_back({ nStart, pRun->GetStart() - 1, nOwner, -1 });
+         } // end if
+      nStart = pRun->GetEnd() + 1;
+      nOwner = pRun->GetBlob();
+      } // end for
+
+   if (nStart < nCols)
+      {
+      CurGaps.push_back({ nStart, nCols - 1, nOwner, -1 });
+      } // end if
+
+   size_t nPrevCount = PrevGaps.size();
+   size_t nFirstPrev = 0;
+   for (auto& Gap : CurGaps)
+      {
+      bool bOpen = bBorderRow || (Gap.nStart == 0) || (Gap.nEnd == nCols - 1);
+
+      // Previous gaps ending more than a column left of this one can't touch
+      // it or any later gap
+      while ((nFirstPrev < nPrevCount) && (PrevGaps[nFirstPrev].nEnd + 1 < Gap.nStart))
+         {
+         nFirstPrev++;
+         } // end while
+
+      for (size_t p = nFirstPrev ; (p < nPrevCount)
+            && (PrevGaps[p].nStart <= Gap.nEnd + 1) ; p++)
+         {
+         int nPrevRoot = m_GapLabels.Find(PrevGaps[p].nLabel);
+         if (Gap.nLabel == -1)
+            {
+            Gap.nLabel = nPrevRoot;
+            } // end if
+         else if (nPrevRoot != Gap.nLabel)
+            {
+            bool bEitherOpen = m_GapInfo[Gap.nLabel].bOpen || m_GapInfo[nPrevRoot].bOpen;
+            Gap.nLabel = m_GapLabels.Union(Gap.nLabel, nPrevRoot);
+            m_GapInfo[Gap.nLabel].bOpen = bEitherOpen;
+            } // end else if
+         } // end for
+
+      if (Gap.nLabel == -1)
+         {
+         Gap.nLabel = m_GapLabels.NewLabel();
+         m_GapInfo.push_back({ bOpen, Gap.nOwner });
+         } // end if
+      else
+         {
+         m_GapInfo[Gap.nLabel].bOpen = m_GapInfo[Gap.nLabel].bOpen || bOpen;
+         } // end else
+      } // end for
+
+   return;
+
+   } // End of function DColorBlobFinder::LinkGaps
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::BuildContainment
+ *
+ *  A blob is inside every closed gap of another color that holds its first
+ *  run, and so inside the blob owning that hole.  Those blobs are nested in
+ *  each other so the nearest is the one with the smallest bounding box.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::BuildContainment(int nBlobCount)
+   {
+   // Parents are kept as root labels until every enclosure is seen
+   m_Parents.assign(nBlobCount, -1);
+
+   for (const auto& Enclosure : m_Enclosures)
+      {
+      // The label of a blob's first run is its root
+      int nLabel = Enclosure.first;
+      int nBlob = m_BlobIDs[nLabel];
+      const DGapInfo& Info = m_GapInfo[m_GapLabels.Find(Enclosure.second)];
+      int nOwner = Info.bOpen ? -1 : m_Labels.Find(Info.nOwner);
+      if ((nOwner != -1) && (m_Labels.Find(nLabel) == nLabel)
+            && (nBlob != -1) && (m_BlobIDs[nOwner] != -1))
+         {
+         const DCVRect& rcOwner = m_Blobs[m_LabelStats[nOwner].nColor].find(
+               m_BlobIDs[nOwner])->second.GetBoundingRect();
+
+         int nParent = m_Parents[nBlob];
+         if (nParent == -1)
+            {
+            m_Parents[nBlob] = nOwner;
+            } // end if
+         else
+            {
+            const DCVRect& rcParent = m_Blobs[m_LabelStats[nParent].nColor].find(
+                  m_BlobIDs[nParent])->second.GetBoundingRect();
+            if (rcOwner.area() < rcParent.area())
+               {
+               m_Parents[nBlob] = nOwner;
+               } // end if
+            } // end else
+         } // end if
+      } // end for
+
+   for (auto& nParent : m_Parents)
+      {
+      if (nParent != -1)
+         {
+         nParent = m_BlobIDs[nParent];
+         } // end if
+      } // end for
+
+   m_Blobs.SetParents(m_Parents);
+
+   return;
+
+   } // End of function DColorBlobFinder::BuildContainment
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::CloseBlob
+ *
+ *  The blob with this root label can't grow any more.  Drop it if it's too
+ *  small, otherwise see if it's one of the largest of its color.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::CloseBlob(int nLabel)
+   {
+   DLabelStats& Stats = m_LabelStats[nLabel];
+   Stats.bClosed = true;
+
+   if (static_cast<double>(Stats.nArea) < m_MinAreas[Stats.nColor])
+      {
+      Stats.bPruned = true;
+      } // end if
+   else if (m_LargestCounts[Stats.nColor] > 0)
+      {
+      // Bounded heap with the smallest kept blob on top
+      std::vector<DAreaID>& Heap = m_LargestHeaps[Stats.nColor];
+      DAreaID AreaID(Stats.nArea, nLabel);
+      if (static_cast<int>(Heap.size()) < m_LargestCounts[Stats.nColor])
+         {
+         Heap.push_back(AreaID);
+         std::push_heap(Heap.begin(), Heap.end(), IsLarger);
+         } // end if
+      else if (IsLarger(AreaID, Heap.front()))
+         {
+         std::pop_heap(Heap.begin(), Heap.end(), IsLarger);
+         Heap.back() = AreaID;
+         std::push_heap(Heap.begin(), Heap.end(), IsLarger);
+         } // end else if
+      } // end else if
+
+   return;
+
+   } // End of function DColorBlobFinder::CloseBlob
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::SetMinArea
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::SetMinArea(int nColor, double dMinArea)
+   {
+   if (nColor >= static_cast<int>(m_MinAreas.size()))
+      {
+      m_MinAreas.resize(nColor + 1, 0.0);
+      } // end if
+
+   m_MinAreas[nColor] = dMinArea;
+
+   return;
+
+   } // End of function DColorBlobFinder::SetMinArea
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::SetLargestCount
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::SetLargestCount(int nColor, int nCount)
+   {
+   if (nColor >= static_cast<int>(m_LargestCounts.size()))
+      {
+      m_LargestCounts.resize(nColor + 1, 0);
+      } // end if
+
+   m_LargestCounts[nColor] = nCount;
+
+   return;
+
+   } // End of function DColorBlobFinder::SetLargestCount
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::GetCategories
+ *
+ *  In streaming mode the categories are rebuilt from the image on the first
+ *  request after a find.  The classifier was prepared by that find so the
+ *  result is the same as filling the matrix during it.
+ *
+ *****************************************************************************/
+
+const DColorBlobFinder::DCategoryMatrix& DColorBlobFinder::GetCategories() const
+   {
+   if (!m_bColorMatValid && (m_Image.pData != nullptr) && (m_pColors != nullptr))
+      {
+      m_ColorMat.Resize(m_Image.nRows, m_Image.nCols);
+      m_ptColorMat = cv::Point(0, 0);
+
+      std::vector<unsigned char> Planes(3 * m_Image.nCols);
+      for (int r = 0 ; r < m_Image.nRows ; r++)
+         {
+         CategorizeImageRow(r, 0, m_ColorMat[r], m_Image.nCols, Planes.data());
+         } // end for
+
+      m_bColorMatValid = true;
+      } // end if
+
+   return (m_ColorMat);
+
+   } // End of function DColorBlobFinder::GetCategories 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::DisplayCategories
+ *
+ *  Build an Image where each pixel's color indicates the blob color.  This
+ *  routine is relatively slow but is mostly for debugging.
+ *
+ *****************************************************************************/
+
+void DColorBlobFinder::DisplayCategories(DBlobRenderer* pRenderer) const
+      {
+   if ((m_Image.pData != nullptr) && (m_pColors != nullptr))
+      {
+      const DCategoryMatrix& ColorMat = GetCategories();
+      for (int r = 0 ; r < m_Image.nRows ; r++)
+         {
+         const COLORTYPE* ColorRow = ColorMat[r];
+         for (int c = 0 ; c < m_Image.nCols ; c++)
+            {
+            DBlobColor BlobColor = (*m_pColors)[ColorRow[c]];
+            pRenderer->Point(r, c, BlobColor.GetDisplayColor());
+            } // end for
+         } // end for
+      } // end if
+
+   return;
+
+   } // End of function DColorBlobFinder::DisplayCategories 
+
+/*****************************************************************************
+ *
+ *  DColorBlobFinder::DisplayLargestBlobs
+ *
+ *****************************************************************************/
+
+int DColorBlobFinder::DisplayLargestBlobs(DBlobRenderer* pRenderer,
+      int nDisplay /* = DBlob::eBlob */,
+      cv::Scalar CHColor /* = cv::Scalar(255, 255, 255) */,
+      int nThickness /* = 1 */) const
+      {
+   int nCount = 0;
+
+   if (m_pColors != nullptr)
+      {
+      nCount = m_Blobs.DisplayLargestBlobs(pRenderer, *m_pColors, nDisplay,
+            CHColor, nThickness);
+      } // end if
+
+   return (nCount);
+
+   } // End of function DColorBlobFinder::DisplayLargestBlobs
+
+
+
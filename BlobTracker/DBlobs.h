@@ -1,1142 +1,2601 @@
-/*****************************************************************************
- ********************************* DBlobs.h ***********************************
- *****************************************************************************/
-
-#if !defined(__DBLOBS_H__)
-#define __DBLOBS_H__
-
-#pragma once
-
-/*****************************************************************************
- ******************************  I N C L U D E  *******************************
- *****************************************************************************/
-
-//#include "DConfig.h"
-#include <QPainter>
-#include <QDebug>
-
-#include "DMath.h"
-#include "DMatrix.h"
-#include "CVImage.h"
-#include "DQImage.h"
-
-#include <vector>
-#include <map>
-#include <string>
-//#include <boost/array.hpp>
-#include <opencv2/imgproc/imgproc.hpp>
-#include "DQOpenCV.h"
-
-#include <boost/serialization/serialization.hpp>
-#include <boost/serialization/version.hpp>
-#include <boost/archive/xml_iarchive.hpp>
-#include <boost/archive/xml_oarchive.hpp>
-
-/*****************************************************************************
- *
- ***  class DBlobRenderer
- *
- *  This class is an attempt to keep the Blob Library code free of specific
- *  GUI class code for portability while providing a standard rendering
- *  mechanism for displaying blob data visually.  This class is pure virtual
- *  to force the developer to provide a concrete class if rendering is
- *  desired.  This keeps the library code only dependent on OpenCV and not
- *  any GUI application framework such as Qt, wxWindows, or MFC.
- *
- *****************************************************************************/
-
-class DBlobRenderer
-   {
-   public:
-      DBlobRenderer() = default;
-
-      DBlobRenderer(DBlobRenderer& src) = delete;
-
-      virtual ~DBlobRenderer() = default;
-
-      DBlobRenderer& operator=(DBlobRenderer& rhs) = delete;
-
-      virtual void Point(int nRow, int nCol, cv::Scalar Color) = 0;
-      virtual void Line(int nX1, int nY1, int nX2, int nY2,
-            const cv::Scalar& Color, int nThickness = 1) = 0;
-      virtual void Circle(int nXCenter, int nYCenter, int nRadius,
-            const cv::Scalar& Color, int nThickness = 1) = 0;
-      virtual void Rectangle(int xTopLeft, int yTopLeft, int nWidth,
-            int nHeight, const cv::Scalar& Color, int nThickness = 1) = 0;
-
-      virtual void CrossHairs(int nXCenter, int nYCenter, int nDiameter,
-            const cv::Scalar& Color, bool bCircle = true, int nThickness = 1)
-         {
-         int nHS = nDiameter / 2;
-         // Horizontal hair
-         Line((nXCenter - nHS), nYCenter, (nXCenter + nHS), nYCenter, Color,
-               nThickness);
-         // Vertical hair
-         Line(nXCenter, (nYCenter - nHS), nXCenter, (nYCenter + nHS), Color,
-               nThickness);
-
-         if (bCircle)
-            {
-            Circle(nXCenter, nYCenter, nHS, Color, nThickness);
-            } // end if
-
-         return;
-         }
-
-      virtual void ClearBackground(const cv::Scalar& Color) = 0;
-
-   protected:
-
-   private:
-
-   }; // end of class DBlobRenderer
-
-/*****************************************************************************
- *
- ***  class DCVBlobRenderer
- *
- *  Reference example of a concrete DBlobRenderer for rendering blobs on a
- *  DCVImage (cv::Mat OpenCV Image).
- *
- *****************************************************************************/
-
-class DCVBlobRenderer : public DBlobRenderer
-   {
-   public:
-      DCVBlobRenderer() :
-            m_pImage(nullptr)
-         {
-         return;
-         }
-
-      DCVBlobRenderer(DCVImage* pImage) :
-            m_pImage(pImage)
-         {
-         return;
-         }
-
-      DCVBlobRenderer(const DCVBlobRenderer& src) = delete;
-
-      ~DCVBlobRenderer() = default;
-
-      DCVBlobRenderer& operator=(const DCVBlobRenderer& rhs) = delete;
-
-      void SetImage(DCVImage* pImage)
-         {
-         m_pImage = pImage;
-         return;
-         }
-
-      DCVImage* GetImage() const
-         {
-         return (m_pImage);
-         }
-
-      virtual void Point(int nRow, int nCol, cv::Scalar Color)
-         {
-         if (m_pImage != nullptr)
-            {
-            unsigned char* pPixel = m_pImage->GetPixel(nRow, nCol);
-            for (int i = 0 ; i < m_pImage->GetPixelSize() ; i++)
-               {
-               pPixel[i] = static_cast<unsigned char>(Color[i]);
-               } // end for
-
-            } // end if
-         return;
-         }
-
-      virtual void Line(int nX1, int nY1, int nX2, int nY2,
-            const cv::Scalar& Color, int nThickness = 1)
-         {
-         if (m_pImage != nullptr)
-            {
-            m_pImage->Line(cv::Point(nX1, nY1), cv::Point(nX2, nY2), Color,
-                  nThickness);
-            } // end if
-         return;
-         }
-
-      virtual void Circle(int nXCenter, int nYCenter, int nRadius,
-            const cv::Scalar& Color, int nThickness = 1)
-         {
-         if (m_pImage != nullptr)
-            {
-            m_pImage->Circle(cv::Point(nXCenter, nYCenter), nRadius, Color,
-                  nThickness);
-            } // end if
-         return;
-         }
-
-      virtual void Rectangle(int xTopLeft, int yTopLeft, int nWidth,
-            int nHeight, const cv::Scalar& Color, int nThickness = 1)
-         {
-         if (m_pImage != nullptr)
-            {
-            m_pImage->Rectangle(cv::Rect(xTopLeft, yTopLeft, nWidth, nHeight),
-                  Color, nThickness);
-            } // end if
-         return;
-         }
-
-      virtual void ClearBackground(const cv::Scalar& Color)
-         {
-         if (m_pImage != nullptr)
-            {
-            *m_pImage = Color;
-            } // end if
-         return;
-         }
-
-   protected:
-      DCVImage* m_pImage;
-
-   private:
-
-   }; // end of class DCVBlobRenderer
-
-/*****************************************************************************
-*
-***  class DQIBlobRenderer
-*
-*  Reference example of a concrete DBlobRenderer for rendering blobs on a
-*  DQImage (Qt QImage).
-*
-*****************************************************************************/
-
-class DQIBlobRenderer : public DBlobRenderer
-   {
-   public:
-      DQIBlobRenderer() :
-         m_pImage(nullptr)
-         {
-         return;
-         }
-
-      DQIBlobRenderer(const DQIBlobRenderer& src) = delete;
-
-      ~DQIBlobRenderer() = default;
-
-      DQIBlobRenderer& operator=(const DQIBlobRenderer& rhs) = delete;
-
-      void SetImage(DQImage* pImage)
-         {
-         m_pImage = pImage;
-         m_Painter.begin(pImage);
-         return;
-         }
-
-      DQImage* GetImage() const
-         {
-         return (m_pImage);
-         }
-
-      virtual void Point(int nRow, int nCol, cv::Scalar Color)
-         {
-         if (m_pImage != nullptr)
-            {
-            m_Painter.setPen(QColor(Color[2], Color[1], Color[0]));
-            m_Painter.drawPoint(nCol, nRow);
-            } // end if
-         return;
-         }
-
-      virtual void Line(int nX1, int nY1, int nX2, int nY2,
-            const cv::Scalar& Color, int nThickness = 1)
-         {
-         if (m_pImage != nullptr)
-            {
-            QPen Pen(QColor(Color[2], Color[1], Color[0]));
-            Pen.setWidth(nThickness);
-            m_Painter.setPen(Pen);
-            m_Painter.drawLine(nX1, nY1, nX2, nY2);
-            } // end if
-         return;
-         }
-
-       virtual void Circle(int nXCenter, int nYCenter, int nRadius,
-            const cv::Scalar& Color, int nThickness = 1)
-         {
-         if (m_pImage != nullptr)
-            {
-            QPen Pen(QColor(Color[2], Color[1], Color[0]));
-            Pen.setWidth(nThickness);
-            m_Painter.setPen(Pen);
-            m_Painter.drawEllipse(QPoint(nXCenter, nYCenter), nRadius, nRadius);
-            } // end if
-         return;
-         }
-
-        virtual void Rectangle(int xTopLeft, int yTopLeft, int nWidth,
-               int nHeight, const cv::Scalar& Color, int nThickness = 1)
-            {
-            if (m_pImage != nullptr)
-               {
-               QPen Pen(QColor(Color[2], Color[1], Color[0]));
-               Pen.setWidth(nThickness);
-               m_Painter.setPen(Pen);
-               m_Painter.drawRect(xTopLeft, yTopLeft, nWidth, nHeight);                   ;
-               } // end if
-            return;
-            }
-
-      virtual void ClearBackground(const cv::Scalar& Color)
-         {
-         if (m_pImage != nullptr)
-            {
-            m_Painter.fillRect(m_pImage->rect(), QColor(Color[2], Color[1], Color[0]));
-            } // end if
-         return;
-         }
-
-      void End()
-         {
-         m_Painter.end();
-         return;
-         }
-
-   protected:
-      DQImage* m_pImage;
-      QPainter m_Painter;
-
-   private:
-
-   }; // end of class DQIBlobRenderer
-
-/*****************************************************************************
- ***************************** class DColorRange ******************************
- *****************************************************************************/
-
-/*
- This class provides the basis for categorizing colors based on ranges
- in the three color axes.  The meaning of the three axes depends on the
- particular color space used.
- */
-
-template <typename T>
-class DColorRange
-   {
-   public:
-      static const unsigned int m_nVersion = 0;
-
-      using RangeTest = DRangeTest<T>;
-
-      DColorRange() = default;
-
-      DColorRange(const RangeTest& Color1, const RangeTest& Color2,
-            const RangeTest& Color3) :
-            m_Color1(Color1), m_Color2(Color2), m_Color3(Color3)
-         {
-         return;
-         }
-
-      DColorRange(T C1Low, T C1High, T C2Low, T C2High, T C3Low, T C3High) :
-            m_Color1(C1Low, C1High), m_Color2(C2Low, C2High), m_Color3(C3Low,
-                  C3High)
-         {
-         return;
-         }
-
-      DColorRange(const DColorRange& src)
-         {
-         m_Color1 = src.m_Color1;
-         m_Color2 = src.m_Color2;
-         m_Color3 = src.m_Color3;
-         return;
-         }
-
-      ~DColorRange() = default;
-
-      DColorRange& operator=(const DColorRange& rhs)
-         {
-         if (this != &rhs)
-            {
-            m_Color1 = rhs.m_Color1;
-            m_Color2 = rhs.m_Color2;
-            m_Color3 = rhs.m_Color3;
-            } // end if
-
-         return (*this);
-         }
-
-      bool Apply(const T Pixel[3])
-         {
-         return (m_Color1.Apply(Pixel[0]) && m_Color2.Apply(Pixel[1])
-               && m_Color3.Apply(Pixel[2]));
-         }
-
-      const RangeTest& GetColor1() const
-         {
-         return (m_Color1);
-         }
-
-      const RangeTest& GetColor2() const
-         {
-         return (m_Color2);
-         }
-
-      const RangeTest& GetColor3() const
-         {
-         return (m_Color3);
-         }
-
-      RangeTest& GetColor1()
-         {
-         return (m_Color1);
-         }
-
-      RangeTest& GetColor2()
-         {
-         return (m_Color2);
-         }
-
-      RangeTest& GetColor3()
-         {
-         return (m_Color3);
-         }
-
-//      friend class boost::serialization::access;
-//      friend std::ostream & operator<<(std::ostream &os, const DColorRange<T>& gp);
-
-      template<class Archive>
-      void serialize(Archive & ar, const unsigned int /* nVersion */)
-         {
-         ar & boost::serialization::make_nvp("Color1", m_Color1);
-         ar & boost::serialization::make_nvp("Color2", m_Color2);
-         ar & boost::serialization::make_nvp("Color3", m_Color3);
-
-         return;
-         }
-
-   protected:
-      RangeTest m_Color1;
-      RangeTest m_Color2;
-      RangeTest m_Color3;
-
-   private:
-   }; // end of class DColorRange
-
-/* Handle the version information */
-//BOOST_CLASS_VERSION(DColorRange, DColorRange::m_nVersion)
-
-namespace boost
-{
-namespace serialization
-{
-template<typename T>
-struct version<DColorRange<T>>
-   {
-      using type = mpl::int_<DColorRange<T>::m_nVersion>;
-      using tag = mpl::integral_c_tag;
-      BOOST_STATIC_CONSTANT(unsigned int, value = version::type::value);
-      //      enum { value = 0 };
-   };
-
-template<typename T>
-const unsigned int version<DColorRange<T>>::value;
-
-} // end namespace serialization
-} // end namespace boost
-
-/*****************************************************************************
- *
- ***  class DRun
- *
- * Identifies a continuous run (line segment) of similar pixels in a
- * row (horizontal scanline).
- *
- *****************************************************************************/
-
-class DRun
-   {
-   public:
-      DRun() : m_nBlob(-1), m_nRow(-1), m_nStart(-1), m_nEnd(-1), m_nColor(-1)
-         {
-         return;
-         }
-
-      DRun(int nRow, int nStart, int nEnd, int nColor, int nBlob = -1) :
-            m_nBlob(nBlob),
-            m_nRow(nRow),
-            m_nStart(nStart),
-            m_nEnd(nEnd),
-            m_nColor(nColor)
-         {
-         return;
-         }
-
-      DRun(const DRun& src)
-         {
-         Copy(src);
-         return;
-         }
-
-      ~DRun() = default;
-
-      DRun& operator=(const DRun& rhs)
-         {
-         if (this != &rhs)
-            {
-            Copy(rhs);
-            } // end if
-         return (*this);
-         }
-
-      void Copy(const DRun& src)
-         {
-         m_nBlob = src.m_nBlob;
-         m_nRow = src.m_nRow;
-         m_nStart = src.m_nStart;
-         m_nEnd = src.m_nEnd;
-         m_nColor = src.m_nColor;
-
-         return;
-         }
-
-      int GetBlob() const
-         {
-         return (m_nBlob);
-         }
-
-      void SetBlob(int nBlob)
-         {
-         m_nBlob = nBlob;
-         return;
-         }
-
-      int GetStart() const
-         {
-         return (m_nStart);
-         }
-
-      int GetEnd() const
-         {
-         return (m_nEnd);
-         }
-
-      int GetRow() const
-         {
-         return (m_nRow);
-         }
-
-      int GetColor() const
-         {
-         return (m_nColor);
-         }
-
-      void SetColor(int nColor)
-         {
-         m_nColor = nColor;
-         return;
-         }
-
-      // Test if this run overlaps the passed Run.
-      bool Overlap(const DRun& Run) const
-         {
-         return (((m_nStart >= Run.m_nStart) && (m_nStart <= Run.m_nEnd))
-               || ((m_nEnd >= Run.m_nStart) && (m_nEnd <= Run.m_nEnd))
-               || ((Run.m_nStart >= m_nStart) && (Run.m_nStart <= m_nEnd))
-               || ((Run.m_nEnd >= m_nStart) && (Run.m_nEnd <= m_nEnd)));
-         }
-
-   protected:
-      int m_nBlob;
-      int m_nRow;
-      int m_nStart;
-      int m_nEnd;
-      int m_nColor;
-
-   private:
-
-   }; // end of class DRun
-
-/*****************************************************************************
- *
- ***  class DBlob
- *
- * Class for the properties of a single blob (a contiguous area of
- * similar color).
- *
- *****************************************************************************/
-
-class DBlob
-   {
-   public:
-      using DBlobColorRange = DColorRange<unsigned char>;
-      using DIDVector = std::vector<int>;
-
-      // Helper flags for the display functions
-      enum EDisplay
-         {
-         eBlob = 1, eBoundingRect = 2, eCrossHairs = 4, eAll = eBlob | eBoundingRect | eCrossHairs,
-         };
-
-      DBlob();
-
-      DBlob(int nID, int nType);
-
-      DBlob(const DBlob& src)
-         {
-         Copy(src);
-
-         return;
-         }
-
-      ~DBlob() = default;
-
-      DBlob& operator=(const DBlob& rhs)
-         {
-         if (this != &rhs)
-            {
-            Copy(rhs);
-            } // end if
-
-         return (*this);
-         }
-
-      void AddRun(DRun& Run);
-      void Merge(DBlob& Blob);
-
-      int GetID() const
-         {
-         return (m_nID);
-         }
-
-      double GetArea() const
-         {
-         return (m_Moments.m00);
-         }
-
-      double GetCentroidX() const
-         {
-         return ((m_Moments.m00 > 0.0) ? m_Moments.m10 / m_Moments.m00 : 0.0);
-         }
-
-      double GetCentroidY() const
-         {
-         return ((m_Moments.m00 > 0.0) ? m_Moments.m01 / m_Moments.m00 : 0.0);
-         }
-
-      void Display(DBlobRenderer* pRenderer, cv::Scalar Color, int nDisplay =
-            eBlob, cv::Scalar CHColor = cv::Scalar(255, 255, 255),
-            int nThickness = 1) const;
-
-      void DisplayBoundingRect(DBlobRenderer* pRenderer, cv::Scalar Color) const
-         {
-         pRenderer->Rectangle(m_rcBound.x, m_rcBound.y, m_rcBound.width, m_rcBound.height, Color);
-
-         return;
-         }
-
-      void DisplayCrossHairs(DBlobRenderer* pRenderer, cv::Scalar Color,
-            int nThickness = 1) const
-         {
-         int nDiameter = std::min(m_rcBound.height, m_rcBound.width);
-         pRenderer->CrossHairs(static_cast<int>(GetCentroidX()),
-               static_cast<int>(GetCentroidY()), nDiameter, Color, nThickness);
-
-         return;
-         }
-
-   protected:
-      int m_nID;
-      int m_nType;
-      cv::Moments m_Moments;
-      float m_fPerimeter;
-      DCVRect m_rcBound;
-      std::vector<DRun> m_Pixels;
-
-      void Init();
-      void Copy(const DBlob& src);
-
-   private:
-
-   }; // end of class DBlob
-
-
-/*****************************************************************************
- *
- ***  class DBlobColor
- *
- *  Class to hold the color ranges used to categorize pixels into blobs.  Also,
- * has the display color to represent the range.
- *
- *****************************************************************************/
-
-class DBlobColor
-   {
-   public:
-      using Vector = std::vector<DBlobColor>;
-      static const unsigned int m_nVersion = 0;
-
-      DBlobColor() = default;
-
-      DBlobColor(const std::string& strName, const DBlob::DBlobColorRange& ColorRange, const DCVRGB& DisplayColor);
-
-      DBlobColor(const DBlobColor& src) :
-            m_strName(src.m_strName),
-            m_ColorRange(src.m_ColorRange),
-            m_DisplayColor(src.m_DisplayColor)
-         {
-         return;
-         }
-
-      ~DBlobColor() = default;
-
-      DBlobColor& operator=(const DBlobColor& rhs)
-         {
-         if (this != &rhs)
-            {
-            m_strName = rhs.m_strName;
-            m_ColorRange = rhs.m_ColorRange;
-            m_DisplayColor = rhs.m_DisplayColor;
-            } // end if
-
-         return (*this);
-         }
-
-      // Is the pixel a member of this color?
-      bool ComparePixel(const unsigned char Pixel[3])
-         {
-         return (m_ColorRange.Apply(Pixel));
-         }
-
-      const DBlob::DBlobColorRange& GetColorRange() const
-         {
-         return (m_ColorRange);
-         }
-
-      DBlob::DBlobColorRange& GetColorRange()
-         {
-         return (m_ColorRange);
-         }
-
-      void SetDisplayColor(const DBlob::DBlobColorRange& ColorRange)
-         {
-         m_ColorRange = ColorRange;
-         return;
-         }
-
-      DCVRGB GetDisplayColor() const
-         {
-         return (m_DisplayColor);
-         }
-
-      void SetDisplayColor(const DCVRGB& Color)
-         {
-         m_DisplayColor = Color;
-         return;
-         }
-
-      template<class Archive>
-      void save(Archive& ar, const unsigned int /* nVersion */) const
-         {
-         ar << boost::serialization::make_nvp("ColorName", m_strName);
-         ar << boost::serialization::make_nvp("ColorRange", m_ColorRange);
-         ar << boost::serialization::make_nvp("DisplayColor", m_DisplayColor);
-
-         return;
-         }
-
-      template<class Archive>
-      void load(Archive& ar, const unsigned int /* nVersion */)
-         {
-         ar >> boost::serialization::make_nvp("ColorName", m_strName);
-         ar >> boost::serialization::make_nvp("ColorRange", m_ColorRange);
-         ar >> boost::serialization::make_nvp("DisplayColor", m_DisplayColor);
-
-         return;
-         }
-
-      BOOST_SERIALIZATION_SPLIT_MEMBER()
-
-   protected:
-      // Name of the blob color
-      std::string m_strName;
-      // Color range defining the pixels to include in the blob
-      DBlob::DBlobColorRange m_ColorRange;
-      // Single color to display to represent the blob
-      DCVRGB m_DisplayColor;
-
-   private:
-}; // end of class DBlobColor
-
-BOOST_CLASS_VERSION(DBlobColor, DBlobColor::m_nVersion)
-
-/*****************************************************************************
- *
- ***  class DBlobMap
- *
- *****************************************************************************/
-
-using DBlobMapBase = std::map<int, DBlob>;
-
-class DBlobMap : public DBlobMapBase
-   {
-   public:
-      using DSearchPair = std::pair<bool, DBlobMap::iterator>;
-      using DConstSearchPair = std::pair<bool, DBlobMap::const_iterator>;
-
-      DBlobMap() = default;
-
-      DBlobMap(const DBlobMap& src) :
-            DBlobMapBase(src)
-         {
-         return;
-         }
-
-      ~DBlobMap() = default;
-
-      DBlobMap& operator=(const DBlobMap& rhs)
-         {
-         DBlobMapBase::operator=(rhs);
-         return (*this);
-         }
-
-      int RemoveSmallBlobs(double dMinArea);
-
-      int FindLargestBlob() const;
-
-   protected:
-
-   private:
-
-}; // end of class DBlobMap
-
-/*****************************************************************************
- *
- ***  class DBlobs
- *
- *  Class to contain all the blobs found in an image.  It is a vector of maps.
- * There's one vector element (map) for each color.  The maps are keyed on
- * blob ID.
- *
- *****************************************************************************/
-
-using DBlobsBase = std::vector<DBlobMap>;
-
-class DBlobs : public DBlobsBase
-   {
-   public:
-      DBlobs() = default;
-
-      DBlobs(const DBlobs& src) :
-            DBlobsBase(src)
-         {
-         return;
-         }
-
-      ~DBlobs() = default;
-
-      DBlobs& operator=(const DBlobs& rhs)
-         {
-         DBlobsBase::operator=(rhs);
-         return (*this);
-         }
-
-      DBlobMap::DSearchPair FindBlob(int nID);
-      DBlobMap::DConstSearchPair FindBlob(int nID) const;
-
-      // Remove blobs smaller than specified area, return count of removed
-      int RemoveSmallBlobs(double dMinArea);
-      int RemoveSmallBlobs(int nColor, double dMinArea);
-
-      void FindLargestBlobs(DBlob::DIDVector& Largest) const;
-
-      // Display all the blobs of one category
-      void DisplayBlobs(DBlobRenderer* pRenderer, const DBlobMap& BlobMap,
-            cv::Scalar BlobColor, int nDisplay = DBlob::eBlob,
-            cv::Scalar CHColor = cv::Scalar(255, 255, 255),
-            int nThickness = 1) const;
-
-      // Display ALL blobs      
-      void DisplayBlobs(DBlobRenderer* pRenderer,
-            const DBlobColor::Vector& Colors, int nDisplay = DBlob::eBlob,
-            cv::Scalar CHColor = cv::Scalar(255, 255, 255),
-            int nThickness = 1) const;
-
-      // Display one blob with given ID      
-      bool DisplayBlob(DBlobRenderer* pRenderer, int nBlobID,
-            cv::Scalar BlobColor, int nDisplay = DBlob::eBlob,
-            cv::Scalar CHColor = cv::Scalar(255, 255, 255),
-            int nThickness = 1) const;
-
-      // Display blobs from a vector of IDs
-      int DisplayBlobs(DBlobRenderer* pRenderer,
-            const DBlob::DIDVector& BlobIDs,
-            cv::Scalar BlobColor = cv::Scalar(255, 0, 0), int nDisplay =
-                  DBlob::eBlob, cv::Scalar CHColor = cv::Scalar(255, 255, 255),
-            int nThickness = 1) const;
-
-   protected:
-
-   private:
-
-}; // end of class DBlobs
-
-/*****************************************************************************
- *
- ***  class DColorBlobFinder
- *
- *  Base class for performing the blob finding process.  Derived classes
- * override the color categorization process so different color spaces may
- * be used.  This base class uses the RGB color space by default.
- *
- *****************************************************************************/
-
-class DColorBlobFinder
-   {
-   public:
-      using COLORTYPE = unsigned char;
-
-      DColorBlobFinder()
-         {
-         Init();
-
-         return;
-         }
-
-      DColorBlobFinder(DBlobColor::Vector* pColors);
-
-      DColorBlobFinder(const DColorBlobFinder& src) = delete;
-
-      virtual ~DColorBlobFinder() = default;
-
-      DColorBlobFinder& operator=(const DColorBlobFinder& rhs) = delete;
-
-      bool IsValid() const
-         {
-         return (m_pColors != nullptr);
-         }
-
-      const DBlobs& GetBlobs() const
-         {
-         return (m_Blobs);
-         }
-
-      virtual bool Find(DCVImage* pImage);
-
-      // Remove blobs smaller than specified area, return count of removed
-      int RemoveSmallBlobs(double dMinArea)
-         {
-         return (m_Blobs.RemoveSmallBlobs(dMinArea));
-         }
-
-      // Find the largest blob for each color
-      void FindLargestBlobs(DBlob::DIDVector& Largest) const
-         {
-         m_Blobs.FindLargestBlobs(Largest);
-
-         return;
-         }
-
-      // Scan the image and designate each pixel into a color category
-      virtual void CategorizePixels();
-
-      // Display the background. IE, clear the image
-      void DisplayBackground(DBlobRenderer* pRenderer) const
-         {
-         if (m_pColors != nullptr)
-            {
-            pRenderer->ClearBackground((*m_pColors)[0].GetDisplayColor());
-            } // end if
-
-         return;
-         }
-
-      // Display ALL blobs
-      void DisplayBlobs(DBlobRenderer* pRenderer, int nDisplay = DBlob::eBlob,
-            cv::Scalar CHColor = cv::Scalar(255, 255, 255),
-            int nThickness = 1) const
-         {
-         if (m_pColors != nullptr)
-            {
-            m_Blobs.DisplayBlobs(pRenderer, *m_pColors, nDisplay, CHColor,
-                  nThickness);
-            } // end if
-
-         return;
-         }
-
-      // Display a individual blob by ID
-      bool DisplayBlob(DBlobRenderer* pRenderer, int nBlobID,
-            cv::Scalar BlobColor, int nDisplay = DBlob::eBlob,
-            cv::Scalar CHColor = cv::Scalar(255, 255, 255),
-            int nThickness = 1) const
-         {
-         return (m_Blobs.DisplayBlob(pRenderer, nBlobID, BlobColor, nDisplay,
-               CHColor, nThickness));
-         }
-
-      // Display blobs from a vector of IDs. All blobs will be the specified
-      // color.
-      int DisplayBlobs(DBlobRenderer* pRenderer,
-            const DBlob::DIDVector& BlobIDs,
-            cv::Scalar BlobColor = cv::Scalar(255, 0, 0), int nDisplay =
-                  DBlob::eBlob, cv::Scalar CHColor = cv::Scalar(255, 255, 255),
-            int nThickness = 1) const
-         {
-         return (m_Blobs.DisplayBlobs(pRenderer, BlobIDs, BlobColor, nDisplay,
-               CHColor, nThickness));
-         }
-
-      // Display the largest blob in each category.  Return the count of blobs
-      // displayed.  The current color map will be used.
-      int DisplayLargestBlobs(DBlobRenderer* pRenderer, int nDisplay =
-            DBlob::eBlob, cv::Scalar CHColor = cv::Scalar(255, 255, 255),
-            int nThickness = 1) const;
-
-      virtual void DisplayCategories(DBlobRenderer* pRenderer) const;
-
-      DBlobColor::Vector* GetColors()
-         {
-         return (m_pColors);
-         }
-
-      void SetColors(DBlobColor::Vector* pColors)
-         {
-         m_pColors = pColors;
-
-         return;
-         }
-
-   protected:
-      // Colors used to categorize pixels into blobs
-      // Owned by the calling application.
-      DBlobColor::Vector* m_pColors;
-
-      // Convenience pointer for the current image
-      DCVImage* m_pImage;
-
-      // 2D matrix same size as image with each element the color category of
-      // the corresponding pixel in the imagew
-      DMatrix<COLORTYPE, DArray2D<COLORTYPE>> m_ColorMat;
-
-      // Collection of blobs found
-      DBlobs m_Blobs;
-
-      void Init();
-      virtual void ConvertRGBPixel(unsigned char RGBPixel[3], unsigned char Pixel[3]);
-      bool AllocateMemory();
-
-      bool Find();
-      void FindRuns();
-
-   private:
-
-   }; // end of class DColorBlobFinder
-
-/*****************************************************************************
- *
- ***  class DColorBlobFinderHSV
- *
- * Blob Finder using the HSV color space for pixel categorization.
- *
- *****************************************************************************/
-
-class DColorBlobFinderHSV : public DColorBlobFinder
-   {
-   public:
-      DColorBlobFinderHSV() = default;
-
-      DColorBlobFinderHSV(DBlobColor::Vector* pColors) :
-            DColorBlobFinder(pColors)
-         {
-         return;
-         }
-
-      DColorBlobFinderHSV(const DColorBlobFinderHSV& src) = delete;
-
-      ~DColorBlobFinderHSV() = default;
-
-      DColorBlobFinderHSV& operator=(const DColorBlobFinderHSV& rhs) = delete;
-
-      virtual void ConvertRGBPixel(unsigned char RGBPixel[3], unsigned char Pixel[3]) override
-         {
-         DColorHSV HSV(RGBPixel[DCVImage::EColor::eRed], RGBPixel[DCVImage::EColor::eGreen],
-               RGBPixel[DCVImage::EColor::eBlue]);
-         HSV.ScaleTo255(Pixel);
-
-         return;
-         }
-
-      virtual bool Find(DCVImage* pImage) override
-         {
-         WrapHue();
-
-         return (DColorBlobFinder::Find(pImage));
-         }
-
-   protected:
-      // Hue is circular so make sure we test that way
-      void WrapHue()
-         {
-         for (auto& Color : *m_pColors)
-            {
-            Color.GetColorRange().GetColor1().SetCircular(true);
-            } // end for
-
-         return;
-         }
-
-   private:
-
-   }; // end of class DColorBlobFinderHSV
-
-/*****************************************************************************
- *
- ***  class DColorBlobFinderHSL
- *
- * Blob Finder using the HSL color space for pixel categorization.
- *
- *****************************************************************************/
-
-class DColorBlobFinderHSL : public DColorBlobFinder
-   {
-   public:
-      DColorBlobFinderHSL() = default;
-
-      DColorBlobFinderHSL(DBlobColor::Vector* pColors) :
-            DColorBlobFinder(pColors)
-         {
-         return;
-         }
-
-      DColorBlobFinderHSL(const DColorBlobFinderHSL& src) = delete;
-
-      virtual ~DColorBlobFinderHSL() = default;
-
-      DColorBlobFinderHSL& operator=(const DColorBlobFinderHSL& rhs) = delete;
-
-      virtual void ConvertRGBPixel(unsigned char RGBPixel[3], unsigned char Pixel[3]) override
-         {
-         DColorHSL HSL(RGBPixel[DCVImage::EColor::eRed], RGBPixel[DCVImage::EColor::eGreen],
-               RGBPixel[DCVImage::EColor::eBlue]);
-         HSL.ScaleTo255(Pixel);
-
-         return;
-         }
-
-      virtual bool Find(DCVImage* pImage) override
-         {
-         WrapHue();
-         return (DColorBlobFinder::Find(pImage));
-         }
-
-   protected:
-      // Hue is circular so make sure we test that way
-      void WrapHue()
-         {
-         for (auto& Color : *m_pColors)
-            {
-            Color.GetColorRange().GetColor1().SetCircular(true);
-            } // end for
-
-         return;
-         }
-
-   private:
-
-   }; // end of class DColorBlobFinderHSL
-
-#endif // __DBLOBS_H__
+/*****************************************************************************
+ ********************************* DBlobs.h ***********************************
+ *****************************************************************************/
+
+#if !defined(__DBLOBS_H__)
+#define __DBLOBS_H__
+
+#pragma once
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+//#include "DConfig.h"
+#include <QPainter>
+#include <QDebug>
+
+#include "DMath.h"
+#include "DMatrix.h"
+#include "CVImage.h"
+#include "DQImage.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <functional>
+#include <algorithm>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+//#include <boost/array.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include "DQOpenCV.h"
+#include "DBlobsSIMD.h"
+#include "DThreadPool.h"
+#include "DBlobTracker.h"
+
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/version.hpp>
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/xml_oarchive.hpp>
+
+/*****************************************************************************
+ *
+ ***  class DBlobRenderer
+ *
+ *  This class is an attempt to keep the Blob Library code free of specific
+ *  GUI class code for portability while providing a standard rendering
+ *  mechanism for displaying blob data visually.  This class is pure virtual
+ *  to force the developer to provide a concrete class if rendering is
+ *  desired.  This keeps the library code only dependent on OpenCV and not
+ *  any GUI application framework such as Qt, wxWindows, or MFC.
+ *
+ *****************************************************************************/
+
+class DBlobRenderer
+   {
+   public:
+      DBlobRenderer() = default;
+
+      DBlobRenderer(DBlobRenderer& src) = delete;
+
+      virtual ~DBlobRenderer() = default;
+
+      DBlobRenderer& operator=(DBlobRenderer& rhs) = delete;
+
+      virtual void Point(int nRow, int nCol, cv::Scalar Color) = 0;
+      virtual void Line(int nX1, int nY1, int nX2, int nY2,
+            const cv::Scalar& Color, int nThickness = 1) = 0;
+      virtual void Circle(int nXCenter, int nYCenter, int nRadius,
+            const cv::Scalar& Color, int nThickness = 1) = 0;
+      virtual void Rectangle(int xTopLeft, int yTopLeft, int nWidth,
+            int nHeight, const cv::Scalar& Color, int nThickness = 1) = 0;
+
+      virtual void CrossHairs(int nXCenter, int nYCenter, int nDiameter,
+            const cv::Scalar& Color, bool bCircle = true, int nThickness = 1)
+         {
+         int nHS = nDiameter / 2;
+         // Horizontal hair
+         Line((nXCenter - nHS), nYCenter, (nXCenter + nHS), nYCenter, Color,
+               nThickness);
+         // Vertical hair
+         Line(nXCenter, (nYCenter - nHS), nXCenter, (nYCenter + nHS), Color,
+               nThickness);
+
+         if (bCircle)
+            {
+            Circle(nXCenter, nYCenter, nHS, Color, nThickness);
+            } // end if
+
+         return;
+         }
+
+      virtual void ClearBackground(const cv::Scalar& Color) = 0;
+
+   protected:
+
+   private:
+
+   }; // end of class DBlobRenderer
+
+/*****************************************************************************
+ *
+ ***  class DCVBlobRenderer
+ *
+ *  Reference example of a concrete DBlobRenderer for rendering blobs on a
+ *  DCVImage (cv::Mat OpenCV Image).
+ *
+ *****************************************************************************/
+
+class DCVBlobRenderer : public DBlobRenderer
+   {
+   public:
+      DCVBlobRenderer() :
+            m_pImage(nullptr)
+         {
+         return;
+         }
+
+      DCVBlobRenderer(DCVImage* pImage) :
+            m_pImage(pImage)
+         {
+         return;
+         }
+
+      DCVBlobRenderer(const DCVBlobRenderer& src) = delete;
+
+      ~DCVBlobRenderer() = default;
+
+      DCVBlobRenderer& operator=(const DCVBlobRenderer& rhs) = delete;
+
+      void SetImage(DCVImage* pImage)
+         {
+         m_pImage = pImage;
+         return;
+         }
+
+      DCVImage* GetImage() const
+         {
+         return (m_pImage);
+         }
+
+      virtual void Point(int nRow, int nCol, cv::Scalar Color)
+         {
+         if (m_pImage != nullptr)
+            {
+            unsigned char* pPixel = m_pImage->GetPixel(nRow, nCol);
+            for (int i = 0 ; i < m_pImage->GetPixelSize() ; i++)
+               {
+               pPixel[i] = static_cast<unsigned char>(Color[i]);
+               } // end for
+
+            } // end if
+         return;
+         }
+
+      virtual void Line(int nX1, int nY1, int nX2, int nY2,
+            const cv::Scalar& Color, int nThickness = 1)
+         {
+         if (m_pImage != nullptr)
+            {
+            m_pImage->Line(cv::Point(nX1, nY1), cv::Point(nX2, nY2), Color,
+                  nThickness);
+            } // end if
+         return;
+         }
+
+      virtual void Circle(int nXCenter, int nYCenter, int nRadius,
+            const cv::Scalar& Color, int nThickness = 1)
+         {
+         if (m_pImage != nullptr)
+            {
+            m_pImage->Circle(cv::Point(nXCenter, nYCenter), nRadius, Color,
+                  nThickness);
+            } // end if
+         return;
+         }
+
+      virtual void Rectangle(int xTopLeft, int yTopLeft, int nWidth,
+            int nHeight, const cv::Scalar& Color, int nThickness = 1)
+         {
+         if (m_pImage != nullptr)
+            {
+            m_pImage->Rectangle(cv::Rect(xTopLeft, yTopLeft, nWidth, nHeight),
+                  Color, nThickness);
+            } // end if
+         return;
+         }
+
+      virtual void ClearBackground(const cv::Scalar& Color)
+         {
+         if (m_pImage != nullptr)
+            {
+            *m_pImage = Color;
+            } // end if
+         return;
+         }
+
+   protected:
+      DCVImage* m_pImage;
+
+   private:
+
+   }; // end of class DCVBlobRenderer
+
+/*****************************************************************************
+*
+***  class DQIBlobRenderer
+*
+*  Reference example of a concrete DBlobRenderer for rendering blobs on a
+*  DQImage (Qt QImage).
+*
+*****************************************************************************/
+
+class DQIBlobRenderer : public DBlobRenderer
+   {
+   public:
+      DQIBlobRenderer() :
+         m_pImage(nullptr)
+         {
+         return;
+         }
+
+      DQIBlobRenderer(const DQIBlobRenderer& src) = delete;
+
+      ~DQIBlobRenderer() = default;
+
+      DQIBlobRenderer& operator=(const DQIBlobRenderer& rhs) = delete;
+
+      void SetImage(DQImage* pImage)
+         {
+         m_pImage = pImage;
+         m_Painter.begin(pImage);
+         return;
+         }
+
+      DQImage* GetImage() const
+         {
+         return (m_pImage);
+         }
+
+      virtual void Point(int nRow, int nCol, cv::Scalar Color)
+         {
+         if (m_pImage != nullptr)
+            {
+            m_Painter.setPen(QColor(Color[2], Color[1], Color[0]));
+            m_Painter.drawPoint(nCol, nRow);
+            } // end if
+         return;
+         }
+
+      virtual void Line(int nX1, int nY1, int nX2, int nY2,
+            const cv::Scalar& Color, int nThickness = 1)
+         {
+         if (m_pImage != nullptr)
+            {
+            QPen Pen(QColor(Color[2], Color[1], Color[0]));
+            Pen.setWidth(nThickness);
+            m_Painter.setPen(Pen);
+            m_Painter.drawLine(nX1, nY1, nX2, nY2);
+            } // end if
+         return;
+         }
+
+       virtual void Circle(int nXCenter, int nYCenter, int nRadius,
+            const cv::Scalar& Color, int nThickness = 1)
+         {
+         if (m_pImage != nullptr)
+            {
+            QPen Pen(QColor(Color[2], Color[1], Color[0]));
+            Pen.setWidth(nThickness);
+            m_Painter.setPen(Pen);
+            m_Painter.drawEllipse(QPoint(nXCenter, nYCenter), nRadius, nRadius);
+            } // end if
+         return;
+         }
+
+        virtual void Rectangle(int xTopLeft, int yTopLeft, int nWidth,
+               int nHeight, const cv::Scalar& Color, int nThickness = 1)
+            {
+            if (m_pImage != nullptr)
+               {
+               QPen Pen(QColor(Color[2], Color[1], Color[0]));
+               Pen.setWidth(nThickness);
+               m_Painter.setPen(Pen);
+               m_Painter.drawRect(xTopLeft, yTopLeft, nWidth, nHeight);                   ;
+               } // end if
+            return;
+            }
+
+      virtual void ClearBackground(const cv::Scalar& Color)
+         {
+         if (m_pImage != nullptr)
+            {
+            m_Painter.fillRect(m_pImage->rect(), QColor(Color[2], Color[1], Color[0]));
+            } // end if
+         return;
+         }
+
+      void End()
+         {
+         m_Painter.end();
+         return;
+         }
+
+   protected:
+      DQImage* m_pImage;
+      QPainter m_Painter;
+
+   private:
+
+   }; // end of class DQIBlobRenderer
+
+/*****************************************************************************
+ ***************************** class DColorRange ******************************
+ *****************************************************************************/
+
+/*
+ This class provides the basis for categorizing colors based on ranges
+ in the three color axes.  The meaning of the three axes depends on the
+ particular color space used.
+ */
+
+template <typename T>
+class DColorRange
+   {
+   public:
+      static const unsigned int m_nVersion = 0;
+
+      using RangeTest = DRangeTest<T>;
+
+      DColorRange() = default;
+
+      DColorRange(const RangeTest& Color1, const RangeTest& Color2,
+            const RangeTest& Color3) :
+            m_Color1(Color1), m_Color2(Color2), m_Color3(Color3)
+         {
+         return;
+         }
+
+      DColorRange(T C1Low, T C1High, T C2Low, T C2High, T C3Low, T C3High) :
+            m_Color1(C1Low, C1High), m_Color2(C2Low, C2High), m_Color3(C3Low,
+                  C3High)
+         {
+         return;
+         }
+
+      DColorRange(const DColorRange& src)
+         {
+         m_Color1 = src.m_Color1;
+         m_Color2 = src.m_Color2;
+         m_Color3 = src.m_Color3;
+         return;
+         }
+
+      ~DColorRange() = default;
+
+      DColorRange& operator=(const DColorRange& rhs)
+         {
+         if (this != &rhs)
+            {
+            m_Color1 = rhs.m_Color1;
+            m_Color2 = rhs.m_Color2;
+            m_Color3 = rhs.m_Color3;
+            } // end if
+
+         return (*this);
+         }
+
+      bool Apply(const T Pixel[3])
+         {
+         return (m_Color1.Apply(Pixel[0]) && m_Color2.Apply(Pixel[1])
+               && m_Color3.Apply(Pixel[2]));
+         }
+
+      const RangeTest& GetColor1() const
+         {
+         return (m_Color1);
+         }
+
+      const RangeTest& GetColor2() const
+         {
+         return (m_Color2);
+         }
+
+      const RangeTest& GetColor3() const
+         {
+         return (m_Color3);
+         }
+
+      RangeTest& GetColor1()
+         {
+         return (m_Color1);
+         }
+
+      RangeTest& GetColor2()
+         {
+         return (m_Color2);
+         }
+
+      RangeTest& GetColor3()
+         {
+         return (m_Color3);
+         }
+
+//      friend class boost::serialization::access;
+//      friend std::ostream & operator<<(std::ostream &os, const DColorRange<T>& gp);
+
+      template<class Archive>
+      void serialize(Archive & ar, const unsigned int /* nVersion */)
+         {
+         ar & boost::serialization::make_nvp("Color1", m_Color1);
+         ar & boost::serialization::make_nvp("Color2", m_Color2);
+         ar & boost::serialization::make_nvp("Color3", m_Color3);
+
+         return;
+         }
+
+   protected:
+      RangeTest m_Color1;
+      RangeTest m_Color2;
+      RangeTest m_Color3;
+
+   private:
+   }; // end of class DColorRange
+
+/* Handle the version information */
+//BOOST_CLASS_VERSION(DColorRange, DColorRange::m_nVersion)
+
+namespace boost
+{
+namespace serialization
+{
+template<typename T>
+struct version<DColorRange<T>>
+   {
+      using type = mpl::int_<DColorRange<T>::m_nVersion>;
+      using tag = mpl::integral_c_tag;
+      BOOST_STATIC_CONSTANT(unsigned int, value = version::type::value);
+      //      enum { value = 0 };
+   };
+
+template<typename T>
+const unsigned int version<DColorRange<T>>::value;
+
+} // end namespace serialization
+} // end namespace boost
+
+/*****************************************************************************
+ *
+ ***  class DRun
+ *
+ * Identifies a continuous run (line segment) of similar pixels in a
+ * row (horizontal scanline).
+ *
+ *****************************************************************************/
+
+class DRun
+   {
+   public:
+      DRun() : m_nBlob(-1), m_nRow(-1), m_nStart(-1), m_nEnd(-1), m_nColor(-1)
+         {
+         return;
+         }
+
+      DRun(int nRow, int nStart, int nEnd, int nColor, int nBlob = -1) :
+            m_nBlob(nBlob),
+            m_nRow(nRow),
+            m_nStart(nStart),
+            m_nEnd(nEnd),
+            m_nColor(nColor)
+         {
+         return;
+         }
+
+      DRun(const DRun& src)
+         {
+         Copy(src);
+         return;
+         }
+
+      ~DRun() = default;
+
+      DRun& operator=(const DRun& rhs)
+         {
+         if (this != &rhs)
+            {
+            Copy(rhs);
+            } // end if
+         return (*this);
+         }
+
+      void Copy(const DRun& src)
+         {
+         m_nBlob = src.m_nBlob;
+         m_nRow = src.m_nRow;
+         m_nStart = src.m_nStart;
+         m_nEnd = src.m_nEnd;
+         m_nColor = src.m_nColor;
+
+         return;
+         }
+
+      int GetBlob() const
+         {
+         return (m_nBlob);
+         }
+
+      void SetBlob(int nBlob)
+         {
+         m_nBlob = nBlob;
+         return;
+         }
+
+      int GetStart() const
+         {
+         return (m_nStart);
+         }
+
+      int GetEnd() const
+         {
+         return (m_nEnd);
+         }
+
+      int GetRow() const
+         {
+         return (m_nRow);
+         }
+
+      int GetColor() const
+         {
+         return (m_nColor);
+         }
+
+      void SetColor(int nColor)
+         {
+         m_nColor = nColor;
+         return;
+         }
+
+      // Test if this run overlaps the passed Run.
+      bool Overlap(const DRun& Run) const
+         {
+         return (((m_nStart >= Run.m_nStart) && (m_nStart <= Run.m_nEnd))
+               || ((m_nEnd >= Run.m_nStart) && (m_nEnd <= Run.m_nEnd))
+               || ((Run.m_nStart >= m_nStart) && (Run.m_nStart <= m_nEnd))
+               || ((Run.m_nEnd >= m_nStart) && (Run.m_nEnd <= m_nEnd)));
+         }
+
+   protected:
+      int m_nBlob;
+      int m_nRow;
+      int m_nStart;
+      int m_nEnd;
+      int m_nColor;
+
+   private:
+
+   }; // end of class DRun
+
+/*****************************************************************************
+ *
+ ***  class DBlobMoments
+ *
+ * Second and third order spatial moments of a blob, kept apart from DBlob
+ * since most users don't want them.  Each run adds its sums of powers of x
+ * over [Start, End] in closed form so the cost is per run, not per pixel.
+ * The raw moments simply add, so merging blobs is just adding these.
+ *
+ *****************************************************************************/
+
+class DBlobMoments
+   {
+   public:
+      DBlobMoments()
+         {
+         Clear();
+
+         return;
+         }
+
+      DBlobMoments(const DBlobMoments& src) = default;
+
+      ~DBlobMoments() = default;
+
+      DBlobMoments& operator=(const DBlobMoments& rhs) = default;
+
+      void Clear()
+         {
+         m20 = m11 = m02 = m30 = m21 = m12 = m03 = 0.0;
+
+         return;
+         }
+
+      void AddRun(const DRun& Run);
+
+      void Merge(const DBlobMoments& Moments)
+         {
+         m20 += Moments.m20;
+         m11 += Moments.m11;
+         m02 += Moments.m02;
+         m30 += Moments.m30;
+         m21 += Moments.m21;
+         m12 += Moments.m12;
+         m03 += Moments.m03;
+
+         return;
+         }
+
+      double m20, m11, m02;
+      double m30, m21, m12, m03;
+
+   }; // end of class DBlobMoments
+
+/*****************************************************************************
+ *
+ ***  class DBlob
+ *
+ * Class for the properties of a single blob (a contiguous area of
+ * similar color).  The record is kept to one cache line.  Area and the
+ * coordinate sums are exact integers and the centroid is worked out from
+ * them when asked for.  The pixel runs live in the DBlobMap holding the blob,
+ * which the blob refers to by range.
+ *
+ *****************************************************************************/
+
+class DBlob
+   {
+   public:
+      using DBlobColorRange = DColorRange<unsigned char>;
+      using DIDVector = std::vector<int>;
+
+      // Helper flags for the display functions
+      enum EDisplay
+         {
+         eBlob = 1, eBoundingRect = 2, eCrossHairs = 4, eAll = eBlob | eBoundingRect | eCrossHairs,
+         };
+
+      DBlob();
+
+      DBlob(int nID, int nType);
+
+      DBlob(const DBlob& src)
+         {
+         Copy(src);
+
+         return;
+         }
+
+      ~DBlob() = default;
+
+      DBlob& operator=(const DBlob& rhs)
+         {
+         if (this != &rhs)
+            {
+            Copy(rhs);
+            } // end if
+
+         return (*this);
+         }
+
+      // Add a run to the statistics.  The run itself is stored by the map.
+      void AddRun(DRun& Run);
+
+      // Account for nContacts pairs of this blob's runs touching between
+      // rows along a total of nOverlap columns
+      void AddContacts(int nContacts, int nOverlap)
+         {
+         m_nEuler -= nContacts;
+         m_nPerimeter -= 2 * nOverlap;
+
+         return;
+         }
+
+      // Empty the blob for reuse under a new ID.  Without bStoreRuns only
+      // the statistics are kept as runs are added.  bHigherMoments asks the
+      // map to track the blob's DBlobMoments as well.
+      void Reset(int nID, int nType, bool bStoreRuns = true,
+            bool bHigherMoments = false);
+
+      void swap(DBlob& Blob);
+
+      int GetID() const
+         {
+         return (m_nID);
+         }
+
+      int GetType() const
+         {
+         return (m_nType);
+         }
+
+      // False for a statistics only blob, which has no pixel runs to draw
+      bool HasRuns() const
+         {
+         return (m_bStoreRuns);
+         }
+
+      bool HasHigherMoments() const
+         {
+         return (m_bHigherMoments);
+         }
+
+      // Position and count of this blob's runs in its map's run storage
+      int GetFirstRun() const
+         {
+         return (m_nFirstRun);
+         }
+
+      int GetRunCount() const
+         {
+         return (m_nRunCount);
+         }
+
+      double GetArea() const
+         {
+         return (static_cast<double>(m_nArea));
+         }
+
+      double GetCentroidX() const
+         {
+         return ((m_nArea > 0) ? static_cast<double>(m_nSumX) / m_nArea : 0.0);
+         }
+
+      double GetCentroidY() const
+         {
+         return ((m_nArea > 0) ? static_cast<double>(m_nSumY) / m_nArea : 0.0);
+         }
+
+      const DCVRect& GetBoundingRect() const
+         {
+         return (m_rcBound);
+         }
+
+      // Length of the boundary between the blob's pixels and the rest, in
+      // pixel edges, holes included
+      double GetPerimeter() const
+         {
+         return (static_cast<double>(m_nPerimeter));
+         }
+
+      // Runs minus touching run pairs.  Blobs are 4 connected with 8
+      // connected holes, so this is 1 - holes.
+      int GetEulerNumber() const
+         {
+         return (m_nEuler);
+         }
+
+      int GetHoleCount() const
+         {
+         return (1 - m_nEuler);
+         }
+
+      // The spatial moments this blob tracks as OpenCV moments, which fills
+      // in the central and normalized moments too.  Without pHigher only the
+      // area and first moments are set.
+      cv::Moments GetMoments(const DBlobMoments* pHigher = nullptr) const;
+
+      // Angle in radians of the major axis from the x axis.  Image y is down
+      // so positive angles turn clockwise on screen.
+      double GetOrientation(const DBlobMoments& Higher) const;
+
+      // Full axis lengths of the ellipse with the same second moments
+      void GetAxes(const DBlobMoments& Higher, double& dMajor,
+            double& dMinor) const;
+
+      // The seven Hu invariants
+      void GetHuMoments(const DBlobMoments& Higher, double Hu[7]) const;
+
+      // pRuns are the blob's runs, nullptr draws the bounding box instead
+      void Display(DBlobRenderer* pRenderer, const DRun* pRuns,
+            cv::Scalar Color, int nDisplay = eBlob,
+            cv::Scalar CHColor = cv::Scalar(255, 255, 255),
+            int nThickness = 1) const;
+
+      void DisplayBoundingRect(DBlobRenderer* pRenderer, cv::Scalar Color) const
+         {
+         pRenderer->Rectangle(m_rcBound.x, m_rcBound.y, m_rcBound.width, m_rcBound.height, Color);
+
+         return;
+         }
+
+      void DisplayCrossHairs(DBlobRenderer* pRenderer, cv::Scalar Color,
+            int nThickness = 1) const
+         {
+         int nDiameter = std::min(m_rcBound.height, m_rcBound.width);
+         pRenderer->CrossHairs(static_cast<int>(GetCentroidX()),
+               static_cast<int>(GetCentroidY()), nDiameter, Color, nThickness);
+
+         return;
+         }
+
+   protected:
+      // Pixel count and the sums of the pixel x and y coordinates
+      int64_t m_nArea;
+      int64_t m_nSumX;
+      int64_t m_nSumY;
+      DCVRect m_rcBound;
+      int m_nID;
+      // Color category, short to keep the record in a cache line
+      int16_t m_nType;
+      bool m_bStoreRuns;
+      bool m_bHigherMoments;
+      int m_nFirstRun;
+      int m_nRunCount;
+      int m_nPerimeter;
+      int m_nEuler;
+
+      void Init();
+      void Copy(const DBlob& src);
+
+      // The map lays out the run storage
+      friend class DBlobMap;
+
+   private:
+
+   }; // end of class DBlob
+
+static_assert(sizeof(DBlob) <= 64, "DBlob should fit in a cache line");
+
+
+/*****************************************************************************
+ *
+ ***  class DBlobColor
+ *
+ *  Class to hold the color ranges used to categorize pixels into blobs.  Also,
+ * has the display color to represent the range.
+ *
+ *****************************************************************************/
+
+class DBlobColor
+   {
+   public:
+      using Vector = std::vector<DBlobColor>;
+      static const unsigned int m_nVersion = 0;
+
+      DBlobColor() = default;
+
+      DBlobColor(const std::string& strName, const DBlob::DBlobColorRange& ColorRange, const DCVRGB& DisplayColor);
+
+      DBlobColor(const DBlobColor& src) :
+            m_strName(src.m_strName),
+            m_ColorRange(src.m_ColorRange),
+            m_DisplayColor(src.m_DisplayColor)
+         {
+         return;
+         }
+
+      ~DBlobColor() = default;
+
+      DBlobColor& operator=(const DBlobColor& rhs)
+         {
+         if (this != &rhs)
+            {
+            m_strName = rhs.m_strName;
+            m_ColorRange = rhs.m_ColorRange;
+            m_DisplayColor = rhs.m_DisplayColor;
+            } // end if
+
+         return (*this);
+         }
+
+      // Is the pixel a member of this color?
+      bool ComparePixel(const unsigned char Pixel[3])
+         {
+         return (m_ColorRange.Apply(Pixel));
+         }
+
+      const DBlob::DBlobColorRange& GetColorRange() const
+         {
+         return (m_ColorRange);
+         }
+
+      DBlob::DBlobColorRange& GetColorRange()
+         {
+         return (m_ColorRange);
+         }
+
+      void SetDisplayColor(const DBlob::DBlobColorRange& ColorRange)
+         {
+         m_ColorRange = ColorRange;
+         return;
+         }
+
+      DCVRGB GetDisplayColor() const
+         {
+         return (m_DisplayColor);
+         }
+
+      void SetDisplayColor(const DCVRGB& Color)
+         {
+         m_DisplayColor = Color;
+         return;
+         }
+
+      template<class Archive>
+      void save(Archive& ar, const unsigned int /* nVersion */) const
+         {
+         ar << boost::serialization::make_nvp("ColorName", m_strName);
+         ar << boost::serialization::make_nvp("ColorRange", m_ColorRange);
+         ar << boost::serialization::make_nvp("DisplayColor", m_DisplayColor);
+
+         return;
+         }
+
+      template<class Archive>
+      void load(Archive& ar, const unsigned int /* nVersion */)
+         {
+         ar >> boost::serialization::make_nvp("ColorName", m_strName);
+         ar >> boost::serialization::make_nvp("ColorRange", m_ColorRange);
+         ar >> boost::serialization::make_nvp("DisplayColor", m_DisplayColor);
+
+         return;
+         }
+
+      BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+   protected:
+      // Name of the blob color
+      std::string m_strName;
+      // Color range defining the pixels to include in the blob
+      DBlob::DBlobColorRange m_ColorRange;
+      // Single color to display to represent the blob
+      DCVRGB m_DisplayColor;
+
+   private:
+}; // end of class DBlobColor
+
+BOOST_CLASS_VERSION(DBlobColor, DBlobColor::m_nVersion)
+
+/*****************************************************************************
+ *
+ ***  class DBlobMap
+ *
+ *  The blobs of one color.  The blobs are held contiguously and reused from
+ * frame to frame, so finding blobs doesn't allocate once the storage has
+ * grown to fit.  Iterating gives the blobs in the order they were added, as
+ * pairs of blob ID and blob like the std::map<int, DBlob> this used to be,
+ * so it->first and it->second work as before.  The pairs are made on the
+ * fly and returned by value, so bind them with const auto& or auto&& rather
+ * than auto&, and the iterators are input iterators.
+ *
+ *****************************************************************************/
+
+class DBlobMap
+   {
+   public:
+      // A blob's ID and the blob, what iterating the map gives
+      template <class Blob>
+      struct DPair
+         {
+         const int first;
+         Blob& second;
+         };
+
+      template <class Blob, class Slot>
+      class DIterator
+         {
+         public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = DPair<Blob>;
+            using difference_type = std::ptrdiff_t;
+            using reference = DPair<Blob>;
+
+            // Holds the pair it->first and it->second are read from
+            struct pointer
+               {
+               const DPair<Blob>* operator->() const
+                  {
+                  return (&Pair);
+                  }
+
+               DPair<Blob> Pair;
+               };
+
+            DIterator() = default;
+
+            explicit DIterator(Slot itSlot) : m_itSlot(itSlot)
+               {
+               return;
+               }
+
+            // An iterator converts to a const_iterator
+            template <class OtherBlob, class OtherSlot>
+            DIterator(const DIterator<OtherBlob, OtherSlot>& src) :
+                  m_itSlot(src.GetSlot())
+               {
+               return;
+               }
+
+            reference operator*() const
+               {
+               return (reference{ m_itSlot->GetID(), *m_itSlot });
+               }
+
+            pointer operator->() const
+               {
+               return (pointer{ **this });
+               }
+
+            DIterator& operator++()
+               {
+               ++m_itSlot;
+               return (*this);
+               }
+
+            DIterator operator++(int)
+               {
+               DIterator Old(*this);
+               ++m_itSlot;
+               return (Old);
+               }
+
+            template <class OtherBlob, class OtherSlot>
+            bool operator==(const DIterator<OtherBlob, OtherSlot>& rhs) const
+               {
+               return (m_itSlot == rhs.GetSlot());
+               }
+
+            template <class OtherBlob, class OtherSlot>
+            bool operator!=(const DIterator<OtherBlob, OtherSlot>& rhs) const
+               {
+               return (m_itSlot != rhs.GetSlot());
+               }
+
+            Slot GetSlot() const
+               {
+               return (m_itSlot);
+               }
+
+         private:
+            Slot m_itSlot;
+
+         }; // end of class DIterator
+
+      using iterator = DIterator<DBlob, std::vector<DBlob>::iterator>;
+      using const_iterator = DIterator<const DBlob,
+            std::vector<DBlob>::const_iterator>;
+      using DSearchPair = std::pair<bool, DBlobMap::iterator>;
+      using DConstSearchPair = std::pair<bool, DBlobMap::const_iterator>;
+
+      DBlobMap() : m_nSize(0), m_bLargestValid(false)
+         {
+         return;
+         }
+
+      DBlobMap(const DBlobMap& src) = default;
+
+      ~DBlobMap() = default;
+
+      DBlobMap& operator=(const DBlobMap& rhs) = default;
+
+      iterator begin()
+         {
+         return (iterator(m_Blobs.begin()));
+         }
+
+      iterator end()
+         {
+         return (iterator(m_Blobs.begin() + m_nSize));
+         }
+
+      const_iterator begin() const
+         {
+         return (const_iterator(m_Blobs.cbegin()));
+         }
+
+      const_iterator end() const
+         {
+         return (const_iterator(m_Blobs.cbegin() + m_nSize));
+         }
+
+      size_t size() const
+         {
+         return (m_nSize);
+         }
+
+      bool empty() const
+         {
+         return (m_nSize == 0);
+         }
+
+      // Remove all the blobs.  Their storage is kept for the next frame.
+      void clear();
+
+      // Start a new blob.  nID must not already be in the map.
+      DBlob& Add(int nID, int nType, bool bStoreRuns = true,
+            bool bHigherMoments = false);
+
+      // Add a run to one of this map's blobs including its higher moments
+      void AddRun(DBlob& Blob, DRun& Run)
+         {
+         Blob.AddRun(Run);
+         if (Blob.HasHigherMoments())
+            {
+            m_HigherMoments[&Blob - m_Blobs.data()].AddRun(Run);
+            } // end if
+
+         return;
+         }
+
+      // Second and third order moments of Blob, nullptr if not tracked
+      const DBlobMoments* GetHigherMoments(const DBlob& Blob) const
+         {
+         return (Blob.HasHigherMoments()
+               ? &m_HigherMoments[m_Index[Blob.GetID()]] : nullptr);
+         }
+
+      iterator find(int nID)
+         {
+         return (((nID >= 0) && (nID < static_cast<int>(m_Index.size()))
+               && (m_Index[nID] >= 0)) ? iterator(m_Blobs.begin() + m_Index[nID])
+               : end());
+         }
+
+      const_iterator find(int nID) const
+         {
+         return (((nID >= 0) && (nID < static_cast<int>(m_Index.size()))
+               && (m_Index[nID] >= 0))
+               ? const_iterator(m_Blobs.cbegin() + m_Index[nID]) : end());
+         }
+
+      int RemoveSmallBlobs(double dMinArea);
+
+      // The largest blob's ID, straight from the largest blob list if the
+      // finder made one
+      int FindLargestBlob() const;
+
+      // Largest blobs first, ties in ID order.  Made by the finder while
+      // labeling when asked for; HasLargest is false otherwise.
+      void SetLargest(DBlob::DIDVector& Largest)
+         {
+         m_Largest.swap(Largest);
+         m_bLargestValid = true;
+
+         return;
+         }
+
+      bool HasLargest() const
+         {
+         return (m_bLargestValid);
+         }
+
+      const DBlob::DIDVector& GetLargest() const
+         {
+         return (m_Largest);
+         }
+
+      // The runs of Blob in row order or nullptr if it doesn't keep them
+      const DRun* GetRuns(const DBlob& Blob) const
+         {
+         return ((Blob.HasRuns() && (Blob.GetRunCount() > 0))
+               ? &m_Runs[Blob.GetFirstRun()] : nullptr);
+         }
+
+      // Once every run has been added to its blob's statistics, make room
+      // for the runs and then store each one under the blob it was given.
+      // Storing the runs in scan order keeps each blob's runs in row order.
+      void ReserveRuns();
+      void StoreRun(const DRun& Run);
+
+   protected:
+      // Blobs in the order they were added.  Only the first m_nSize are in
+      // use, the rest are spares left from earlier frames.
+      std::vector<DBlob> m_Blobs;
+      size_t m_nSize;
+
+      // Slot of each blob by ID, -1 if the ID isn't in this map.  Blob IDs
+      // are dense so this stays small.
+      std::vector<int> m_Index;
+
+      // Runs of all the blobs, each blob's runs together
+      std::vector<DRun> m_Runs;
+      // Runs stored so far for each blob slot while filling m_Runs
+      std::vector<int> m_RunFill;
+
+      // Higher moments by blob slot for the blobs that track them
+      std::vector<DBlobMoments> m_HigherMoments;
+
+      // IDs of the largest blobs, largest first
+      DBlob::DIDVector m_Largest;
+      bool m_bLargestValid;
+
+   private:
+
+}; // end of class DBlobMap
+
+/*****************************************************************************
+ *
+ ***  class DBlobs
+ *
+ *  Class to contain all the blobs found in an image.  It is a vector of maps.
+ * There's one vector element (map) for each color.  The maps are indexed by
+ * blob ID.
+ *
+ *****************************************************************************/
+
+using DBlobsBase = std::vector<DBlobMap>;
+
+class DBlobs : public DBlobsBase
+   {
+   public:
+      DBlobs() = default;
+
+      DBlobs(const DBlobs& src) :
+            DBlobsBase(src),
+            m_Parents(src.m_Parents),
+            m_FirstChild(src.m_FirstChild),
+            m_Children(src.m_Children)
+         {
+         return;
+         }
+
+      ~DBlobs() = default;
+
+      DBlobs& operator=(const DBlobs& rhs)
+         {
+         DBlobsBase::operator=(rhs);
+         m_Parents = rhs.m_Parents;
+         m_FirstChild = rhs.m_FirstChild;
+         m_Children = rhs.m_Children;
+         return (*this);
+         }
+
+      DBlobMap::DSearchPair FindBlob(int nID);
+      DBlobMap::DConstSearchPair FindBlob(int nID) const;
+
+      // Remove blobs smaller than specified area, return count of removed
+      int RemoveSmallBlobs(double dMinArea);
+      int RemoveSmallBlobs(int nColor, double dMinArea);
+
+      void FindLargestBlobs(DBlob::DIDVector& Largest) const;
+
+      // Containment tree.  Parents is indexed by blob ID and gives the ID of
+      // the nearest blob of another color whose hole holds the blob, or -1.
+      // RemoveSmallBlobs takes the blobs it removes out of the tree.
+      void SetParents(std::vector<int>& Parents);
+      void ClearTree();
+
+      int GetParent(int nID) const
+         {
+         return (((nID >= 0) && (nID < static_cast<int>(m_Parents.size())))
+               ? m_Parents[nID] : -1);
+         }
+
+      // Fill Children with the IDs of the blobs directly inside nID
+      void GetChildren(int nID, DBlob::DIDVector& Children) const;
+
+      // Display all the blobs of one category
+      void DisplayBlobs(DBlobRenderer* pRenderer, const DBlobMap& BlobMap,
+            cv::Scalar BlobColor, int nDisplay = DBlob::eBlob,
+            cv::Scalar CHColor = cv::Scalar(255, 255, 255),
+            int nThickness = 1) const;
+
+      // Display ALL blobs      
+      void DisplayBlobs(DBlobRenderer* pRenderer,
+            const DBlobColor::Vector& Colors, int nDisplay = DBlob::eBlob,
+            cv::Scalar CHColor = cv::Scalar(255, 255, 255),
+            int nThickness = 1) const;
+
+      // Display one blob with given ID      
+      bool DisplayBlob(DBlobRenderer* pRenderer, int nBlobID,
+            cv::Scalar BlobColor, int nDisplay = DBlob::eBlob,
+            cv::Scalar CHColor = cv::Scalar(255, 255, 255),
+            int nThickness = 1) const;
+
+      // Display blobs from a vector of IDs
+      int DisplayBlobs(DBlobRenderer* pRenderer,
+            const DBlob::DIDVector& BlobIDs,
+            cv::Scalar BlobColor = cv::Scalar(255, 0, 0), int nDisplay =
+                  DBlob::eBlob, cv::Scalar CHColor = cv::Scalar(255, 255, 255),
+            int nThickness = 1) const;
+
+      // Display the largest blob of each color
+      int DisplayLargestBlobs(DBlobRenderer* pRenderer,
+            const DBlobColor::Vector& Colors, int nDisplay = DBlob::eBlob,
+            cv::Scalar CHColor = cv::Scalar(255, 255, 255),
+            int nThickness = 1) const;
+
+      void swap(DBlobs& Blobs)
+         {
+         DBlobsBase::swap(Blobs);
+         m_Parents.swap(Blobs.m_Parents);
+         m_FirstChild.swap(Blobs.m_FirstChild);
+         m_Children.swap(Blobs.m_Children);
+
+         return;
+         }
+
+   protected:
+      // Parent of each blob ID and the children of each ID, which are
+      // m_Children[m_FirstChild[nID]] up to m_Children[m_FirstChild[nID + 1]]
+      std::vector<int> m_Parents;
+      std::vector<int> m_FirstChild;
+      std::vector<int> m_Children;
+
+      // Drop the blobs no longer in the maps from the tree
+      void PruneTree();
+
+   private:
+
+}; // end of class DBlobs
+
+/*****************************************************************************
+ *
+ ***  class DUnionFind
+ *
+ *  Disjoint sets of labels for connected component labeling.  Labels are
+ *  handed out in order and the root of a set is always its smallest label,
+ *  so the result doesn't depend on the order sets are joined in.
+ *
+ *****************************************************************************/
+
+class DUnionFind
+   {
+   public:
+      DUnionFind() = default;
+
+      DUnionFind(const DUnionFind& src) = default;
+
+      ~DUnionFind() = default;
+
+      DUnionFind& operator=(const DUnionFind& rhs) = default;
+
+      // Forget all labels but keep the storage
+      void Clear()
+         {
+         m_Parents.clear();
+
+         return;
+         }
+
+      int GetCount() const
+         {
+         return (static_cast<int>(m_Parents.size()));
+         }
+
+      // Start a new set
+      int NewLabel()
+         {
+         int nLabel = GetCount();
+         m_Parents.push_back(nLabel);
+
+         return (nLabel);
+         }
+
+      // Root of the label's set.  Halves the path on the way up.
+      int Find(int nLabel)
+         {
+         while (m_Parents[nLabel] != nLabel)
+            {
+            m_Parents[nLabel] = m_Parents[m_Parents[nLabel]];
+            nLabel = m_Parents[nLabel];
+            } // end while
+
+         return (nLabel);
+         }
+
+      // Join two sets and return the root of the result
+      int Union(int nLabel1, int nLabel2)
+         {
+         int nRoot1 = Find(nLabel1);
+         int nRoot2 = Find(nLabel2);
+         if (nRoot1 < nRoot2)
+            {
+            m_Parents[nRoot2] = nRoot1;
+            } // end if
+         else
+            {
+            m_Parents[nRoot1] = nRoot2;
+            } // end else
+
+         return (std::min(nRoot1, nRoot2));
+         }
+
+      // Add another set of labels after these, keeping their structure.
+      // Label n of Other becomes label n plus the old count.
+      void Append(const DUnionFind& Other)
+         {
+         int nOffset = GetCount();
+         for (int nParent : Other.m_Parents)
+            {
+            m_Parents.push_back(nParent + nOffset);
+            } // end for
+
+         return;
+         }
+
+   protected:
+      std::vector<int> m_Parents;
+
+   private:
+
+   }; // end of class DUnionFind
+
+/*****************************************************************************
+ *
+ ***  class DColorBlobFinder
+ *
+ *  Base class for performing the blob finding process.  Derived classes
+ * override the color categorization process so different color spaces may
+ * be used.  This base class uses the RGB color space by default.  See
+ * DColorBlobFinderT for fixing the color space at compile time.
+ *
+ *****************************************************************************/
+
+class DColorBlobFinder
+   {
+   public:
+      using COLORTYPE = unsigned char;
+      using DCategoryMatrix = DMatrix<COLORTYPE, DArray2D<COLORTYPE>>;
+
+      DColorBlobFinder()
+         {
+         Init();
+
+         return;
+         }
+
+      DColorBlobFinder(DBlobColor::Vector* pColors);
+
+      DColorBlobFinder(const DColorBlobFinder& src) = delete;
+
+      virtual ~DColorBlobFinder() = default;
+
+      DColorBlobFinder& operator=(const DColorBlobFinder& rhs) = delete;
+
+      bool IsValid() const
+         {
+         return (m_pColors != nullptr);
+         }
+
+      const DBlobs& GetBlobs() const
+         {
+         return (m_Blobs);
+         }
+
+      // Pixel classification strategies.  eClassifyLoop is the original test
+      // of each color in turn.  eClassifyBitmask ANDs the three per axis
+      // color masks (6KB, stays in L1) and takes the lowest set bit so up to
+      // 64 colors are tested at once.  The lookup modes compile the color
+      // table, including the color space conversion, into a table indexed
+      // directly by the image pixel.  eClassifyLookup24 uses the full 24 bit
+      // pixel (16MB) and is exact.  eClassifyLookup565 quantizes the pixel to
+      // 5/6/5 bits (64KB) and classifies each cell by its center value.
+      // eClassifySIMD runs the range tests on 16 or 32 pixels at a time and
+      // uses the bitmask test for anything the vector kernel can't express.
+      enum EClassifier { eClassifyLoop, eClassifyLookup24, eClassifyLookup565,
+            eClassifyBitmask, eClassifySIMD };
+
+      // Pixel layouts the finder reads as they are, so a capture buffer
+      // needn't be converted first.  eBGRA32 is also QImage::Format_RGB32
+      // and Format_ARGB32 on a little endian machine; the fourth byte is
+      // ignored.  eYUYV is packed Y0 Cb Y1 Cr, each pair of pixels sharing
+      // their chroma.  eNV12 is nHeight rows of Y followed by (nHeight + 1) / 2
+      // rows of interleaved Cb Cr, each pair shared by a 2 x 2 block, with
+      // the same stride.  An 8 bit DCVImage is eBGR24, or eBGRA32 or eGray8
+      // by its channels.  YUYV and NV12 have to come through the buffer Find,
+      // since a 2 channel image could hold some other layout.
+      enum EPixelFormat { eBGR24, eRGB24, eBGRA32, eGray8, eYUYV, eNV12 };
+
+      virtual bool Find(DCVImage* pImage);
+
+      // Find in pixels the caller owns, nStride bytes from the start of one
+      // row to the next.  They're read in place, and must stay put until the
+      // next Find if the categories are wanted since those can be rebuilt
+      // from them.
+      virtual bool Find(const uint8_t* pData, int nWidth, int nHeight,
+            size_t nStride, EPixelFormat eFormat);
+
+      // Look only inside the windows, given in image coordinates.  The rest
+      // of the image is taken as background.  Windows may overlap and are
+      // clipped to the image.
+      bool Find(DCVImage* pImage, const std::vector<cv::Rect>& Windows);
+      bool Find(DCVImage* pImage, const cv::Rect& rcWindow);
+
+      // Find in two halves so frames can overlap.  FindFrameRuns categorizes
+      // the image and leaves its runs in Runs, and LabelFrameRuns later
+      // joins them into this finder's blobs.  The two may run on different
+      // threads at once, with the next frame being categorized while this
+      // one is labeled, as long as each runs on one thread at a time and
+      // nothing else uses the finder meanwhile.  The blobs are the same as
+      // Find's.
+      struct DFrameRuns;
+      virtual bool FindFrameRuns(DCVImage* pImage, DFrameRuns& Runs,
+            const std::vector<cv::Rect>* pWindows = nullptr);
+      bool LabelFrameRuns(DFrameRuns& Runs);
+
+      // Trade the blobs found for others, so the blobs can be kept without
+      // copying them
+      void SwapBlobs(DBlobs& Blobs)
+         {
+         m_Blobs.swap(Blobs);
+
+         return;
+         }
+
+      EClassifier GetClassifier() const
+         {
+         return (m_eClassifier);
+         }
+
+      void SetClassifier(EClassifier eClassifier)
+         {
+         m_eClassifier = eClassifier;
+         m_bCompiled = false;
+
+         return;
+         }
+
+      // In streaming mode (the default) each row is categorized and its runs
+      // extracted straight away, so the full frame category matrix is only
+      // built when GetCategories asks for it.  Otherwise every frame fills
+      // the matrix and then extracts the runs from it.
+      void SetStreaming(bool bStreaming)
+         {
+         m_bStreaming = bStreaming;
+
+         return;
+         }
+
+      bool IsStreaming() const
+         {
+         return (m_bStreaming);
+         }
+
+      // Match runs with the previous row by sweeping both rows in column
+      // order (the default) rather than testing every pair.  The pairwise
+      // test is kept for comparison; both give the same blobs.
+      void SetLinearOverlap(bool bLinear)
+         {
+         m_bLinearOverlap = bLinear;
+
+         return;
+         }
+
+      bool IsLinearOverlap() const
+         {
+         return (m_bLinearOverlap);
+         }
+
+      // Blobs normally keep a copy of their pixel runs for drawing.  Turned
+      // off they only accumulate area, centroid and bounds, which is all
+      // most consumers look at, and drawing falls back to the bounding box.
+      void SetStoreRuns(bool bStoreRuns)
+         {
+         m_bStoreRuns = bStoreRuns;
+
+         return;
+         }
+
+      bool IsStoringRuns() const
+         {
+         return (m_bStoreRuns);
+         }
+
+      // Also track second and third order moments for orientation, axes and
+      // Hu invariants.  Off by default since it costs a little per run.
+      void SetHigherMoments(bool bHigherMoments)
+         {
+         m_bHigherMoments = bHigherMoments;
+
+         return;
+         }
+
+      bool IsTrackingHigherMoments() const
+         {
+         return (m_bHigherMoments);
+         }
+
+      // Work out which blobs sit in the holes of blobs of other colors while
+      // labeling, giving the tree in DBlobs.  Off by default since it also
+      // labels the gaps between each color's runs.
+      void SetContainment(bool bContainment)
+         {
+         m_bContainment = bContainment;
+
+         return;
+         }
+
+      bool IsFindingContainment() const
+         {
+         return (m_bContainment);
+         }
+
+      // Blobs of nColor smaller than dMinArea are dropped while labeling, as
+      // soon as no run in the next row continues them, so they never get a
+      // blob record.  0 keeps everything.
+      void SetMinArea(int nColor, double dMinArea);
+
+      double GetMinArea(int nColor) const
+         {
+         return ((nColor < static_cast<int>(m_MinAreas.size()))
+               ? m_MinAreas[nColor] : 0.0);
+         }
+
+      // Keep the IDs of the nCount largest blobs of nColor as they're
+      // closed, so finding the largest blob doesn't scan the blobs.
+      void SetLargestCount(int nColor, int nCount);
+
+      int GetLargestCount(int nColor) const
+         {
+         return ((nColor < static_cast<int>(m_LargestCounts.size()))
+               ? m_LargestCounts[nColor] : 0);
+         }
+
+      // For mostly static scenes.  Each image is compared with the previous
+      // one in square tiles and only the tiles that changed are categorized
+      // again.  Rows without a changed tile reuse their runs.  The full
+      // frame category matrix is kept between frames, so this bypasses
+      // streaming, and it only applies to finding in the whole image.
+      void SetIncremental(bool bIncremental)
+         {
+         m_bIncremental = bIncremental;
+         m_bTilesValid = false;
+
+         return;
+         }
+
+      bool IsIncremental() const
+         {
+         return (m_bIncremental);
+         }
+
+      // Sides of the tiles in pixels
+      void SetTileSize(int nTileSize)
+         {
+         m_nTileSize = std::max(nTileSize, 8);
+         m_bTilesValid = false;
+
+         return;
+         }
+
+      int GetTileSize() const
+         {
+         return (m_nTileSize);
+         }
+
+      // Tiles categorized by the last incremental Find and the tiles in
+      // the image
+      int GetChangedTiles() const
+         {
+         return (m_nChangedTiles);
+         }
+
+      int GetTileCount() const
+         {
+         return (static_cast<int>(m_ChangedTiles.size()));
+         }
+
+      // Check every incremental frame against categorizing the whole image.
+      // Rows that differ are counted and corrected.  Slow, for testing.
+      void SetValidateIncremental(bool bValidate)
+         {
+         m_bValidateIncremental = bValidate;
+         m_nValidationErrors = 0;
+
+         return;
+         }
+
+      bool IsValidatingIncremental() const
+         {
+         return (m_bValidateIncremental);
+         }
+
+      // Rows found wrong since validation was turned on
+      int GetValidationErrors() const
+         {
+         return (m_nValidationErrors);
+         }
+
+      // Color category of every pixel of the last image searched.  Built on
+      // demand in streaming mode, so that image must still be valid.
+      const DCategoryMatrix& GetCategories() const;
+
+      // Categorize pixels and extract runs in horizontal bands on nThreads
+      // threads.  Labeling still visits the bands in order so the blobs are
+      // identical to the single threaded result.  1 or less runs everything
+      // on the calling thread.
+      void SetThreadCount(int nThreads);
+
+      int GetThreadCount() const
+         {
+         return ((m_pThreadPool != nullptr) ? m_pThreadPool->GetThreadCount() : 1);
+         }
+
+      // Color space the color table ranges are expressed in
+      virtual DBlobTracker::EColorScheme GetColorScheme() const
+         {
+         return (DBlobTracker::eRGB);
+         }
+
+      // Rebuild the compiled classifier from the current color table
+      virtual void CompileColors();
+
+      // Remove blobs smaller than specified area, return count of removed
+      int RemoveSmallBlobs(double dMinArea)
+         {
+         return (m_Blobs.RemoveSmallBlobs(dMinArea));
+         }
+
+      // Find the largest blob for each color
+      void FindLargestBlobs(DBlob::DIDVector& Largest) const
+         {
+         m_Blobs.FindLargestBlobs(Largest);
+
+         return;
+         }
+
+      // Scan the image and designate each pixel into a color category
+      virtual void CategorizePixels();
+
+      // Display the background. IE, clear the image
+      void DisplayBackground(DBlobRenderer* pRenderer) const
+         {
+         if (m_pColors != nullptr)
+            {
+            pRenderer->ClearBackground((*m_pColors)[0].GetDisplayColor());
+            } // end if
+
+         return;
+         }
+
+      // Display ALL blobs
+      void DisplayBlobs(DBlobRenderer* pRenderer, int nDisplay = DBlob::eBlob,
+            cv::Scalar CHColor = cv::Scalar(255, 255, 255),
+            int nThickness = 1) const
+         {
+         if (m_pColors != nullptr)
+            {
+            m_Blobs.DisplayBlobs(pRenderer, *m_pColors, nDisplay, CHColor,
+                  nThickness);
+            } // end if
+
+         return;
+         }
+
+      // Display a individual blob by ID
+      bool DisplayBlob(DBlobRenderer* pRenderer, int nBlobID,
+            cv::Scalar BlobColor, int nDisplay = DBlob::eBlob,
+            cv::Scalar CHColor = cv::Scalar(255, 255, 255),
+            int nThickness = 1) const
+         {
+         return (m_Blobs.DisplayBlob(pRenderer, nBlobID, BlobColor, nDisplay,
+               CHColor, nThickness));
+         }
+
+      // Display blobs from a vector of IDs. All blobs will be the specified
+      // color.
+      int DisplayBlobs(DBlobRenderer* pRenderer,
+            const DBlob::DIDVector& BlobIDs,
+            cv::Scalar BlobColor = cv::Scalar(255, 0, 0), int nDisplay =
+                  DBlob::eBlob, cv::Scalar CHColor = cv::Scalar(255, 255, 255),
+            int nThickness = 1) const
+         {
+         return (m_Blobs.DisplayBlobs(pRenderer, BlobIDs, BlobColor, nDisplay,
+               CHColor, nThickness));
+         }
+
+      // Display the largest blob in each category.  Return the count of blobs
+      // displayed.  The current color map will be used.
+      int DisplayLargestBlobs(DBlobRenderer* pRenderer, int nDisplay =
+            DBlob::eBlob, cv::Scalar CHColor = cv::Scalar(255, 255, 255),
+            int nThickness = 1) const;
+
+      virtual void DisplayCategories(DBlobRenderer* pRenderer) const;
+
+      DBlobColor::Vector* GetColors()
+         {
+         return (m_pColors);
+         }
+
+      void SetColors(DBlobColor::Vector* pColors)
+         {
+         m_pColors = pColors;
+         CompileColors();
+
+         return;
+         }
+
+   protected:
+      // Colors used to categorize pixels into blobs
+      // Owned by the calling application.
+      DBlobColor::Vector* m_pColors;
+
+      // The image being searched, from a DCVImage or a caller's buffer.
+      // pData is null when there isn't one.
+      struct DImage
+         {
+         const unsigned char* pData;
+         int nRows;
+         int nCols;
+         size_t nStride;
+         EPixelFormat eFormat;
+         int nPixelSize;
+         // The Cb Cr plane of eNV12, null for the other formats
+         const unsigned char* pChroma;
+
+         const unsigned char* GetRow(int nRow) const
+            {
+            return (pData + nRow * nStride);
+            }
+
+         const unsigned char* GetChromaRow(int nRow) const
+            {
+            return (pChroma + (nRow / 2) * nStride);
+            }
+         };
+
+      DImage m_Image;
+
+      // 2D matrix with each element the color category of the corresponding
+      // pixel in the imagew.  A cache in streaming mode.  When searching
+      // windows it only covers their bounding box, whose top left corner is
+      // at m_ptColorMat in the image.
+      mutable DCategoryMatrix m_ColorMat;
+      mutable cv::Point m_ptColorMat;
+      mutable bool m_bColorMatValid;
+
+      // Windows being searched, null for the whole image
+      const std::vector<cv::Rect>* m_pWindows;
+      // Storage for the window of the single window Find
+      std::vector<cv::Rect> m_SingleWindow;
+
+      // Columns [nFirstCol, nEndCol) of a row to search
+      struct DSpan
+         {
+         int nFirstCol;
+         int nEndCol;
+         };
+
+      // Spans of each row from left to right.  Row r's are m_Spans[m_RowSpans[r]]
+      // up to m_Spans[m_RowSpans[r + 1]].
+      std::vector<DSpan> m_Spans;
+      std::vector<size_t> m_RowSpans;
+      // Bounding box of the spans.  The bands only cover its rows and the
+      // row buffers are its width.
+      cv::Rect m_rcSpans;
+
+      // Categorize and extract runs a row at a time
+      bool m_bStreaming;
+
+      // Only recategorize the tiles that changed since the previous frame
+      bool m_bIncremental;
+      int m_nTileSize;
+      // m_ColorMat, m_PrevPixels and m_CachedRuns hold the previous frame
+      bool m_bTilesValid;
+      EPixelFormat m_eTileFormat;
+      // The previous frame's pixels, rows packed end to end
+      std::vector<unsigned char> m_PrevPixels;
+      // Runs of each image row of the previous frame
+      std::vector<std::vector<DRun> > m_CachedRuns;
+      // Per tile in raster order, 1 if categorized by the last Find
+      std::vector<unsigned char> m_ChangedTiles;
+      int m_nChangedTiles;
+      bool m_bValidateIncremental;
+      int m_nValidationErrors;
+
+      // Sweep rows for run overlaps instead of testing every pair
+      bool m_bLinearOverlap;
+
+      // Keep the runs in the blobs rather than just their statistics
+      bool m_bStoreRuns;
+
+      // Track DBlobMoments for each blob
+      bool m_bHigherMoments;
+
+      // Build the containment tree
+      bool m_bContainment;
+
+      // Minimum area and largest blob count by color
+      std::vector<double> m_MinAreas;
+      std::vector<int> m_LargestCounts;
+
+      // Heap of the largest closed blobs of each color, worst on top
+      using DAreaID = std::pair<int64_t, int>;
+      std::vector<std::vector<DAreaID> > m_LargestHeaps;
+
+      // Larger area first, then lower ID like DBlobMap::FindLargestBlob
+      static bool IsLarger(const DAreaID& AreaID1, const DAreaID& AreaID2)
+         {
+         return ((AreaID1.first > AreaID2.first)
+               || ((AreaID1.first == AreaID2.first) && (AreaID1.second < AreaID2.second)));
+         }
+
+      // Collection of blobs found
+      DBlobs m_Blobs;
+
+      // How pixels are assigned to color categories, as selected and as
+      // used for the current frame.  Color tables too large for the channel
+      // masks use the per color loop without losing the selection.
+      EClassifier m_eClassifier;
+      EClassifier m_eActiveClassifier;
+
+      // Most colors (not counting background) the mask based classifiers
+      // handle before falling back to the per color loop
+      int m_nMaxColors;
+
+      // For each color axis, bit (i - 1) is set when color i accepts the
+      // axis value.  Rebuilt every frame since the application edits the
+      // color table in place; a change invalidates the lookup table.
+      uint64_t m_ChannelMasks[3][256];
+
+      // Compiled pixel to color category table for the lookup classifiers
+      std::vector<COLORTYPE> m_Lookup;
+      // Category of each grey level for eGray8 images, whatever the
+      // classifier
+      COLORTYPE m_GreyLookup[256];
+
+      // Channel masks reduced to interval tests for the SIMD classifier
+      DBlobSIMD::DColorRanges m_SIMDRanges;
+      DBlobSIMD::ELevel m_eSIMDLevel;
+      bool m_bSIMDUsable;
+
+      // The lookup table and SIMD ranges match the channel masks
+      bool m_bCompiled;
+
+      // Null when single threaded
+      std::unique_ptr<DThreadPool> m_pThreadPool;
+
+      // Provisional blob labels of the runs being joined
+      DUnionFind m_Labels;
+
+      // Color and run contacts gathered under each provisional label.  When
+      // blobs are closed as they finish the root label also has the area so
+      // far and the last row it reached.
+      struct DLabelStats
+         {
+         int nColor;
+         int nContacts;
+         int nOverlap;
+         int64_t nArea;
+         int nLastRow;
+         bool bClosed;
+         bool bPruned;
+         };
+
+      std::vector<DLabelStats> m_LabelStats;
+
+      // Horizontal band of image rows handled as a unit by one thread
+      struct DBand
+         {
+         int nFirstRow;
+         int nEndRow;
+         // One row of converted pixels as three planes of nCols bytes
+         std::vector<unsigned char> Planes;
+         // One row of categories when streaming
+         std::vector<COLORTYPE> ColorRow;
+         // Runs found in the band in raster order
+         std::vector<DRun> Runs;
+         // Index in Runs of each row's first run, plus the end
+         std::vector<size_t> RowRuns;
+         // Labels of the band's runs when the bands are labeled separately,
+         // numbered from zero in the band and from nFirstLabel in the frame
+         DUnionFind Labels;
+         std::vector<DLabelStats> LabelStats;
+         int nFirstLabel;
+         // Two rows of runs sorted by color; the band's last row ends up in
+         // ColorRuns[nLastRuns]
+         std::vector<std::vector<DRun*> > ColorRuns[2];
+         int nLastRuns;
+         };
+
+      std::vector<DBand> m_Bands;
+
+      // Blob ID of each root label, -1 if the blob was pruned.  IDs count
+      // the blobs in the order their first runs are labeled, row by row and
+      // by color within a row, so they don't depend on the bands.
+      std::vector<int> m_BlobIDs;
+
+      // Stretch of a row not of some color, for finding holes.  nOwner is
+      // the label of the run to the left, -1 at the left edge.
+      struct DGap
+         {
+         int nStart;
+         int nEnd;
+         int nOwner;
+         int nLabel;
+         };
+
+      // A connected set of gaps.  Unless it reaches the image border it's a
+      // hole in the blob of its owner.  Blobs inside the hole border it too,
+      // so the owner is taken from the first gap in raster order, which has
+      // the root label.
+      struct DGapInfo
+         {
+         bool bOpen;
+         int nOwner;
+         };
+
+      DUnionFind m_GapLabels;
+      std::vector<DGapInfo> m_GapInfo;
+      // Gaps of two rows by color
+      std::vector<std::vector<DGap> > m_ColorGaps[2];
+      // Pairs of the label of a blob's first run and the gap label of
+      // another color holding it
+      std::vector<std::pair<int, int> > m_Enclosures;
+      std::vector<int> m_Parents;
+
+      // Where a pixel of each format keeps the bytes of a DCVImage pixel,
+      // blue, green and red, fixed at compile time for the row kernels.
+      // Grey repeats its one byte.
+      template <int Size, int Blue, int Green, int Red>
+      struct DPixelLayout
+         {
+         static constexpr int nSize = Size;
+         static constexpr int nBlue = Blue;
+         static constexpr int nGreen = Green;
+         static constexpr int nRed = Red;
+         };
+
+      // Run a row kernel, a generic lambda taking the layout, for eFormat.
+      // Not for the YCbCr formats, which have kernels of their own.
+      template <class Kernel>
+      static void WithLayout(EPixelFormat eFormat, Kernel&& Task)
+         {
+         switch (eFormat)
+            {
+            case eRGB24:
+               Task(DPixelLayout<3, 2, 1, 0>());
+               break;
+
+            case eBGRA32:
+               Task(DPixelLayout<4, 0, 1, 2>());
+               break;
+
+            case eGray8:
+               Task(DPixelLayout<1, 0, 0, 0>());
+               break;
+
+            default:
+               Task(DPixelLayout<3, 0, 1, 2>());
+               break;
+            } // end switch
+
+         return;
+         }
+
+      // Bytes per pixel, per luma sample for the YCbCr formats
+      static int GetPixelSize(EPixelFormat eFormat)
+         {
+         int nSize = 0;
+         if (eFormat == eYUYV)
+            {
+            nSize = 2;
+            } // end if
+         else if (eFormat == eNV12)
+            {
+            nSize = 1;
+            } // end else if
+         else
+            {
+            WithLayout(eFormat, [&nSize](auto Layout) { nSize = decltype(Layout)::nSize; });
+            } // end else
+
+         return (nSize);
+         }
+
+      static bool IsYCbCrFormat(EPixelFormat eFormat)
+         {
+         return ((eFormat == eYUYV) || (eFormat == eNV12));
+         }
+
+      // Where the YCbCr formats keep a pixel's luma, nLumaSize bytes apart,
+      // and its pair's chroma, nPairSize bytes apart with Cr nCr bytes after
+      // Cb.  Like DPixelLayout the kernels get them at compile time.
+      template <int LumaSize, int PairSize, int Cr>
+      struct DYCbCrLayout
+         {
+         static constexpr int nLumaSize = LumaSize;
+         static constexpr int nPairSize = PairSize;
+         static constexpr int nCr = Cr;
+         };
+
+      template <class Kernel>
+      static void WithYCbCrLayout(EPixelFormat eFormat, Kernel&& Task)
+         {
+         if (eFormat == eNV12)
+            {
+            Task(DYCbCrLayout<1, 2, 1>());
+            } // end if
+         else
+            {
+            Task(DYCbCrLayout<2, 4, 2>());
+            } // end else
+
+         return;
+         }
+
+      // Full range BT.601, the inverse of DColorSpaceYCbCr::Convert, for
+      // finders testing other color spaces in YCbCr images
+      static void ConvertYCbCrPixel(const unsigned char YCbCr[3],
+            unsigned char BGRPixel[3])
+         {
+         int nY = YCbCr[0] << 8;
+         int nCb = YCbCr[1] - 128;
+         int nCr = YCbCr[2] - 128;
+         int nValue[3] = { nY + 454 * nCb + 128, nY - 88 * nCb - 183 * nCr + 128,
+               nY + 359 * nCr + 128 };
+         for (int k = 0 ; k < 3 ; k++)
+            {
+            BGRPixel[k] = static_cast<unsigned char>((nValue[k] < 0) ? 0
+                  : std::min(nValue[k] >> 8, 255));
+            } // end for
+
+         return;
+         }
+
+      // The layout's offsets for the kernels taking them at run time
+      static void GetBGROffsets(EPixelFormat eFormat, int nBGR[3])
+         {
+         WithLayout(eFormat, [nBGR](auto Layout)
+            {
+            nBGR[0] = decltype(Layout)::nBlue;
+            nBGR[1] = decltype(Layout)::nGreen;
+            nBGR[2] = decltype(Layout)::nRed;
+            });
+
+         return;
+         }
+
+      void Init();
+      void SetImage(DCVImage* pImage);
+      void SetImage(const uint8_t* pData, int nWidth, int nHeight,
+            size_t nStride, EPixelFormat eFormat);
+      // The default conversions are the RGB identity.  A class overriding
+      // one must override both; DColorBlobFinderT does.
+      virtual void ConvertRGBPixel(const unsigned char RGBPixel[3],
+            unsigned char Pixel[3]) const;
+      virtual void ConvertRGBRow(const unsigned char* pRow, EPixelFormat eFormat,
+            int nCols, unsigned char* const pPlanes[3]) const;
+      bool AllocateMemory(std::vector<DBand>& Bands);
+      void ClearBlobs();
+
+      bool BuildChannelMasks();
+      void BuildLookup();
+      void BuildGreyLookup();
+      bool BuildSIMDRanges();
+      void PrepareClassifier();
+      void BuildSpans();
+      void CategorizeRow(const unsigned char* pRow, EPixelFormat eFormat,
+            COLORTYPE* pColorRow, int nCols, unsigned char* pBuffer) const;
+      // Columns [nFirstCol, nFirstCol + nCols) of a row of the image being
+      // searched
+      void CategorizeImageRow(int nRow, int nFirstCol, COLORTYPE* pColorRow,
+            int nCols, unsigned char* pBuffer) const;
+      void CategorizeYCbCrRow(int nRow, int nFirstCol, COLORTYPE* pColorRow,
+            int nCols, unsigned char* pBuffer) const;
+      void ForEachBand(std::vector<DBand>& Bands,
+            const std::function<void (DBand&)>& Task);
+      bool FindBandRuns(std::vector<DBand>& Bands);
+      void CategorizeBands(std::vector<DBand>& Bands);
+      void ExtractRuns(DBand& Band);
+      void StreamRuns(DBand& Band);
+      // A YCbCr pixel's chroma isn't in its own bytes so the tiles can't
+      // tell when it changed
+      bool UsingTiles() const
+         {
+         return (m_bIncremental && (m_pWindows == nullptr)
+               && !IsYCbCrFormat(m_Image.eFormat));
+         }
+      void UpdateTiles(DBand& Band);
+      void ValidateTiles(std::vector<DBand>& Bands);
+      void ExtractRowRuns(int nRow, const COLORTYPE* pColorRow, int nFirstCol,
+            int nCols, std::vector<DRun>& Runs) const;
+      void LabelRuns(std::vector<DBand>& Bands, int nNumCols, bool bParallel);
+      void LabelRow(std::vector<DRun*>* pPrevRuns, std::vector<DRun*>* pCurRuns,
+            int nImageRow, bool bClose, DUnionFind& Labels,
+            std::vector<DLabelStats>& LabelStats, std::vector<DRun*>* pNewRuns);
+      void LabelBand(DBand& Band);
+      void StitchBands(std::vector<DBand>& Bands);
+      int NumberBlobs();
+      void LinkGaps(int nCols, bool bBorderRow, const std::vector<DRun*>& Runs,
+            const std::vector<DGap>& PrevGaps, std::vector<DGap>& CurGaps);
+      void BuildContainment(int nBlobCount);
+      void CloseBlob(int nLabel);
+
+      // Color category of a pixel already converted to the testing color
+      // space.  First match wins, zero is background.
+      COLORTYPE ClassifyPixel(const unsigned char Pixel[3]) const
+         {
+         uint64_t nMask = m_ChannelMasks[0][Pixel[0]] & m_ChannelMasks[1][Pixel[1]]
+               & m_ChannelMasks[2][Pixel[2]];
+
+         return ((nMask != 0) ? static_cast<COLORTYPE>(LowestBit(nMask) + 1) : 0);
+         }
+
+      // Index of the lowest set bit.  nMask must not be zero.
+      static int LowestBit(uint64_t nMask)
+         {
+#if defined(_MSC_VER)
+         unsigned long nBit;
+         _BitScanForward64(&nBit, nMask);
+         return (static_cast<int>(nBit));
+#else
+         return (__builtin_ctzll(nMask));
+#endif
+         }
+
+      // Tables for the fixed point hue conversion, from ConvertRGBPixel
+      DBlobSIMD::DHueTables BuildHueTables() const;
+
+      bool Find();
+
+   private:
+
+   }; // end of class DColorBlobFinder
+
+/*****************************************************************************
+ *
+ ***  struct DColorBlobFinder::DFrameRuns
+ *
+ * One frame's runs between DColorBlobFinder::FindFrameRuns and
+ * LabelFrameRuns.  Reusing one keeps its storage from frame to frame.
+ *
+ *****************************************************************************/
+
+struct DColorBlobFinder::DFrameRuns
+   {
+   std::vector<DBand> Bands;
+   // Width of the image, 0 if nothing was found
+   int nNumCols = 0;
+   };
+
+/*****************************************************************************
+ *
+ ***  struct DColorSpaceRGB
+ ***  struct DColorSpaceHSV
+ ***  struct DColorSpaceHSL
+ ***  struct DColorSpaceYCbCr
+ *
+ * Color space policies for DColorBlobFinderT.  Convert maps an image pixel
+ * to the testing color space.  bHue marks the hexcone hue spaces, where
+ * component 0 is a circular hue and the others depend only on the pixel's
+ * largest and smallest values, so the fixed point row conversion applies.
+ *
+ * YCbCr is full range BT.601 in 8 bit fixed point, as JPEG uses.  The YUYV
+ * and NV12 formats are already in it and are tested as they are.
+ *
+ *****************************************************************************/
+
+struct DColorSpaceRGB
+   {
+   static const DBlobTracker::EColorScheme eScheme = DBlobTracker::eRGB;
+   static const bool bHue = false;
+
+   static void Convert(const unsigned char RGBPixel[3], unsigned char Pixel[3])
+      {
+      Pixel[0] = RGBPixel[0];
+      Pixel[1] = RGBPixel[1];
+      Pixel[2] = RGBPixel[2];
+
+      return;
+      }
+   };
+
+struct DColorSpaceHSV
+   {
+   static const DBlobTracker::EColorScheme eScheme = DBlobTracker::eHSV;
+   static const bool bHue = true;
+
+   static void Convert(const unsigned char RGBPixel[3], unsigned char Pixel[3])
+      {
+      DColorHSV HSV(RGBPixel[DCVImage::EColor::eRed], RGBPixel[DCVImage::EColor::eGreen],
+            RGBPixel[DCVImage::EColor::eBlue]);
+      HSV.ScaleTo255(Pixel);
+
+      return;
+      }
+   };
+
+struct DColorSpaceHSL
+   {
+   static const DBlobTracker::EColorScheme eScheme = DBlobTracker::eHSL;
+   static const bool bHue = true;
+
+   static void Convert(const unsigned char RGBPixel[3], unsigned char Pixel[3])
+      {
+      DColorHSL HSL(RGBPixel[DCVImage::EColor::eRed], RGBPixel[DCVImage::EColor::eGreen],
+            RGBPixel[DCVImage::EColor::eBlue]);
+      HSL.ScaleTo255(Pixel);
+
+      return;
+      }
+   };
+
+struct DColorSpaceYCbCr
+   {
+   static const DBlobTracker::EColorScheme eScheme = DBlobTracker::eYCbCr;
+   static const bool bHue = false;
+
+   static void Convert(const unsigned char RGBPixel[3], unsigned char Pixel[3])
+      {
+      int nRed = RGBPixel[DCVImage::EColor::eRed];
+      int nGreen = RGBPixel[DCVImage::EColor::eGreen];
+      int nBlue = RGBPixel[DCVImage::EColor::eBlue];
+
+      // Chroma is offset by 128 before the shift so it's never negative
+      Pixel[0] = static_cast<unsigned char>((77 * nRed + 150 * nGreen + 29 * nBlue + 128) >> 8);
+      Pixel[1] = static_cast<unsigned char>(std::min(
+            (-43 * nRed - 85 * nGreen + 128 * nBlue + 32896) >> 8, 255));
+      Pixel[2] = static_cast<unsigned char>(std::min(
+            (128 * nRed - 107 * nGreen - 21 * nBlue + 32896) >> 8, 255));
+
+      return;
+      }
+   };
+
+/*****************************************************************************
+ *
+ ***  class DColorBlobFinderT
+ *
+ * Blob finder with the color space and the most colors the channel masks
+ * must hold fixed at compile time.  The conversion is called directly from
+ * the row loops so it inlines instead of costing a virtual call per pixel.
+ *
+ *****************************************************************************/
+
+template <class ColorSpace, int MaxColors = 64>
+class DColorBlobFinderT : public DColorBlobFinder
+   {
+   static_assert((MaxColors > 0) && (MaxColors <= 64),
+         "The channel masks hold at most 64 colors");
+
+   public:
+      DColorBlobFinderT()
+         {
+         m_nMaxColors = MaxColors;
+
+         return;
+         }
+
+      DColorBlobFinderT(DBlobColor::Vector* pColors) :
+            DColorBlobFinder(pColors)
+         {
+         m_nMaxColors = MaxColors;
+
+         return;
+         }
+
+      DColorBlobFinderT(const DColorBlobFinderT& src) = delete;
+
+      virtual ~DColorBlobFinderT() = default;
+
+      DColorBlobFinderT& operator=(const DColorBlobFinderT& rhs) = delete;
+
+      virtual void ConvertRGBPixel(const unsigned char RGBPixel[3],
+            unsigned char Pixel[3]) const override final
+         {
+         ColorSpace::Convert(RGBPixel, Pixel);
+
+         return;
+         }
+
+      virtual DBlobTracker::EColorScheme GetColorScheme() const override
+         {
+         return (ColorSpace::eScheme);
+         }
+
+      virtual void CompileColors() override
+         {
+         if (m_pColors != nullptr)
+            {
+            WrapHue();
+            } // end if
+
+         DColorBlobFinder::CompileColors();
+
+         return;
+         }
+
+      virtual bool Find(DCVImage* pImage) override
+         {
+         if (m_pColors != nullptr)
+            {
+            WrapHue();
+            } // end if
+
+         return (DColorBlobFinder::Find(pImage));
+         }
+
+      virtual bool Find(const uint8_t* pData, int nWidth, int nHeight,
+            size_t nStride, EPixelFormat eFormat) override
+         {
+         if (m_pColors != nullptr)
+            {
+            WrapHue();
+            } // end if
+
+         return (DColorBlobFinder::Find(pData, nWidth, nHeight, nStride, eFormat));
+         }
+
+      // Not hidden by the overrides above
+      bool Find(DCVImage* pImage, const std::vector<cv::Rect>& Windows)
+         {
+         return (DColorBlobFinder::Find(pImage, Windows));
+         }
+
+      bool Find(DCVImage* pImage, const cv::Rect& rcWindow)
+         {
+         return (DColorBlobFinder::Find(pImage, rcWindow));
+         }
+
+      virtual bool FindFrameRuns(DCVImage* pImage, DFrameRuns& Runs,
+            const std::vector<cv::Rect>* pWindows = nullptr) override
+         {
+         if (m_pColors != nullptr)
+            {
+            WrapHue();
+            } // end if
+
+         return (DColorBlobFinder::FindFrameRuns(pImage, Runs, pWindows));
+         }
+
+   protected:
+      virtual void ConvertRGBRow(const unsigned char* pRow, EPixelFormat eFormat,
+            int nCols, unsigned char* const pPlanes[3]) const override final
+         {
+         if (ColorSpace::bHue)
+            {
+            // Shared by all finders for the color space
+            static const DBlobSIMD::DHueTables Tables = BuildHueTables();
+            ConvertHueRow(Tables, pRow, eFormat, nCols, pPlanes);
+            } // end if
+         else
+            {
+            WithLayout(eFormat, [=](auto Layout)
+               {
+               using DLayout = decltype(Layout);
+               const unsigned char* pPixel = pRow;
+               for (int c = 0 ; c < nCols ; c++, pPixel += DLayout::nSize)
+                  {
+                  const unsigned char ImagePixel[3] = { pPixel[DLayout::nBlue],
+                        pPixel[DLayout::nGreen], pPixel[DLayout::nRed] };
+                  unsigned char Pixel[3];
+                  ColorSpace::Convert(ImagePixel, Pixel);
+                  pPlanes[0][c] = Pixel[0];
+                  pPlanes[1][c] = Pixel[1];
+                  pPlanes[2][c] = Pixel[2];
+                  } // end for
+               });
+            } // end else
+
+         return;
+         }
+
+      // Fixed point hue conversion.  The few pixels whose hue sits exactly
+      // on a quantization step are converted the slow way.
+      void ConvertHueRow(const DBlobSIMD::DHueTables& Tables,
+            const unsigned char* pRow, EPixelFormat eFormat, int nCols,
+            unsigned char* const pPlanes[3]) const
+         {
+         int nBGR[3];
+         GetBGROffsets(eFormat, nBGR);
+         const int nRGB[3] = { nBGR[2], nBGR[1], nBGR[0] };
+         int nPixelSize = GetPixelSize(eFormat);
+
+         // Converted in pieces so the ambiguous columns fit on the stack,
+         // which keeps this safe to call from several threads
+         const int nPiece = 1024;
+         int Ambiguous[nPiece];
+         for (int nFirst = 0 ; nFirst < nCols ; nFirst += nPiece)
+            {
+            const unsigned char* pPiece = pRow + nFirst * nPixelSize;
+            unsigned char* const pPiecePlanes[3] = { pPlanes[0] + nFirst,
+                  pPlanes[1] + nFirst, pPlanes[2] + nFirst };
+            int nAmbiguous = DBlobSIMD::ConvertRowHue(m_eSIMDLevel, Tables, nRGB,
+                  pPiece, nPixelSize, std::min(nPiece, nCols - nFirst),
+                  pPiecePlanes, Ambiguous);
+
+            for (int i = 0 ; i < nAmbiguous ; i++)
+               {
+               int c = Ambiguous[i];
+               const unsigned char* pPixel = pPiece + c * nPixelSize;
+               const unsigned char ImagePixel[3] = { pPixel[nBGR[0]],
+                     pPixel[nBGR[1]], pPixel[nBGR[2]] };
+               unsigned char Pixel[3];
+               ColorSpace::Convert(ImagePixel, Pixel);
+               pPiecePlanes[0][c] = Pixel[0];
+               } // end for
+            } // end for
+
+         return;
+         }
+
+      // Hue is circular so make sure we test that way
+      void WrapHue()
+         {
+         if (ColorSpace::bHue)
+            {
+            for (auto& Color : *m_pColors)
+               {
+               Color.GetColorRange().GetColor1().SetCircular(true);
+               } // end for
+            } // end if
+
+         return;
+         }
+
+   private:
+
+   }; // end of class DColorBlobFinderT
+
+/*****************************************************************************
+ *
+ ***  class DColorBlobFinderHSV
+ *
+ * Blob Finder using the HSV color space for pixel categorization.
+ *
+ *****************************************************************************/
+
+class DColorBlobFinderHSV : public DColorBlobFinderT<DColorSpaceHSV>
+   {
+   public:
+      DColorBlobFinderHSV() = default;
+
+      DColorBlobFinderHSV(DBlobColor::Vector* pColors) :
+            DColorBlobFinderT(pColors)
+         {
+         return;
+         }
+
+      DColorBlobFinderHSV(const DColorBlobFinderHSV& src) = delete;
+
+      ~DColorBlobFinderHSV() = default;
+
+      DColorBlobFinderHSV& operator=(const DColorBlobFinderHSV& rhs) = delete;
+
+   protected:
+
+   private:
+
+   }; // end of class DColorBlobFinderHSV
+
+/*****************************************************************************
+ *
+ ***  class DColorBlobFinderHSL
+ *
+ * Blob Finder using the HSL color space for pixel categorization.
+ *
+ *****************************************************************************/
+
+class DColorBlobFinderHSL : public DColorBlobFinderT<DColorSpaceHSL>
+   {
+   public:
+      DColorBlobFinderHSL() = default;
+
+      DColorBlobFinderHSL(DBlobColor::Vector* pColors) :
+            DColorBlobFinderT(pColors)
+         {
+         return;
+         }
+
+      DColorBlobFinderHSL(const DColorBlobFinderHSL& src) = delete;
+
+      virtual ~DColorBlobFinderHSL() = default;
+
+      DColorBlobFinderHSL& operator=(const DColorBlobFinderHSL& rhs) = delete;
+
+   protected:
+
+   private:
+
+   }; // end of class DColorBlobFinderHSL
+
+/*****************************************************************************
+ *
+ ***  class DColorBlobFinderYCbCr
+ *
+ * Blob Finder using the YCbCr color space for pixel categorization.  Finds
+ * in YUYV and NV12 frames without converting them.
+ *
+ *****************************************************************************/
+
+class DColorBlobFinderYCbCr : public DColorBlobFinderT<DColorSpaceYCbCr>
+   {
+   public:
+      DColorBlobFinderYCbCr() = default;
+
+      DColorBlobFinderYCbCr(DBlobColor::Vector* pColors) :
+            DColorBlobFinderT(pColors)
+         {
+         return;
+         }
+
+      DColorBlobFinderYCbCr(const DColorBlobFinderYCbCr& src) = delete;
+
+      virtual ~DColorBlobFinderYCbCr() = default;
+
+      DColorBlobFinderYCbCr& operator=(const DColorBlobFinderYCbCr& rhs) = delete;
+
+   protected:
+
+   private:
+
+   }; // end of class DColorBlobFinderYCbCr
+
+#endif // __DBLOBS_H__
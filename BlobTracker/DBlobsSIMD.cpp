@@ -0,0 +1,899 @@
+/*****************************************************************************
+ ****************************** DBlobsSIMD.cpp ********************************
+ *****************************************************************************/
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+#include "DBlobsSIMD.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DBLOBSIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC exposes every intrinsic regardless of the compiler switches while
+// GCC and Clang need the instruction set enabled on each function.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define DBLOBSIMD_TARGET(strTarget)
+#else
+#define DBLOBSIMD_TARGET(strTarget) __attribute__((target(strTarget)))
+#endif
+
+namespace DBlobSIMD
+   {
+
+#if defined(DBLOBSIMD_X86)
+
+   // Room for every color the channel masks can represent
+   static const int s_nMaxRanges = 64;
+
+/*****************************************************************************
+ *
+ *  Deinterleave16
+ *
+ *  Split 16 packed 3 byte pixels (48 bytes) into one register per channel.
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("sse4.1")
+   static inline void Deinterleave16(const unsigned char* pPixels,
+         __m128i& Channel0, __m128i& Channel1, __m128i& Channel2)
+      {
+      __m128i A = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pPixels));
+      __m128i B = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pPixels + 16));
+      __m128i C = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pPixels + 32));
+
+      Channel0 = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(A, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(B, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(C, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)));
+
+      Channel1 = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(A, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(B, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(C, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)));
+
+      Channel2 = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(A, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(B, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1))),
+            _mm_shuffle_epi8(C, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)));
+
+      return;
+
+      } // End of function Deinterleave16
+
+/*****************************************************************************
+ *
+ *  Deinterleave16x4
+ *
+ *  Split 16 packed 4 byte pixels (64 bytes) into one register for each of
+ *  their first three bytes.  The fourth byte, alpha or padding, is dropped.
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("sse4.1")
+   static inline void Deinterleave16x4(const unsigned char* pPixels,
+         __m128i& Channel0, __m128i& Channel1, __m128i& Channel2)
+      {
+      // Gather each load's bytes by channel, four pixels to a 32 bit lane
+      __m128i Group = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+      __m128i A = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pPixels)), Group);
+      __m128i B = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pPixels + 16)), Group);
+      __m128i C = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pPixels + 32)), Group);
+      __m128i D = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pPixels + 48)), Group);
+
+      // Then transpose the lanes
+      __m128i AB01 = _mm_unpacklo_epi32(A, B);
+      __m128i CD01 = _mm_unpacklo_epi32(C, D);
+      __m128i AB23 = _mm_unpackhi_epi32(A, B);
+      __m128i CD23 = _mm_unpackhi_epi32(C, D);
+
+      Channel0 = _mm_unpacklo_epi64(AB01, CD01);
+      Channel1 = _mm_unpackhi_epi64(AB01, CD01);
+      Channel2 = _mm_unpacklo_epi64(AB23, CD23);
+
+      return;
+
+      } // End of function Deinterleave16x4
+
+/*****************************************************************************
+ *
+ *  DeinterleavePixels
+ *
+ *  16 pixels of 3 or 4 bytes.  The pixel size is the same for a whole row
+ *  so the branch is predicted.
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("sse4.1")
+   static inline void DeinterleavePixels(const unsigned char* pPixels,
+         int nPixelSize, __m128i Channel[3])
+      {
+      if (nPixelSize == 4)
+         {
+         Deinterleave16x4(pPixels, Channel[0], Channel[1], Channel[2]);
+         } // end if
+      else
+         {
+         Deinterleave16(pPixels, Channel[0], Channel[1], Channel[2]);
+         } // end else
+
+      return;
+
+      } // End of function DeinterleavePixels
+
+/*****************************************************************************
+ *
+ *  InRange128
+ *
+ *  Unsigned byte range test using saturating min/max.  All ones where the
+ *  value passes.
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("sse4.1")
+   static inline __m128i InRange128(__m128i Value, __m128i Low, __m128i High,
+         bool bWrap)
+      {
+      __m128i AboveLow = _mm_cmpeq_epi8(_mm_max_epu8(Value, Low), Value);
+      __m128i BelowHigh = _mm_cmpeq_epi8(_mm_min_epu8(Value, High), Value);
+
+      return (bWrap ? _mm_or_si128(AboveLow, BelowHigh)
+            : _mm_and_si128(AboveLow, BelowHigh));
+
+      } // End of function InRange128
+
+/*****************************************************************************
+ *
+ *  struct DBounds128
+ *
+ *  The color ranges broadcast into registers once per row.
+ *
+ *****************************************************************************/
+
+   struct DBounds128
+      {
+      __m128i Low[s_nMaxRanges][3];
+      __m128i High[s_nMaxRanges][3];
+      __m128i Category[s_nMaxRanges];
+      };
+
+   DBLOBSIMD_TARGET("sse4.1")
+   static void LoadBounds128(const DColorRanges& Ranges, DBounds128& Bounds)
+      {
+      for (size_t i = 0 ; i < Ranges.size() ; i++)
+         {
+         for (int k = 0 ; k < 3 ; k++)
+            {
+            Bounds.Low[i][k] = _mm_set1_epi8(static_cast<char>(Ranges[i].Low[k]));
+            Bounds.High[i][k] = _mm_set1_epi8(static_cast<char>(Ranges[i].High[k]));
+            } // end for
+         Bounds.Category[i] = _mm_set1_epi8(static_cast<char>(Ranges[i].nCategory));
+         } // end for
+
+      return;
+
+      } // End of function LoadBounds128
+
+/*****************************************************************************
+ *
+ *  Classify128
+ *
+ *  Categorize 16 pixels.  The colors are tested last to first so the lowest
+ *  matching category is the one left in the result.
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("sse4.1")
+   static inline __m128i Classify128(const __m128i Channel[3],
+         const DBounds128& Bounds, const DColorRanges& Ranges)
+      {
+      __m128i Result = _mm_setzero_si128();
+      for (int i = static_cast<int>(Ranges.size()) - 1 ; i >= 0 ; i--)
+         {
+         const DColorRange& Range = Ranges[i];
+         __m128i Match = _mm_and_si128(_mm_and_si128(
+               InRange128(Channel[0], Bounds.Low[i][0], Bounds.High[i][0], Range.Wrap[0]),
+               InRange128(Channel[1], Bounds.Low[i][1], Bounds.High[i][1], Range.Wrap[1])),
+               InRange128(Channel[2], Bounds.Low[i][2], Bounds.High[i][2], Range.Wrap[2]));
+         Result = _mm_blendv_epi8(Result, Bounds.Category[i], Match);
+         } // end for
+
+      return (Result);
+
+      } // End of function Classify128
+
+/*****************************************************************************
+ *
+ *  CategorizeRowSSE41
+ *
+ *  16 packed pixels per iteration.
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("sse4.1")
+   static int CategorizeRowSSE41(const unsigned char* pRow, int nPixelSize,
+         const int nOrder[3], unsigned char* pColorRow, int nCols,
+         const DColorRanges& Ranges)
+      {
+      DBounds128 Bounds;
+      LoadBounds128(Ranges, Bounds);
+
+      int nVector = nCols & ~15;
+      for (int c = 0 ; c < nVector ; c += 16, pRow += 16 * nPixelSize)
+         {
+         __m128i Bytes[3];
+         DeinterleavePixels(pRow, nPixelSize, Bytes);
+         __m128i Channel[3] = { Bytes[nOrder[0]], Bytes[nOrder[1]], Bytes[nOrder[2]] };
+
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(pColorRow + c),
+               Classify128(Channel, Bounds, Ranges));
+         } // end for
+
+      return (nVector);
+
+      } // End of function CategorizeRowSSE41
+
+/*****************************************************************************
+ *
+ *  CategorizePlanesSSE41
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("sse4.1")
+   static int CategorizePlanesSSE41(const unsigned char* const pPlanes[3],
+         unsigned char* pColorRow, int nCols, const DColorRanges& Ranges)
+      {
+      DBounds128 Bounds;
+      LoadBounds128(Ranges, Bounds);
+
+      int nVector = nCols & ~15;
+      for (int c = 0 ; c < nVector ; c += 16)
+         {
+         __m128i Channel[3];
+         for (int k = 0 ; k < 3 ; k++)
+            {
+            Channel[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pPlanes[k] + c));
+            } // end for
+
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(pColorRow + c),
+               Classify128(Channel, Bounds, Ranges));
+         } // end for
+
+      return (nVector);
+
+      } // End of function CategorizePlanesSSE41
+
+/*****************************************************************************
+ *
+ *  InRange256
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("avx2")
+   static inline __m256i InRange256(__m256i Value, __m256i Low, __m256i High,
+         bool bWrap)
+      {
+      __m256i AboveLow = _mm256_cmpeq_epi8(_mm256_max_epu8(Value, Low), Value);
+      __m256i BelowHigh = _mm256_cmpeq_epi8(_mm256_min_epu8(Value, High), Value);
+
+      return (bWrap ? _mm256_or_si256(AboveLow, BelowHigh)
+            : _mm256_and_si256(AboveLow, BelowHigh));
+
+      } // End of function InRange256
+
+/*****************************************************************************
+ *
+ *  struct DBounds256
+ *
+ *****************************************************************************/
+
+   struct DBounds256
+      {
+      __m256i Low[s_nMaxRanges][3];
+      __m256i High[s_nMaxRanges][3];
+      __m256i Category[s_nMaxRanges];
+      };
+
+   DBLOBSIMD_TARGET("avx2")
+   static void LoadBounds256(const DColorRanges& Ranges, DBounds256& Bounds)
+      {
+      for (size_t i = 0 ; i < Ranges.size() ; i++)
+         {
+         for (int k = 0 ; k < 3 ; k++)
+            {
+            Bounds.Low[i][k] = _mm256_set1_epi8(static_cast<char>(Ranges[i].Low[k]));
+            Bounds.High[i][k] = _mm256_set1_epi8(static_cast<char>(Ranges[i].High[k]));
+            } // end for
+         Bounds.Category[i] = _mm256_set1_epi8(static_cast<char>(Ranges[i].nCategory));
+         } // end for
+
+      return;
+
+      } // End of function LoadBounds256
+
+/*****************************************************************************
+ *
+ *  Classify256
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("avx2")
+   static inline __m256i Classify256(const __m256i Channel[3],
+         const DBounds256& Bounds, const DColorRanges& Ranges)
+      {
+      __m256i Result = _mm256_setzero_si256();
+      for (int i = static_cast<int>(Ranges.size()) - 1 ; i >= 0 ; i--)
+         {
+         const DColorRange& Range = Ranges[i];
+         __m256i Match = _mm256_and_si256(_mm256_and_si256(
+               InRange256(Channel[0], Bounds.Low[i][0], Bounds.High[i][0], Range.Wrap[0]),
+               InRange256(Channel[1], Bounds.Low[i][1], Bounds.High[i][1], Range.Wrap[1])),
+               InRange256(Channel[2], Bounds.Low[i][2], Bounds.High[i][2], Range.Wrap[2]));
+         Result = _mm256_blendv_epi8(Result, Bounds.Category[i], Match);
+         } // end for
+
+      return (Result);
+
+      } // End of function Classify256
+
+/*****************************************************************************
+ *
+ *  CategorizeRowAVX2
+ *
+ *  32 packed pixels per iteration.  Two 16 pixel deinterleaves are joined
+ *  into 256 bit registers for the range tests.
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("avx2")
+   static int CategorizeRowAVX2(const unsigned char* pRow, int nPixelSize,
+         const int nOrder[3], unsigned char* pColorRow, int nCols,
+         const DColorRanges& Ranges)
+      {
+      DBounds256 Bounds;
+      LoadBounds256(Ranges, Bounds);
+
+      int nVector = nCols & ~31;
+      for (int c = 0 ; c < nVector ; c += 32, pRow += 32 * nPixelSize)
+         {
+         __m128i Lower[3];
+         __m128i Upper[3];
+         DeinterleavePixels(pRow, nPixelSize, Lower);
+         DeinterleavePixels(pRow + 16 * nPixelSize, nPixelSize, Upper);
+
+         __m256i Channel[3];
+         for (int k = 0 ; k < 3 ; k++)
+            {
+            Channel[k] = _mm256_inserti128_si256(
+                  _mm256_castsi128_si256(Lower[nOrder[k]]), Upper[nOrder[k]], 1);
+            } // end for
+
+         _mm256_storeu_si256(reinterpret_cast<__m256i*>(pColorRow + c),
+               Classify256(Channel, Bounds, Ranges));
+         } // end for
+
+      return (nVector);
+
+      } // End of function CategorizeRowAVX2
+
+/*****************************************************************************
+ *
+ *  CategorizePlanesAVX2
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("avx2")
+   static int CategorizePlanesAVX2(const unsigned char* const pPlanes[3],
+         unsigned char* pColorRow, int nCols, const DColorRanges& Ranges)
+      {
+      DBounds256 Bounds;
+      LoadBounds256(Ranges, Bounds);
+
+      int nVector = nCols & ~31;
+      for (int c = 0 ; c < nVector ; c += 32)
+         {
+         __m256i Channel[3];
+         for (int k = 0 ; k < 3 ; k++)
+            {
+            Channel[k] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pPlanes[k] + c));
+            } // end for
+
+         _mm256_storeu_si256(reinterpret_cast<__m256i*>(pColorRow + c),
+               Classify256(Channel, Bounds, Ranges));
+         } // end for
+
+      return (nVector);
+
+      } // End of function CategorizePlanesAVX2
+
+/*****************************************************************************
+ *
+ *  Hue128
+ *
+ *  Fixed point hue for 4 pixels held in 32 bit lanes.  The hexcone hue
+ *  scaled to 0-255 is 255 * Num / (6 * D) where D = max - min and Num is the
+ *  offset within the sextant plus the sextant's base.  The quotient is found
+ *  with a float divide (exact operands below 2^24) and one step of integer
+ *  correction.  Ambiguous lanes have a zero remainder on a non grey pixel.
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("sse4.1")
+   static inline __m128i Hue128(__m128i R, __m128i G, __m128i B,
+         __m128i& Ambiguous)
+      {
+      __m128i Zero = _mm_setzero_si128();
+      __m128i One = _mm_set1_epi32(1);
+
+      __m128i Max = _mm_max_epi32(_mm_max_epi32(R, G), B);
+      __m128i Min = _mm_min_epi32(_mm_min_epi32(R, G), B);
+      __m128i D = _mm_sub_epi32(Max, Min);
+
+      // Red wins ties, then green
+      __m128i IsRed = _mm_cmpeq_epi32(Max, R);
+      __m128i IsGreen = _mm_andnot_si128(IsRed, _mm_cmpeq_epi32(Max, G));
+
+      __m128i NumRed = _mm_sub_epi32(G, B);
+      __m128i NumGreen = _mm_add_epi32(_mm_sub_epi32(B, R), _mm_slli_epi32(D, 1));
+      __m128i NumBlue = _mm_add_epi32(_mm_sub_epi32(R, G), _mm_slli_epi32(D, 2));
+      __m128i Num = _mm_blendv_epi8(_mm_blendv_epi8(NumBlue, NumGreen, IsGreen),
+            NumRed, IsRed);
+
+      // Hue wraps to the top of the circle when green < blue on a red max
+      __m128i SixD = _mm_mullo_epi32(D, _mm_set1_epi32(6));
+      Num = _mm_add_epi32(Num, _mm_and_si128(_mm_cmpgt_epi32(Zero, Num), SixD));
+
+      // 255 * Num / (6 * D) truncated, as the reference's conversion of the
+      // scaled hue to a byte does
+      __m128i N = _mm_mullo_epi32(Num, _mm_set1_epi32(255));
+      __m128i Den = _mm_max_epi32(SixD, One);
+
+      __m128i Q = _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(N),
+            _mm_cvtepi32_ps(Den)));
+      __m128i Rem = _mm_sub_epi32(N, _mm_mullo_epi32(Q, Den));
+      __m128i Over = _mm_cmpgt_epi32(Zero, Rem);
+      Q = _mm_add_epi32(Q, Over);
+      Rem = _mm_add_epi32(Rem, _mm_and_si128(Over, Den));
+      __m128i Under = _mm_cmpgt_epi32(Rem, _mm_sub_epi32(Den, One));
+      Q = _mm_sub_epi32(Q, Under);
+      Rem = _mm_sub_epi32(Rem, _mm_and_si128(Under, Den));
+
+      Ambiguous = _mm_andnot_si128(_mm_cmpeq_epi32(D, Zero),
+            _mm_cmpeq_epi32(Rem, Zero));
+
+      return (Q);
+
+      } // End of function Hue128
+
+/*****************************************************************************
+ *
+ *  HueRowSSE41
+ *
+ *  Hue of 16 packed pixels of 3 or 4 bytes per iteration.  Returns the
+ *  pixels done and sets one bit per ambiguous pixel in AmbiguousBits (one
+ *  word per 16 pixels).
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("sse4.1")
+   static int HueRowSSE41(const int nRGB[3],
+         const unsigned char* pRow, int nPixelSize, int nCols,
+         unsigned char* const pPlanes[3], unsigned int* pAmbiguousBits)
+      {
+      int nVector = nCols & ~15;
+      for (int c = 0 ; c < nVector ; c += 16, pRow += 16 * nPixelSize)
+         {
+         __m128i Channel[3];
+         DeinterleavePixels(pRow, nPixelSize, Channel);
+         __m128i Red = Channel[nRGB[0]];
+         __m128i Green = Channel[nRGB[1]];
+         __m128i Blue = Channel[nRGB[2]];
+
+         // Largest and smallest values index the component tables
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(pPlanes[1] + c),
+               _mm_max_epu8(_mm_max_epu8(Red, Green), Blue));
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(pPlanes[2] + c),
+               _mm_min_epu8(_mm_min_epu8(Red, Green), Blue));
+
+         __m128i Hue[4];
+         __m128i Ambiguous[4];
+         for (int q = 0 ; q < 4 ; q++)
+            {
+            Hue[q] = Hue128(_mm_cvtepu8_epi32(Red), _mm_cvtepu8_epi32(Green),
+                  _mm_cvtepu8_epi32(Blue), Ambiguous[q]);
+            Red = _mm_srli_si128(Red, 4);
+            Green = _mm_srli_si128(Green, 4);
+            Blue = _mm_srli_si128(Blue, 4);
+            } // end for
+
+         __m128i Packed = _mm_packus_epi16(_mm_packus_epi32(Hue[0], Hue[1]),
+               _mm_packus_epi32(Hue[2], Hue[3]));
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(pPlanes[0] + c), Packed);
+
+         __m128i AmbiguousBytes = _mm_packs_epi16(
+               _mm_packs_epi32(Ambiguous[0], Ambiguous[1]),
+               _mm_packs_epi32(Ambiguous[2], Ambiguous[3]));
+         pAmbiguousBits[c / 16] = static_cast<unsigned int>(
+               _mm_movemask_epi8(AmbiguousBytes));
+         } // end for
+
+      return (nVector);
+
+      } // End of function HueRowSSE41
+
+/*****************************************************************************
+ *
+ *  Hue256
+ *
+ *  AVX2 version of Hue128 for 8 pixels.
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("avx2")
+   static inline __m256i Hue256(__m256i R, __m256i G, __m256i B,
+         __m256i& Ambiguous)
+      {
+      __m256i Zero = _mm256_setzero_si256();
+      __m256i One = _mm256_set1_epi32(1);
+
+      __m256i Max = _mm256_max_epi32(_mm256_max_epi32(R, G), B);
+      __m256i Min = _mm256_min_epi32(_mm256_min_epi32(R, G), B);
+      __m256i D = _mm256_sub_epi32(Max, Min);
+
+      __m256i IsRed = _mm256_cmpeq_epi32(Max, R);
+      __m256i IsGreen = _mm256_andnot_si256(IsRed, _mm256_cmpeq_epi32(Max, G));
+
+      __m256i NumRed = _mm256_sub_epi32(G, B);
+      __m256i NumGreen = _mm256_add_epi32(_mm256_sub_epi32(B, R), _mm256_slli_epi32(D, 1));
+      __m256i NumBlue = _mm256_add_epi32(_mm256_sub_epi32(R, G), _mm256_slli_epi32(D, 2));
+      __m256i Num = _mm256_blendv_epi8(_mm256_blendv_epi8(NumBlue, NumGreen, IsGreen),
+            NumRed, IsRed);
+
+      __m256i SixD = _mm256_mullo_epi32(D, _mm256_set1_epi32(6));
+      Num = _mm256_add_epi32(Num, _mm256_and_si256(_mm256_cmpgt_epi32(Zero, Num), SixD));
+
+      __m256i N = _mm256_mullo_epi32(Num, _mm256_set1_epi32(255));
+      __m256i Den = _mm256_max_epi32(SixD, One);
+
+      __m256i Q = _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(N),
+            _mm256_cvtepi32_ps(Den)));
+      __m256i Rem = _mm256_sub_epi32(N, _mm256_mullo_epi32(Q, Den));
+      __m256i Over = _mm256_cmpgt_epi32(Zero, Rem);
+      Q = _mm256_add_epi32(Q, Over);
+      Rem = _mm256_add_epi32(Rem, _mm256_and_si256(Over, Den));
+      __m256i Under = _mm256_cmpgt_epi32(Rem, _mm256_sub_epi32(Den, One));
+      Q = _mm256_sub_epi32(Q, Under);
+      Rem = _mm256_sub_epi32(Rem, _mm256_and_si256(Under, Den));
+
+      Ambiguous = _mm256_andnot_si256(_mm256_cmpeq_epi32(D, Zero),
+            _mm256_cmpeq_epi32(Rem, Zero));
+
+      return (Q);
+
+      } // End of function Hue256
+
+/*****************************************************************************
+ *
+ *  HueRowAVX2
+ *
+ *****************************************************************************/
+
+   DBLOBSIMD_TARGET("avx2")
+   static int HueRowAVX2(const int nRGB[3],
+         const unsigned char* pRow, int nPixelSize, int nCols,
+         unsigned char* const pPlanes[3], unsigned int* pAmbiguousBits)
+      {
+      int nVector = nCols & ~15;
+      for (int c = 0 ; c < nVector ; c += 16, pRow += 16 * nPixelSize)
+         {
+         __m128i Channel[3];
+         DeinterleavePixels(pRow, nPixelSize, Channel);
+         __m128i Red = Channel[nRGB[0]];
+         __m128i Green = Channel[nRGB[1]];
+         __m128i Blue = Channel[nRGB[2]];
+
+         // Largest and smallest values index the component tables
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(pPlanes[1] + c),
+               _mm_max_epu8(_mm_max_epu8(Red, Green), Blue));
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(pPlanes[2] + c),
+               _mm_min_epu8(_mm_min_epu8(Red, Green), Blue));
+
+         __m256i Ambiguous[2];
+         __m256i HueLow = Hue256(_mm256_cvtepu8_epi32(Red),
+               _mm256_cvtepu8_epi32(Green), _mm256_cvtepu8_epi32(Blue),
+               Ambiguous[0]);
+         __m256i HueHigh = Hue256(_mm256_cvtepu8_epi32(_mm_srli_si128(Red, 8)),
+               _mm256_cvtepu8_epi32(_mm_srli_si128(Green, 8)),
+               _mm256_cvtepu8_epi32(_mm_srli_si128(Blue, 8)),
+               Ambiguous[1]);
+
+         // packus works within 128 bit lanes so put the words back in order
+         __m256i Words = _mm256_permute4x64_epi64(
+               _mm256_packus_epi32(HueLow, HueHigh), 0xD8);
+         __m128i Packed = _mm_packus_epi16(_mm256_castsi256_si128(Words),
+               _mm256_extracti128_si256(Words, 1));
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(pPlanes[0] + c), Packed);
+
+         __m256i AmbiguousWords = _mm256_permute4x64_epi64(
+               _mm256_packs_epi32(Ambiguous[0], Ambiguous[1]), 0xD8);
+         __m128i AmbiguousBytes = _mm_packs_epi16(
+               _mm256_castsi256_si128(AmbiguousWords),
+               _mm256_extracti128_si256(AmbiguousWords, 1));
+         pAmbiguousBits[c / 16] = static_cast<unsigned int>(
+               _mm_movemask_epi8(AmbiguousBytes));
+         } // end for
+
+      return (nVector);
+
+      } // End of function HueRowAVX2
+
+#endif // DBLOBSIMD_X86
+
+/*****************************************************************************
+ *
+ *  HuePixel
+ *
+ *  Scalar reference for the fixed point hue kernels.
+ *
+ *****************************************************************************/
+
+   static inline int HuePixel(int nRed, int nGreen, int nBlue,
+         bool& bAmbiguous)
+      {
+      int nMax = std::max(std::max(nRed, nGreen), nBlue);
+      int nMin = std::min(std::min(nRed, nGreen), nBlue);
+      int nD = nMax - nMin;
+      int nHue = 0;
+
+      bAmbiguous = false;
+      if (nD != 0)
+         {
+         int nNum;
+         if (nMax == nRed)
+            {
+            nNum = nGreen - nBlue;
+            } // end if
+         else if (nMax == nGreen)
+            {
+            nNum = nBlue - nRed + 2 * nD;
+            } // end else if
+         else
+            {
+            nNum = nRed - nGreen + 4 * nD;
+            } // end else
+
+         if (nNum < 0)
+            {
+            nNum += 6 * nD;
+            } // end if
+
+         int nN = 255 * nNum;
+         int nDen = 6 * nD;
+         nHue = nN / nDen;
+         bAmbiguous = ((nN % nDen) == 0);
+         } // end if
+
+      return (nHue);
+
+      } // End of function HuePixel
+
+/*****************************************************************************
+ *
+ *  DetectLevel
+ *
+ *****************************************************************************/
+
+   ELevel DetectLevel()
+      {
+      ELevel eLevel = eNone;
+
+#if defined(DBLOBSIMD_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+      int Info[4];
+      __cpuid(Info, 0);
+      int nMaxLeaf = Info[0];
+
+      __cpuid(Info, 1);
+      bool bSSE41 = (Info[2] & (1 << 19)) != 0;
+      bool bOSXSave = (Info[2] & (1 << 27)) != 0;
+      bool bAVX = (Info[2] & (1 << 28)) != 0;
+
+      bool bAVX2 = false;
+      if (bOSXSave && bAVX && (nMaxLeaf >= 7)
+            && ((_xgetbv(0) & 0x06) == 0x06))
+         {
+         __cpuidex(Info, 7, 0);
+         bAVX2 = (Info[1] & (1 << 5)) != 0;
+         } // end if
+#else
+      __builtin_cpu_init();
+      bool bSSE41 = __builtin_cpu_supports("sse4.1") != 0;
+      bool bAVX2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+
+      if (bAVX2)
+         {
+         eLevel = eAVX2;
+         } // end if
+      else if (bSSE41)
+         {
+         eLevel = eSSE41;
+         } // end else if
+#endif
+
+      return (eLevel);
+
+      } // End of function DetectLevel
+
+/*****************************************************************************
+ *
+ *  CategorizeRow
+ *
+ *****************************************************************************/
+
+   int CategorizeRow(ELevel eLevel, const unsigned char* pRow, int nPixelSize,
+         const int nOrder[3], unsigned char* pColorRow, int nCols,
+         const DColorRanges& Ranges)
+      {
+      int nDone = 0;
+
+#if defined(DBLOBSIMD_X86)
+      if ((Ranges.size() <= static_cast<size_t>(s_nMaxRanges))
+            && ((nPixelSize == 3) || (nPixelSize == 4)))
+         {
+         if (eLevel == eAVX2)
+            {
+            nDone = CategorizeRowAVX2(pRow, nPixelSize, nOrder, pColorRow, nCols,
+                  Ranges);
+            } // end if
+         else if (eLevel == eSSE41)
+            {
+            nDone = CategorizeRowSSE41(pRow, nPixelSize, nOrder, pColorRow, nCols,
+                  Ranges);
+            } // end else if
+         } // end if
+#else
+      (void) eLevel;
+      (void) pRow;
+      (void) nPixelSize;
+      (void) nOrder;
+      (void) pColorRow;
+      (void) nCols;
+      (void) Ranges;
+#endif
+
+      return (nDone);
+
+      } // End of function CategorizeRow
+
+/*****************************************************************************
+ *
+ *  CategorizePlanes
+ *
+ *****************************************************************************/
+
+   int CategorizePlanes(ELevel eLevel, const unsigned char* const pPlanes[3],
+         unsigned char* pColorRow, int nCols, const DColorRanges& Ranges)
+      {
+      int nDone = 0;
+
+#if defined(DBLOBSIMD_X86)
+      if (Ranges.size() <= static_cast<size_t>(s_nMaxRanges))
+         {
+         if (eLevel == eAVX2)
+            {
+            nDone = CategorizePlanesAVX2(pPlanes, pColorRow, nCols, Ranges);
+            } // end if
+         else if (eLevel == eSSE41)
+            {
+            nDone = CategorizePlanesSSE41(pPlanes, pColorRow, nCols, Ranges);
+            } // end else if
+         } // end if
+#else
+      (void) eLevel;
+      (void) pPlanes;
+      (void) pColorRow;
+      (void) nCols;
+      (void) Ranges;
+#endif
+
+      return (nDone);
+
+      } // End of function CategorizePlanes
+
+/*****************************************************************************
+ *
+ *  ConvertRowHue
+ *
+ *****************************************************************************/
+
+   int ConvertRowHue(ELevel eLevel, const DHueTables& Tables,
+         const int nRGB[3], const unsigned char* pRow, int nPixelSize,
+         int nCols, unsigned char* const pPlanes[3], int* pAmbiguous)
+      {
+      int nAmbiguous = 0;
+      int nStart = 0;
+
+#if defined(DBLOBSIMD_X86)
+      if (((nPixelSize == 3) || (nPixelSize == 4)) && (eLevel != eNone))
+         {
+         // One bit per pixel for each block of 16
+         unsigned int AmbiguousBits[256];
+         int nBlock = std::min(nCols, 16 * 256);
+         while (nStart + 16 <= nCols)
+            {
+            int nCount = std::min(nBlock, nCols - nStart);
+            unsigned char* const pBlock[3] = { pPlanes[0] + nStart,
+                  pPlanes[1] + nStart, pPlanes[2] + nStart };
+            int nDone = (eLevel == eAVX2)
+                  ? HueRowAVX2(nRGB, pRow + nPixelSize * nStart, nPixelSize,
+                        nCount, pBlock, AmbiguousBits)
+                  : HueRowSSE41(nRGB, pRow + nPixelSize * nStart, nPixelSize,
+                        nCount, pBlock, AmbiguousBits);
+
+            for (int b = 0 ; b < nDone / 16 ; b++)
+               {
+               unsigned int nBits = AmbiguousBits[b];
+               for (int i = 0 ; nBits != 0 ; i++, nBits >>= 1)
+                  {
+                  if ((nBits & 1) != 0)
+                     {
+                     pAmbiguous[nAmbiguous++] = nStart + 16 * b + i;
+                     } // end if
+                  } // end for
+               } // end for
+
+            nStart += nDone;
+            } // end while
+         } // end if
+#else
+      (void) eLevel;
+#endif
+
+      // Scalar hue for the tail or unsupported layouts
+      const unsigned char* pPixel = pRow + nStart * nPixelSize;
+      for (int c = nStart ; c < nCols ; c++, pPixel += nPixelSize)
+         {
+         int nRed = pPixel[nRGB[0]];
+         int nGreen = pPixel[nRGB[1]];
+         int nBlue = pPixel[nRGB[2]];
+         bool bAmbiguous;
+         pPlanes[0][c] = static_cast<unsigned char>(HuePixel(nRed, nGreen, nBlue,
+               bAmbiguous));
+         pPlanes[1][c] = static_cast<unsigned char>(std::max(std::max(nRed, nGreen), nBlue));
+         pPlanes[2][c] = static_cast<unsigned char>(std::min(std::min(nRed, nGreen), nBlue));
+         if (bAmbiguous)
+            {
+            pAmbiguous[nAmbiguous++] = c;
+            } // end if
+         } // end for
+
+      // Replace max and min with the other two components.  Grey pixels take
+      // their hue from the table too.  Kept free of branches since camera
+      // noise makes them unpredictable.
+      const unsigned char* pTable1 = Tables.MaxMin[0].data();
+      const unsigned char* pTable2 = Tables.MaxMin[1].data();
+      for (int c = 0 ; c < nCols ; c++)
+         {
+         int nMax = pPlanes[1][c];
+         int nMin = pPlanes[2][c];
+         int nIndex = (nMax << 8) | nMin;
+         int nHue = pPlanes[0][c];
+         pPlanes[0][c] = static_cast<unsigned char>((nMax == nMin) ? Tables.Grey[nMax] : nHue);
+         pPlanes[1][c] = pTable1[nIndex];
+         pPlanes[2][c] = pTable2[nIndex];
+         } // end for
+
+      return (nAmbiguous);
+
+      } // End of function ConvertRowHue
+
+   }  // end namespace DBlobSIMD
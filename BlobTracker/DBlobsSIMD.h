@@ -0,0 +1,84 @@
+/*****************************************************************************
+ ******************************* DBlobsSIMD.h *********************************
+ *****************************************************************************/
+
+#if !defined(__DBLOBSSIMD_H__)
+#define __DBLOBSSIMD_H__
+
+#pragma once
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+#include <vector>
+
+/*****************************************************************************
+ *
+ ***  namespace DBlobSIMD
+ *
+ *  Vectorized pixel categorization kernels.  The kernels are compiled with
+ *  per function target attributes so the rest of the library builds for the
+ *  baseline instruction set, and the best kernel for the running CPU is
+ *  chosen at run time.
+ *
+ *****************************************************************************/
+
+namespace DBlobSIMD
+   {
+   enum ELevel { eNone, eSSE41, eAVX2 };
+
+   // Interval tests for one color category.  When Wrap is set for an axis the
+   // test is (v >= Low) || (v <= High), otherwise Low <= v <= High.
+   struct DColorRange
+      {
+      unsigned char Low[3];
+      unsigned char High[3];
+      bool Wrap[3];
+      unsigned char nCategory;
+      };
+
+   using DColorRanges = std::vector<DColorRange>;
+
+   // Best instruction set supported by this CPU and OS
+   ELevel DetectLevel();
+
+   // Tables for the hue based color spaces (HSV, HSL).  The second and third
+   // components depend only on a pixel's largest and smallest values and the
+   // hue of a grey pixel only on its value, so those entries are taken
+   // straight from the reference conversion.  Hue is computed exactly in
+   // fixed point and truncated like the reference's scaled hue.  Pixels whose
+   // scaled hue lands exactly on a quantization step are reported as
+   // ambiguous since the floating point reference may fall on either side;
+   // the caller converts them the slow way.
+   struct DHueTables
+      {
+      unsigned char Grey[256];
+      // Components 1 and 2 indexed by (max << 8) | min
+      std::vector<unsigned char> MaxMin[2];
+      };
+
+   // Categorize packed 3 or 4 byte pixels.  nOrder gives the byte offset
+   // within a pixel tested against each axis of the ranges.  First match wins
+   // so the ranges must be in category order.  Only whole vectors are
+   // processed; returns the number of pixels categorized and the caller
+   // finishes the tail.
+   int CategorizeRow(ELevel eLevel, const unsigned char* pRow, int nPixelSize,
+         const int nOrder[3], unsigned char* pColorRow, int nCols,
+         const DColorRanges& Ranges);
+
+   // Same as CategorizeRow for pixels already split into channel planes
+   int CategorizePlanes(ELevel eLevel, const unsigned char* const pPlanes[3],
+         unsigned char* pColorRow, int nCols, const DColorRanges& Ranges);
+
+   // Convert a row of pixels to hue/max-min planes.  nRGB gives the byte
+   // offsets of red, green and blue within a pixel.  The columns of ambiguous
+   // pixels are written to pAmbiguous (nCols entries) and their count is
+   // returned.  Packed 3 and 4 byte pixels use the vector kernels.
+   int ConvertRowHue(ELevel eLevel, const DHueTables& Tables,
+         const int nRGB[3], const unsigned char* pRow, int nPixelSize,
+         int nCols, unsigned char* const pPlanes[3], int* pAmbiguous);
+
+   }  // end namespace DBlobSIMD
+
+#endif // __DBLOBSSIMD_H__
@@ -0,0 +1,183 @@
+/*****************************************************************************
+ ****************************** DFramePool.cpp *******************************
+ *****************************************************************************/
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+#include "DFramePool.h"
+
+#include <algorithm>
+
+/*****************************************************************************
+ *
+ *  DFramePool::DFramePool
+ *
+ *****************************************************************************/
+
+DFramePool::DFramePool(int nMaxBuffers) :
+      m_nMaxBuffers(std::max(nMaxBuffers, 1))
+   {
+   m_Buffers.reserve(m_nMaxBuffers);
+
+   return;
+
+   } // End of function DFramePool::DFramePool
+
+/*****************************************************************************
+ *
+ *  DFramePool::Publish
+ *
+ *  The captured pixels are taken as they are when Image is the only thing
+ *  besides the pool holding them.  Otherwise whatever else has them, the
+ *  capture's own buffer say, could write over them while they're being
+ *  read, so they're copied into a free buffer instead and Image is left
+ *  alone.
+ *
+ *****************************************************************************/
+
+DCVImage DFramePool::Publish(DCVImage& Image)
+   {
+   DCVImage Frame;
+   DBuffer* pBuffer = Image.empty() ? nullptr : FindBuffer(Image);
+
+   if (Image.empty() || ((pBuffer != nullptr) && pBuffer->bPublished))
+      {
+      Frame = Image;
+      } // end if
+   else if (GetRefCount(Image) == ((pBuffer != nullptr) ? 2 : 1))
+      {
+      Frame = Image;
+      if (pBuffer != nullptr)
+         {
+         pBuffer->bPublished = true;
+         } // end if
+      else
+         {
+         m_Buffers.push_back(DBuffer{ Frame, true });
+         } // end else
+
+      Image = GetFreeBuffer(Frame.rows, Frame.cols, Frame.type());
+      } // end else if
+   else
+      {
+      Frame = GetFreeBuffer(Image.rows, Image.cols, Image.type());
+      Image.copyTo(Frame);
+      FindBuffer(Frame)->bPublished = true;
+      } // end else
+
+   TrimFreeBuffers();
+
+   return (Frame);
+
+   } // End of function DFramePool::Publish
+
+/*****************************************************************************
+ *
+ *  DFramePool::FindBuffer
+ *
+ *  The pool's buffer holding the image's pixels, nullptr if they aren't
+ *  from the pool.
+ *
+ *****************************************************************************/
+
+DFramePool::DBuffer* DFramePool::FindBuffer(const DCVImage& Image)
+   {
+   DBuffer* pBuffer = nullptr;
+   if (Image.u != nullptr)
+      {
+      for (auto& Buffer : m_Buffers)
+         {
+         if (Buffer.Image.u == Image.u)
+            {
+            pBuffer = &Buffer;
+            break;
+            } // end if
+         } // end for
+      } // end if
+
+   return (pBuffer);
+
+   } // End of function DFramePool::FindBuffer
+
+/*****************************************************************************
+ *
+ *  DFramePool::GetFreeBuffer
+ *
+ *  A buffer nothing else is using, made the right size if it isn't, to
+ *  capture into.  A new one is added when they're all in use.
+ *
+ *****************************************************************************/
+
+DCVImage DFramePool::GetFreeBuffer(int nRows, int nCols, int nType)
+   {
+   size_t nBuffer = 0;
+   while ((nBuffer < m_Buffers.size()) && (GetRefCount(m_Buffers[nBuffer].Image) != 1))
+      {
+      nBuffer++;
+      } // end while
+
+   if (nBuffer == m_Buffers.size())
+      {
+      m_Buffers.push_back(DBuffer{ DCVImage(nCols, nRows, nType), false });
+      } // end if
+   else
+      {
+      DBuffer& Buffer = m_Buffers[nBuffer];
+      if ((Buffer.Image.rows != nRows) || (Buffer.Image.cols != nCols)
+            || (Buffer.Image.type() != nType))
+         {
+         Buffer.Image = DCVImage(nCols, nRows, nType);
+         } // end if
+      Buffer.bPublished = false;
+      } // end else
+
+   return (m_Buffers[nBuffer].Image);
+
+   } // End of function DFramePool::GetFreeBuffer
+
+/*****************************************************************************
+ *
+ *  DFramePool::TrimFreeBuffers
+ *
+ *  Let free buffers go while there are more than the most to keep, which
+ *  happens when the capture swaps in buffers of its own.
+ *
+ *****************************************************************************/
+
+void DFramePool::TrimFreeBuffers()
+   {
+   auto itBuffer = m_Buffers.begin();
+   while ((static_cast<int>(m_Buffers.size()) > m_nMaxBuffers)
+         && (itBuffer != m_Buffers.end()))
+      {
+      if (GetRefCount(itBuffer->Image) == 1)
+         {
+         itBuffer = m_Buffers.erase(itBuffer);
+         } // end if
+      else
+         {
+         ++itBuffer;
+         } // end else
+      } // end while
+
+   return;
+
+   } // End of function DFramePool::TrimFreeBuffers
+
+/*****************************************************************************
+ *
+ *  DFramePool::GetRefCount
+ *
+ *  Other threads may be letting go of headers, so the count is read
+ *  atomically.  It can only go down behind the pool's back; nothing can
+ *  share a buffer the pool holds the only header for.
+ *
+ *****************************************************************************/
+
+int DFramePool::GetRefCount(const DCVImage& Image)
+   {
+   return ((Image.u != nullptr) ? CV_XADD(&Image.u->refcount, 0) : 0);
+
+   } // End of function DFramePool::GetRefCount
@@ -0,0 +1,79 @@
+/*****************************************************************************
+ ******************************* DFramePool.h ********************************
+ *****************************************************************************/
+
+#if !defined(__DFRAMEPOOL_H__)
+#define __DFRAMEPOOL_H__
+
+#pragma once
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+#include "CVImage.h"
+
+#include <vector>
+
+/*****************************************************************************
+ *
+ ***  class DFramePool
+ *
+ * Buffers for captured frames so each one is written once, by the capture,
+ * and then read in place by everything that wants it.  A DCVImage is a
+ * reference counted cv::Mat, so the frames are handed out as DCVImage
+ * headers sharing the pool's buffers and a buffer is free again once the
+ * pool's own header is the only one left.  Anything that needs to change
+ * the pixels has to copy them first.
+ *
+ * Publish takes the frame just captured into an image and gives the image
+ * a free buffer the same size to capture the next one into, so the frame
+ * changes hands without its pixels being copied.  Only used from the
+ * thread capturing the frames; the headers handed out can go anywhere.
+ *
+ *****************************************************************************/
+
+class DFramePool
+   {
+   public:
+      // Free buffers kept beyond this many buffers in all are let go
+      explicit DFramePool(int nMaxBuffers);
+
+      DFramePool(const DFramePool& src) = delete;
+
+      ~DFramePool() = default;
+
+      DFramePool& operator=(const DFramePool& rhs) = delete;
+
+      // The frame in Image to share.  A frame the pool already published is
+      // just shared again and left in Image.
+      DCVImage Publish(DCVImage& Image);
+
+      int GetBufferCount() const
+         {
+         return (static_cast<int>(m_Buffers.size()));
+         }
+
+   protected:
+      struct DBuffer
+         {
+         DCVImage Image;
+         // Holds a frame handed out by Publish rather than one being captured
+         bool bPublished;
+         };
+
+      std::vector<DBuffer> m_Buffers;
+      int m_nMaxBuffers;
+
+      DBuffer* FindBuffer(const DCVImage& Image);
+      DCVImage GetFreeBuffer(int nRows, int nCols, int nType);
+      void TrimFreeBuffers();
+
+      // Headers sharing the image's pixels, 0 if it doesn't own them
+      static int GetRefCount(const DCVImage& Image);
+
+   private:
+
+   }; // end of class DFramePool
+
+#endif // __DFRAMEPOOL_H__
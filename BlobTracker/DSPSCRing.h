@@ -0,0 +1,115 @@
+/*****************************************************************************
+ ******************************** DSPSCRing.h ********************************
+ *****************************************************************************/
+
+#if !defined(__DSPSCRING_H__)
+#define __DSPSCRING_H__
+
+#pragma once
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+/*****************************************************************************
+ *
+ ***  class DSPSCRing
+ *
+ * Fixed size lock free queue between exactly one producer thread and one
+ * consumer thread.  The producer only writes m_nTail and the consumer only
+ * writes m_nHead, each publishing with release and reading the other's with
+ * acquire, so whatever the producer did to an item before pushing it is
+ * visible to the consumer that pops it.  The counters only grow and are
+ * padded a cache line apart so the two threads don't fight over them.
+ * Padding rather than alignas keeps the ring at the default alignment, so
+ * it and its owners can be made with plain new.
+ *
+ *****************************************************************************/
+
+template <typename T>
+class DSPSCRing
+   {
+   public:
+      explicit DSPSCRing(size_t nCapacity) :
+            m_Items(nCapacity > 0 ? nCapacity : 1),
+            m_nHead(0),
+            m_nTail(0)
+         {
+         return;
+         }
+
+      DSPSCRing(const DSPSCRing& src) = delete;
+
+      ~DSPSCRing() = default;
+
+      DSPSCRing& operator=(const DSPSCRing& rhs) = delete;
+
+      // Producer only.  False if the ring is full.
+      bool Push(const T& Item)
+         {
+         size_t nTail = m_nTail.load(std::memory_order_relaxed);
+         bool bRet = (nTail - m_nHead.load(std::memory_order_acquire) < m_Items.size());
+         if (bRet)
+            {
+            m_Items[nTail % m_Items.size()] = Item;
+            m_nTail.store(nTail + 1, std::memory_order_release);
+            } // end if
+
+         return (bRet);
+         }
+
+      // Consumer only.  False if the ring is empty.
+      bool Pop(T& Item)
+         {
+         size_t nHead = m_nHead.load(std::memory_order_relaxed);
+         bool bRet = (m_nTail.load(std::memory_order_acquire) != nHead);
+         if (bRet)
+            {
+            Item = m_Items[nHead % m_Items.size()];
+            m_nHead.store(nHead + 1, std::memory_order_release);
+            } // end if
+
+         return (bRet);
+         }
+
+      // Items waiting.  A snapshot from anywhere but the two ends.  The head
+      // is read first so the tail can't be behind it.
+      size_t GetSize() const
+         {
+         size_t nHead = m_nHead.load(std::memory_order_acquire);
+
+         return (m_nTail.load(std::memory_order_acquire) - nHead);
+         }
+
+      bool IsEmpty() const
+         {
+         return (GetSize() == 0);
+         }
+
+      size_t GetCapacity() const
+         {
+         return (m_Items.size());
+         }
+
+   protected:
+      static const size_t m_nCacheLine = 64;
+
+      std::vector<T> m_Items;
+
+      // Next item to pop and next place to push, a full line from each other
+      // and from the rest of the object wherever it starts
+      char m_HeadPad[m_nCacheLine];
+      std::atomic<size_t> m_nHead;
+      char m_TailPad[m_nCacheLine - sizeof(std::atomic<size_t>)];
+      std::atomic<size_t> m_nTail;
+      char m_EndPad[m_nCacheLine - sizeof(std::atomic<size_t>)];
+
+   private:
+
+   }; // end of class DSPSCRing
+
+#endif // __DSPSCRING_H__
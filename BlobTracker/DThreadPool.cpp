@@ -0,0 +1,155 @@
+/*****************************************************************************
+ ****************************** DThreadPool.cpp *******************************
+ *****************************************************************************/
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+#include "DThreadPool.h"
+
+/*****************************************************************************
+ *
+ *  DThreadPool::DThreadPool
+ *
+ *****************************************************************************/
+
+DThreadPool::DThreadPool(int nThreads) :
+      m_pTask(nullptr),
+      m_nTasks(0),
+      m_nNextTask(0),
+      m_nBatch(0),
+      m_nBusy(0),
+      m_bQuit(false)
+   {
+   for (int i = 1 ; i < nThreads ; i++)
+      {
+      m_Workers.emplace_back(&DThreadPool::Worker, this);
+      } // end for
+
+   return;
+
+   } // End of function DThreadPool::DThreadPool
+
+/*****************************************************************************
+ *
+ *  DThreadPool::~DThreadPool
+ *
+ *****************************************************************************/
+
+DThreadPool::~DThreadPool()
+   {
+      {
+      std::lock_guard<std::mutex> Lock(m_Mutex);
+      m_bQuit = true;
+      }
+   m_StartBatch.notify_all();
+
+   for (auto& Worker : m_Workers)
+      {
+      Worker.join();
+      } // end for
+
+   return;
+
+   } // End of function DThreadPool::~DThreadPool
+
+/*****************************************************************************
+ *
+ *  DThreadPool::Run
+ *
+ *****************************************************************************/
+
+void DThreadPool::Run(int nTasks, const DTask& Task)
+   {
+   if (m_Workers.empty() || (nTasks <= 1))
+      {
+      // Not worth waking anybody up
+      for (int i = 0 ; i < nTasks ; i++)
+         {
+         Task(i);
+         } // end for
+      } // end if
+   else
+      {
+         {
+         std::lock_guard<std::mutex> Lock(m_Mutex);
+         m_pTask = &Task;
+         m_nTasks = nTasks;
+         m_nNextTask = 0;
+         m_nBusy = static_cast<int>(m_Workers.size());
+         m_nBatch++;
+         }
+      m_StartBatch.notify_all();
+
+      RunTasks();
+
+      std::unique_lock<std::mutex> Lock(m_Mutex);
+      m_BatchDone.wait(Lock, [this] { return (m_nBusy == 0); });
+      m_pTask = nullptr;
+      } // end else
+
+   return;
+
+   } // End of function DThreadPool::Run
+
+/*****************************************************************************
+ *
+ *  DThreadPool::RunTasks
+ *
+ *  Take tasks from the current batch until there are none left.
+ *
+ *****************************************************************************/
+
+void DThreadPool::RunTasks()
+   {
+   int nTask;
+   while ((nTask = m_nNextTask.fetch_add(1)) < m_nTasks)
+      {
+      (*m_pTask)(nTask);
+      } // end while
+
+   return;
+
+   } // End of function DThreadPool::RunTasks
+
+/*****************************************************************************
+ *
+ *  DThreadPool::Worker
+ *
+ *****************************************************************************/
+
+void DThreadPool::Worker()
+   {
+   unsigned int nBatch = 0;
+
+   for (;;)
+      {
+         {
+         std::unique_lock<std::mutex> Lock(m_Mutex);
+         m_StartBatch.wait(Lock, [&] { return (m_bQuit || (m_nBatch != nBatch)); });
+         if (m_bQuit)
+            {
+            break;
+            } // end if
+
+         nBatch = m_nBatch;
+         }
+
+      RunTasks();
+
+      bool bLast;
+         {
+         std::lock_guard<std::mutex> Lock(m_Mutex);
+         bLast = (--m_nBusy == 0);
+         }
+
+      if (bLast)
+         {
+         m_BatchDone.notify_one();
+         } // end if
+      } // end for
+
+   return;
+
+   } // End of function DThreadPool::Worker
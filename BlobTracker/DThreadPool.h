@@ -0,0 +1,79 @@
+/*****************************************************************************
+ ******************************* DThreadPool.h *******************************
+ *****************************************************************************/
+
+#if !defined(__DTHREADPOOL_H__)
+#define __DTHREADPOOL_H__
+
+#pragma once
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/*****************************************************************************
+ *
+ ***  class DThreadPool
+ *
+ * Fixed set of worker threads for running a batch of independent tasks.
+ * Run hands out task indices until they are used up and returns when all
+ * of them have finished.  The calling thread works on the batch too, so a
+ * pool of N threads has N - 1 workers.
+ *
+ *****************************************************************************/
+
+class DThreadPool
+   {
+   public:
+      using DTask = std::function<void (int)>;
+
+      explicit DThreadPool(int nThreads);
+
+      DThreadPool(const DThreadPool& src) = delete;
+
+      ~DThreadPool();
+
+      DThreadPool& operator=(const DThreadPool& rhs) = delete;
+
+      // Threads working on a batch including the caller
+      int GetThreadCount() const
+         {
+         return (static_cast<int>(m_Workers.size()) + 1);
+         }
+
+      // Call Task(0) through Task(nTasks - 1) and wait for them to finish
+      void Run(int nTasks, const DTask& Task);
+
+   protected:
+      std::vector<std::thread> m_Workers;
+
+      std::mutex m_Mutex;
+      std::condition_variable m_StartBatch;
+      std::condition_variable m_BatchDone;
+
+      // Current batch
+      const DTask* m_pTask;
+      int m_nTasks;
+      std::atomic<int> m_nNextTask;
+
+      // Bumped for each batch so workers can tell a new one has started
+      unsigned int m_nBatch;
+      // Workers still working on the current batch
+      int m_nBusy;
+      bool m_bQuit;
+
+      void Worker();
+      void RunTasks();
+
+   private:
+
+   }; // end of class DThreadPool
+
+#endif // __DTHREADPOOL_H__
@@ -0,0 +1,2568 @@
+/*****************************************************************************
+ **************************** BlobTrackerTests.cpp ***************************
+ *****************************************************************************/
+
+/*****************************************************************************
+ *
+ *  Checks the fast paths of the blob finder against the reference paths
+ *  they stand in for, the tracker on a synthetic sequence, the frame
+ *  pipeline with dummy stages and the frame pool.  The conversion,
+ *  tracking, pipeline and pool checks need no input; the others run on
+ *  the images given on the command line, such as the bundled BMPs.
+ *  Returns the number of checks that failed.
+ *
+ *****************************************************************************/
+
+/*****************************************************************************
+ ******************************  I N C L U D E  *******************************
+ *****************************************************************************/
+
+#include "DBlobs.h"
+#include "DBlobTracks.h"
+#include "DBlobPipeline.h"
+#include "DFramePool.h"
+
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/*****************************************************************************
+ *
+ ***  class DTestFinder
+ *
+ * Opens up the conversion and the SIMD level of a finder.
+ *
+ *****************************************************************************/
+
+template <class ColorSpace>
+class DTestFinder : public DColorBlobFinderT<ColorSpace>
+   {
+   public:
+      using DColorBlobFinderT<ColorSpace>::ConvertRGBRow;
+      using DColorBlobFinder::ConvertYCbCrPixel;
+
+      void SetSIMDLevel(DBlobSIMD::ELevel eLevel)
+         {
+         this->m_eSIMDLevel = eLevel;
+
+         return;
+         }
+
+   }; // end of class DTestFinder
+
+/*****************************************************************************
+ *
+ *  CheckHueConversion
+ *
+ *  The fixed point hue conversion against ConvertRGBPixel for every 24 bit
+ *  pixel, with the vector kernels and without.
+ *
+ *****************************************************************************/
+
+template <class ColorSpace>
+static bool CheckHueConversion(const char* pName)
+   {
+   DTestFinder<ColorSpace> Finder;
+
+   std::vector<unsigned char> Row(3 * 256);
+   std::vector<unsigned char> Converted(3 * 256);
+   unsigned char* const pPlanes[3] = { Converted.data(), Converted.data() + 256,
+         Converted.data() + 512 };
+
+   long nBad = 0;
+   const DBlobSIMD::ELevel Levels[2] = { DBlobSIMD::DetectLevel(), DBlobSIMD::eNone };
+   for (DBlobSIMD::ELevel eLevel : Levels)
+      {
+      Finder.SetSIMDLevel(eLevel);
+      for (int n = 0 ; n < 256 * 256 ; n++)
+         {
+         for (int c = 0 ; c < 256 ; c++)
+            {
+            Row[3 * c] = static_cast<unsigned char>(n >> 8);
+            Row[3 * c + 1] = static_cast<unsigned char>(n);
+            Row[3 * c + 2] = static_cast<unsigned char>(c);
+            } // end for
+
+         Finder.ConvertRGBRow(Row.data(), DColorBlobFinder::eBGR24, 256, pPlanes);
+         for (int c = 0 ; c < 256 ; c++)
+            {
+            unsigned char Reference[3];
+            Finder.ConvertRGBPixel(&Row[3 * c], Reference);
+            for (int k = 0 ; k < 3 ; k++)
+               {
+               if (pPlanes[k][c] != Reference[k])
+                  {
+                  if (nBad == 0)
+                     {
+                     std::printf("%s: pixel %d %d %d component %d is %d, not %d\n",
+                           pName, Row[3 * c], Row[3 * c + 1], Row[3 * c + 2], k,
+                           pPlanes[k][c], Reference[k]);
+                     } // end if
+                  nBad++;
+                  } // end if
+               } // end for
+            } // end for
+         } // end for
+      } // end for
+
+   std::printf("%s hue conversion: %s\n", pName, (nBad == 0) ? "passed" : "FAILED");
+
+   return (nBad == 0);
+
+   } // End of function CheckHueConversion
+
+/*****************************************************************************
+ *
+ *  LoadImage
+ *
+ *****************************************************************************/
+
+static bool LoadImage(const char* pPath, DCVImage& Image)
+   {
+   cv::Mat Loaded = cv::imread(pPath);
+   if (Loaded.empty())
+      {
+      return (false);
+      } // end if
+
+   Image = DCVImage(Loaded.cols, Loaded.rows, CV_8UC3);
+   for (int r = 0 ; r < Loaded.rows ; r++)
+      {
+      std::copy(Loaded.ptr<unsigned char>(r), Loaded.ptr<unsigned char>(r)
+            + 3 * Loaded.cols, Image.GetRow(r));
+      } // end for
+
+   return (true);
+
+   } // End of function LoadImage
+
+/*****************************************************************************
+ *
+ *  MakeColors
+ *
+ *  A background and six colors that cover the hues, with the first one
+ *  wrapping around, so every finder sees some blobs in the sample images.
+ *
+ *****************************************************************************/
+
+static DBlobColor::Vector MakeColors()
+   {
+   const int Hues[6][2] = { { 230, 20 }, { 20, 45 }, { 45, 90 }, { 90, 130 },
+         { 130, 180 }, { 180, 230 } };
+   const DCVRGB Display(255, 0, 0);
+
+   DBlobColor::Vector Colors;
+   Colors.push_back(DBlobColor("Background",
+         DBlob::DBlobColorRange(0, 0, 0, 0, 0, 0), DCVRGB(0, 0, 0)));
+   for (const auto& Hue : Hues)
+      {
+      Colors.push_back(DBlobColor("Color", DBlob::DBlobColorRange(Hue[0],
+            Hue[1], 60, 255, 40, 255), Display));
+      } // end for
+
+   return (Colors);
+
+   } // End of function MakeColors
+
+/*****************************************************************************
+ *
+ *  DescribeBlobs
+ *
+ *  One line per blob with its color and statistics, sorted, so finds that
+ *  number their blobs differently still compare equal.
+ *
+ *****************************************************************************/
+
+static std::vector<std::string> DescribeBlobs(const DBlobs& Blobs)
+   {
+   std::vector<std::string> Lines;
+   for (size_t nColor = 1 ; nColor < Blobs.size() ; nColor++)
+      {
+      for (const auto& Entry : Blobs[nColor])
+         {
+         const DBlob& Blob = Entry.second;
+         const DCVRect& rcBound = Blob.GetBoundingRect();
+         char Line[160];
+         std::snprintf(Line, sizeof(Line), "%d area %.0f at %.4f %.4f in %d %d %d %d",
+               static_cast<int>(nColor), Blob.GetArea(), Blob.GetCentroidX(),
+               Blob.GetCentroidY(), rcBound.x, rcBound.y, rcBound.width,
+               rcBound.height);
+         Lines.push_back(Line);
+         } // end for
+      } // end for
+   std::sort(Lines.begin(), Lines.end());
+
+   return (Lines);
+
+   } // End of function DescribeBlobs
+
+/*****************************************************************************
+ *
+ *  CompareFinds
+ *
+ *  Find in every image with two finders, one used by FindA and the other by
+ *  FindB, and check that they give the same blobs.
+ *
+ *****************************************************************************/
+
+template <class Finder, class FindFunctionA, class FindFunctionB>
+static bool CompareFinds(const std::string& strName,
+      const std::vector<DCVImage>& Images, FindFunctionA&& FindA,
+      FindFunctionB&& FindB)
+   {
+   DBlobColor::Vector Colors = MakeColors();
+   Finder FinderA(&Colors);
+   Finder FinderB(&Colors);
+
+   int nBad = 0;
+   for (size_t i = 0 ; i < Images.size() ; i++)
+      {
+      DCVImage Image = Images[i];
+      bool bFoundA = FindA(FinderA, Image);
+      bool bFoundB = FindB(FinderB, Image);
+      if (!bFoundA || !bFoundB || (DescribeBlobs(FinderA.GetBlobs())
+            != DescribeBlobs(FinderB.GetBlobs())))
+         {
+         if (nBad == 0)
+            {
+            std::printf("%s: image %d differs\n", strName.c_str(),
+                  static_cast<int>(i));
+            } // end if
+         nBad++;
+         } // end if
+      } // end for
+
+   std::printf("%s: %s\n", strName.c_str(), (nBad == 0) ? "passed" : "FAILED");
+
+   return (nBad == 0);
+
+   } // End of function CompareFinds
+
+/*****************************************************************************
+ *
+ *  CheckClassifiers
+ *
+ *  Every classifier against the per color loop.  eClassifyLookup565
+ *  classifies each cell by its center, so it is left out.
+ *
+ *****************************************************************************/
+
+template <class Finder>
+static int CheckClassifiers(const char* pName, const std::vector<DCVImage>& Images)
+   {
+   const DColorBlobFinder::EClassifier Classifiers[3] = {
+         DColorBlobFinder::eClassifyLookup24, DColorBlobFinder::eClassifyBitmask,
+         DColorBlobFinder::eClassifySIMD };
+
+   int nFailed = 0;
+   for (DColorBlobFinder::EClassifier eClassifier : Classifiers)
+      {
+      std::string strName = std::string(pName) + " classifier "
+            + std::to_string(static_cast<int>(eClassifier));
+      nFailed += CompareFinds<Finder>(strName, Images,
+            [eClassifier](Finder& Search, DCVImage& Image)
+               {
+               Search.SetClassifier(eClassifier);
+               return (Search.Find(&Image));
+               },
+            [](Finder& Search, DCVImage& Image)
+               {
+               return (Search.Find(&Image));
+               }) ? 0 : 1;
+      } // end for
+
+   return (nFailed);
+
+   } // End of function CheckClassifiers
+
+/*****************************************************************************
+ *
+ *  CheckLabeling
+ *
+ *  The linear run matching against the pairwise test, the row bands on
+ *  threads and the two pass mode against one band streaming its rows, and
+ *  the incremental mode against a full find of each changed frame.
+ *
+ *****************************************************************************/
+
+template <class Finder>
+static int CheckLabeling(const char* pName, const std::vector<DCVImage>& Images)
+   {
+   const std::string strName = pName;
+   auto FindAll = [](Finder& Search, DCVImage& Image)
+      {
+      return (Search.Find(&Image));
+      };
+
+   int nFailed = 0;
+   nFailed += CompareFinds<Finder>(strName + " run matching", Images,
+         [](Finder& Search, DCVImage& Image)
+            {
+            Search.SetLinearOverlap(false);
+            return (Search.Find(&Image));
+            }, FindAll) ? 0 : 1;
+
+   nFailed += CompareFinds<Finder>(strName + " bands", Images,
+         [](Finder& Search, DCVImage& Image)
+            {
+            Search.SetThreadCount(4);
+            return (Search.Find(&Image));
+            }, FindAll) ? 0 : 1;
+
+   nFailed += CompareFinds<Finder>(strName + " two pass", Images,
+         [](Finder& Search, DCVImage& Image)
+            {
+            Search.SetThreadCount(4);
+            Search.SetStreaming(false);
+            return (Search.Find(&Image));
+            }, FindAll) ? 0 : 1;
+
+   // Paint a square into a copy of each image, so the incremental finder
+   // sees a frame with a few tiles changed
+   auto Change = [](const DCVImage& Image)
+      {
+      DCVImage Changed = Image.clone();
+      int nSize = std::min(40, std::min(Changed.GetNumRows(), Changed.GetNumCols()) / 2);
+      for (int r = nSize ; r < 2 * nSize ; r++)
+         {
+         unsigned char* pRow = Changed.GetRow(r);
+         for (int c = nSize ; c < 2 * nSize ; c++)
+            {
+            pRow[3 * c] = 0;
+            pRow[3 * c + 1] = 0;
+            pRow[3 * c + 2] = 255;
+            } // end for
+         } // end for
+
+      return (Changed);
+      };
+
+   nFailed += CompareFinds<Finder>(strName + " incremental", Images,
+         [&Change](Finder& Search, DCVImage& Image)
+            {
+            Search.SetIncremental(true);
+            DCVImage Changed = Change(Image);
+            return (Search.Find(&Image) && Search.Find(&Changed));
+            },
+         [&Change](Finder& Search, DCVImage& Image)
+            {
+            DCVImage Changed = Change(Image);
+            return (Search.Find(&Changed));
+            }) ? 0 : 1;
+
+   return (nFailed);
+
+   } // End of function CheckLabeling
+
+/*****************************************************************************
+ *
+ *  ListBlobs
+ *
+ *  One line per blob in map order with its ID, perimeter and Euler number
+ *  as well as its statistics, so finds only compare equal when they number
+ *  their blobs the same way.
+ *
+ *****************************************************************************/
+
+static std::vector<std::string> ListBlobs(const DBlobs& Blobs)
+   {
+   std::vector<std::string> Lines;
+   for (size_t nColor = 1 ; nColor < Blobs.size() ; nColor++)
+      {
+      for (const auto& Entry : Blobs[nColor])
+         {
+         const DBlob& Blob = Entry.second;
+         const DCVRect& rcBound = Blob.GetBoundingRect();
+         char Line[200];
+         std::snprintf(Line, sizeof(Line),
+               "%d id %d area %.0f at %.4f %.4f in %d %d %d %d perimeter %.0f euler %d",
+               static_cast<int>(nColor), Entry.first, Blob.GetArea(),
+               Blob.GetCentroidX(), Blob.GetCentroidY(), rcBound.x, rcBound.y,
+               rcBound.width, rcBound.height, Blob.GetPerimeter(),
+               Blob.GetEulerNumber());
+         Lines.push_back(Line);
+         } // end for
+      } // end for
+
+   return (Lines);
+
+   } // End of function ListBlobs
+
+/*****************************************************************************
+ *
+ *  CheckBandIDs
+ *
+ *  The row bands on 2, 4 and 8 threads against one thread, blob IDs and
+ *  all.  Each image is stacked on its mirror image so blobs run across the
+ *  seam and across many band boundaries.
+ *
+ *****************************************************************************/
+
+template <class Finder>
+static int CheckBandIDs(const char* pName, const std::vector<DCVImage>& Images)
+   {
+   DBlobColor::Vector Colors = MakeColors();
+   Finder Serial(&Colors);
+   const int Threads[3] = { 2, 4, 8 };
+
+   int nFailed = 0;
+   int nCrossing = 0;
+   std::vector<std::vector<std::string>> Expected;
+   std::vector<DCVImage> Tall;
+   for (const DCVImage& Image : Images)
+      {
+      int nRows = Image.GetNumRows();
+      size_t nRowSize = static_cast<size_t>(Image.GetNumCols()) * Image.GetPixelSize();
+      DCVImage Stacked(Image.GetNumCols(), 2 * nRows, Image.type());
+      for (int r = 0 ; r < nRows ; r++)
+         {
+         std::memcpy(Stacked.GetRow(r), Image.GetRow(r), nRowSize);
+         std::memcpy(Stacked.GetRow(2 * nRows - 1 - r), Image.GetRow(r), nRowSize);
+         } // end for
+      Tall.push_back(Stacked);
+
+      Serial.Find(&Tall.back());
+      Expected.push_back(ListBlobs(Serial.GetBlobs()));
+      for (size_t nColor = 1 ; nColor < Serial.GetBlobs().size() ; nColor++)
+         {
+         for (const auto& Entry : Serial.GetBlobs()[nColor])
+            {
+            // Taller than a band on 8 threads
+            nCrossing += (Entry.second.GetBoundingRect().height > nRows / 16) ? 1 : 0;
+            } // end for
+         } // end for
+      } // end for
+
+   for (int nThreads : Threads)
+      {
+      Finder Bands(&Colors);
+      Bands.SetThreadCount(nThreads);
+      int nBad = 0;
+      for (size_t i = 0 ; i < Tall.size() ; i++)
+         {
+         if (!Bands.Find(&Tall[i]) || (ListBlobs(Bands.GetBlobs()) != Expected[i]))
+            {
+            nBad++;
+            } // end if
+         } // end for
+
+      std::printf("%s band IDs on %d threads: %s\n", pName, nThreads,
+            (nBad == 0) ? "passed" : "FAILED");
+      nFailed += (nBad == 0) ? 0 : 1;
+      } // end for
+   std::printf("%s band IDs: %d blobs taller than a band\n", pName, nCrossing);
+
+   return (nFailed);
+
+   } // End of function CheckBandIDs
+
+/*****************************************************************************
+ *
+ *  ScanLargest
+ *
+ *  The IDs of Map's blobs by a linear scan, largest first with ties in ID
+ *  order.
+ *
+ *****************************************************************************/
+
+static std::vector<int> ScanLargest(const DBlobMap& Map)
+   {
+   std::vector<std::pair<double, int>> Areas;
+   for (const auto& Entry : Map)
+      {
+      Areas.push_back(std::make_pair(-Entry.second.GetArea(), Entry.first));
+      } // end for
+   std::sort(Areas.begin(), Areas.end());
+
+   std::vector<int> IDs;
+   for (const auto& Area : Areas)
+      {
+      IDs.push_back(Area.second);
+      } // end for
+
+   return (IDs);
+
+   } // End of function ScanLargest
+
+/*****************************************************************************
+ *
+ *  CheckPruning
+ *
+ *  Dropping small blobs while labeling against finding everything and then
+ *  removing them, surviving IDs and all, and the largest blob lists the
+ *  finder keeps against a linear scan.  On one band and on four threads.
+ *
+ *****************************************************************************/
+
+template <class Finder>
+static int CheckPruning(const char* pName, const std::vector<DCVImage>& Images)
+   {
+   const double MinAreas[7] = { 0.0, 50.0, 20.0, 200.0, 5.0, 20.0, 0.0 };
+   const int nLargestCount = 3;
+   const int Threads[2] = { 1, 4 };
+   DBlobColor::Vector Colors = MakeColors();
+
+   int nFailed = 0;
+   for (int nThreads : Threads)
+      {
+      Finder Plain(&Colors);
+      Finder Pruning(&Colors);
+      Plain.SetThreadCount(nThreads);
+      Pruning.SetThreadCount(nThreads);
+      for (int nColor = 1 ; nColor < 7 ; nColor++)
+         {
+         Pruning.SetMinArea(nColor, MinAreas[nColor]);
+         Pruning.SetLargestCount(nColor, nLargestCount);
+         } // end for
+
+      int nBadBlobs = 0;
+      int nBadLargest = 0;
+      for (const DCVImage& Source : Images)
+         {
+         DCVImage Image = Source;
+         Plain.Find(&Image);
+         Pruning.Find(&Image);
+
+         DBlobs Expected = Plain.GetBlobs();
+         for (int nColor = 1 ; nColor < 7 ; nColor++)
+            {
+            Expected.RemoveSmallBlobs(nColor, MinAreas[nColor]);
+            } // end for
+         const DBlobs& Blobs = Pruning.GetBlobs();
+         nBadBlobs += (ListBlobs(Blobs) != ListBlobs(Expected)) ? 1 : 0;
+
+         for (size_t nColor = 1 ; nColor < Blobs.size() ; nColor++)
+            {
+            std::vector<int> Largest = ScanLargest(Expected[nColor]);
+            const DBlob::DIDVector& Kept = Blobs[nColor].GetLargest();
+            size_t nKept = std::min(Largest.size(), static_cast<size_t>(nLargestCount));
+            int nFirst = Largest.empty() ? -1 : Largest.front();
+            if (!Blobs[nColor].HasLargest() || (Kept.size() != nKept)
+                  || !std::equal(Kept.begin(), Kept.end(), Largest.begin())
+                  || (Blobs[nColor].FindLargestBlob() != nFirst)
+                  || (Expected[nColor].HasLargest())
+                  || (Expected[nColor].FindLargestBlob() != nFirst))
+               {
+               nBadLargest++;
+               } // end if
+            } // end for
+         } // end for
+
+      std::printf("%s pruning on %d threads: %s\n", pName, nThreads,
+            (nBadBlobs == 0) ? "passed" : "FAILED");
+      std::printf("%s largest on %d threads: %s\n", pName, nThreads,
+            (nBadLargest == 0) ? "passed" : "FAILED");
+      nFailed += ((nBadBlobs == 0) ? 0 : 1) + ((nBadLargest == 0) ? 0 : 1);
+      } // end for
+
+   return (nFailed);
+
+   } // End of function CheckPruning
+
+/*****************************************************************************
+ *
+ *  CheckRawFormats
+ *
+ *  Finding in a caller's BGR, RGB and BGRA buffer with padded rows against
+ *  finding in the DCVImage they were made from.
+ *
+ *****************************************************************************/
+
+template <class Finder>
+static int CheckRawFormats(const char* pName, const std::vector<DCVImage>& Images)
+   {
+   const DColorBlobFinder::EPixelFormat Formats[3] = { DColorBlobFinder::eBGR24,
+         DColorBlobFinder::eRGB24, DColorBlobFinder::eBGRA32 };
+
+   int nFailed = 0;
+   for (DColorBlobFinder::EPixelFormat eFormat : Formats)
+      {
+      std::vector<unsigned char> Buffer;
+      std::string strName = std::string(pName) + " raw format "
+            + std::to_string(static_cast<int>(eFormat));
+      nFailed += CompareFinds<Finder>(strName, Images,
+            [eFormat, &Buffer](Finder& Search, DCVImage& Image)
+               {
+               int nRows = Image.GetNumRows();
+               int nCols = Image.GetNumCols();
+               int nPixelSize = (eFormat == DColorBlobFinder::eBGRA32) ? 4 : 3;
+               size_t nStride = nPixelSize * nCols + 12;
+               Buffer.assign(nStride * nRows, 0);
+               for (int r = 0 ; r < nRows ; r++)
+                  {
+                  const unsigned char* pRow = Image.GetRow(r);
+                  unsigned char* pOut = &Buffer[r * nStride];
+                  for (int c = 0 ; c < nCols ; c++)
+                     {
+                     bool bSwap = (eFormat == DColorBlobFinder::eRGB24);
+                     pOut[nPixelSize * c] = pRow[3 * c + (bSwap ? 2 : 0)];
+                     pOut[nPixelSize * c + 1] = pRow[3 * c + 1];
+                     pOut[nPixelSize * c + 2] = pRow[3 * c + (bSwap ? 0 : 2)];
+                     } // end for
+                  } // end for
+               return (Search.Find(Buffer.data(), nCols, nRows, nStride, eFormat));
+               },
+            [](Finder& Search, DCVImage& Image)
+               {
+               return (Search.Find(&Image));
+               }) ? 0 : 1;
+      } // end for
+
+   return (nFailed);
+
+   } // End of function CheckRawFormats
+
+/*****************************************************************************
+ *
+ *  DYCbCrFrame
+ *
+ *  A YUYV or NV12 frame made from a BGR image, cropped to odd sizes and with
+ *  padded rows, and the BGR image its pixels convert back to.
+ *
+ *****************************************************************************/
+
+struct DYCbCrFrame
+   {
+   DYCbCrFrame(const DCVImage& Image, DColorBlobFinder::EPixelFormat eFormat)
+      {
+      nRows = Image.GetNumRows() - 1 + (Image.GetNumRows() & 1);
+      nCols = Image.GetNumCols() - 1 + (Image.GetNumCols() & 1);
+      bool bNV12 = (eFormat == DColorBlobFinder::eNV12);
+      nStride = (bNV12 ? nCols + 1 : 2 * (nCols + 1)) + 8;
+      Pixels.assign(nStride * (bNV12 ? nRows + (nRows + 1) / 2 : nRows), 0);
+      BGR = DCVImage(nCols, nRows, CV_8UC3);
+
+      // Full range BT.601, the chroma of each pair or block from its first
+      // pixel
+      unsigned char YCbCr[3];
+      for (int r = 0 ; r < nRows ; r++)
+         {
+         const unsigned char* pRow = Image.GetRow(r);
+         unsigned char* pLuma = &Pixels[r * nStride];
+         unsigned char* pChroma = bNV12
+               ? &Pixels[(nRows + r / 2) * nStride] : pLuma + 1;
+         for (int c = 0 ; c < nCols ; c++)
+            {
+            int nB = pRow[3 * c];
+            int nG = pRow[3 * c + 1];
+            int nR = pRow[3 * c + 2];
+            YCbCr[0] = static_cast<unsigned char>((77 * nR + 150 * nG + 29 * nB
+                  + 128) >> 8);
+            if (((c & 1) == 0) && (!bNV12 || ((r & 1) == 0)))
+               {
+               YCbCr[1] = Clamp((-43 * nR - 85 * nG + 128 * nB + 32896) >> 8);
+               YCbCr[2] = Clamp((128 * nR - 107 * nG - 21 * nB + 32896) >> 8);
+               unsigned char* pPair = bNV12 ? pChroma + c : pChroma + 2 * c;
+               pPair[0] = YCbCr[1];
+               pPair[2 - (bNV12 ? 1 : 0)] = YCbCr[2];
+               } // end if
+            else
+               {
+               const unsigned char* pPair = bNV12 ? pChroma + (c & ~1)
+                     : pChroma + 2 * (c & ~1);
+               YCbCr[1] = pPair[0];
+               YCbCr[2] = pPair[2 - (bNV12 ? 1 : 0)];
+               } // end else
+            pLuma[bNV12 ? c : 2 * c] = YCbCr[0];
+            DTestFinder<DColorSpaceRGB>::ConvertYCbCrPixel(YCbCr,
+                  BGR.GetRow(r) + 3 * c);
+            } // end for
+         } // end for
+
+      return;
+      }
+
+   static unsigned char Clamp(int nValue)
+      {
+      return (static_cast<unsigned char>(std::min(std::max(nValue, 0), 255)));
+      }
+
+   std::vector<unsigned char> Pixels;
+   DCVImage BGR;
+   int nRows;
+   int nCols;
+   size_t nStride;
+
+   }; // end of struct DYCbCrFrame
+
+/*****************************************************************************
+ *
+ *  CheckYCbCr
+ *
+ *  Finding in YUYV and NV12 frames against finding in the BGR images their
+ *  pixels convert to.
+ *
+ *****************************************************************************/
+
+template <class Finder>
+static int CheckYCbCr(const char* pName, const std::vector<DCVImage>& Images)
+   {
+   const DColorBlobFinder::EPixelFormat Formats[2] = { DColorBlobFinder::eYUYV,
+         DColorBlobFinder::eNV12 };
+
+   int nFailed = 0;
+   for (DColorBlobFinder::EPixelFormat eFormat : Formats)
+      {
+      std::string strName = std::string(pName) + " YCbCr format "
+            + std::to_string(static_cast<int>(eFormat));
+      std::unique_ptr<DYCbCrFrame> Frame;
+      nFailed += CompareFinds<Finder>(strName, Images,
+            [eFormat, &Frame](Finder& Search, DCVImage& Image)
+               {
+               Frame.reset(new DYCbCrFrame(Image, eFormat));
+               return (Search.Find(Frame->Pixels.data(), Frame->nCols,
+                     Frame->nRows, Frame->nStride, eFormat));
+               },
+            [&Frame](Finder& Search, DCVImage& /* Image */)
+               {
+               return (Search.Find(&Frame->BGR));
+               }) ? 0 : 1;
+      } // end for
+
+   return (nFailed);
+
+   } // End of function CheckYCbCr
+
+/*****************************************************************************
+ *
+ *  CheckYCbCrClassifiers
+ *
+ *  Every classifier against the per color loop on YUYV and NV12 frames.
+ *
+ *****************************************************************************/
+
+template <class Finder>
+static int CheckYCbCrClassifiers(const char* pName,
+      const std::vector<DCVImage>& Images)
+   {
+   const DColorBlobFinder::EClassifier Classifiers[3] = {
+         DColorBlobFinder::eClassifyLookup24, DColorBlobFinder::eClassifyBitmask,
+         DColorBlobFinder::eClassifySIMD };
+   const DColorBlobFinder::EPixelFormat Formats[2] = { DColorBlobFinder::eYUYV,
+         DColorBlobFinder::eNV12 };
+
+   int nFailed = 0;
+   for (DColorBlobFinder::EPixelFormat eFormat : Formats)
+      {
+      for (DColorBlobFinder::EClassifier eClassifier : Classifiers)
+         {
+         std::string strName = std::string(pName) + " YCbCr format "
+               + std::to_string(static_cast<int>(eFormat)) + " classifier "
+               + std::to_string(static_cast<int>(eClassifier));
+         std::unique_ptr<DYCbCrFrame> Frame;
+         nFailed += CompareFinds<Finder>(strName, Images,
+               [eFormat, eClassifier, &Frame](Finder& Search, DCVImage& Image)
+                  {
+                  Frame.reset(new DYCbCrFrame(Image, eFormat));
+                  Search.SetClassifier(eClassifier);
+                  return (Search.Find(Frame->Pixels.data(), Frame->nCols,
+                        Frame->nRows, Frame->nStride, eFormat));
+                  },
+               [eFormat, &Frame](Finder& Search, DCVImage& /* Image */)
+                  {
+                  return (Search.Find(Frame->Pixels.data(), Frame->nCols,
+                        Frame->nRows, Frame->nStride, eFormat));
+                  }) ? 0 : 1;
+         } // end for
+      } // end for
+
+   return (nFailed);
+
+   } // End of function CheckYCbCrClassifiers
+
+/*****************************************************************************
+ *
+ *  CheckImageTypes
+ *
+ *  A DCVImage is only searched if it is 8 bit grey, BGR or BGRA.  A 2
+ *  channel image isn't taken for YUYV.
+ *
+ *****************************************************************************/
+
+static bool CheckImageTypes()
+   {
+   DBlobColor::Vector Colors = MakeColors();
+   DColorBlobFinder Finder(&Colors);
+
+   const int Types[5] = { CV_8UC1, CV_8UC2, CV_8UC3, CV_8UC4, CV_16UC3 };
+   const bool Found[5] = { true, false, true, true, false };
+   bool bRet = true;
+   for (int i = 0 ; i < 5 ; i++)
+      {
+      DCVImage Image(64, 48, Types[i]);
+      bRet = bRet && (Finder.Find(&Image) == Found[i]);
+      } // end for
+
+   std::printf("Image types: %s\n", bRet ? "passed" : "FAILED");
+
+   return (bRet);
+
+   } // End of function CheckImageTypes
+
+/*****************************************************************************
+ *
+ *  LabelPixels
+ *
+ *  Flood fill the pixels of an nRows x nCols grid that IsIncluded picks into
+ *  components, joining neighbours IsJoined accepts, 4 or 8 connected.
+ *  Components are numbered in raster order of their first pixel, which goes
+ *  in Seeds.  Returns the number of components.
+ *
+ *****************************************************************************/
+
+template <class Include, class Join>
+static int LabelPixels(int nRows, int nCols, Include&& IsIncluded, Join&& IsJoined,
+      bool b8Connected, std::vector<int>& Labels, std::vector<int>& Seeds)
+   {
+   Labels.assign(static_cast<size_t>(nRows) * nCols, -1);
+   Seeds.clear();
+
+   std::vector<int> Stack;
+   for (int nPixel = 0 ; nPixel < nRows * nCols ; nPixel++)
+      {
+      if ((Labels[nPixel] != -1) || !IsIncluded(nPixel))
+         {
+         continue;
+         } // end if
+
+      int nLabel = static_cast<int>(Seeds.size());
+      Seeds.push_back(nPixel);
+      Labels[nPixel] = nLabel;
+      Stack.push_back(nPixel);
+      while (!Stack.empty())
+         {
+         int nAt = Stack.back();
+         Stack.pop_back();
+         int r = nAt / nCols;
+         int c = nAt % nCols;
+         for (int dr = -1 ; dr <= 1 ; dr++)
+            {
+            for (int dc = -1 ; dc <= 1 ; dc++)
+               {
+               bool bNeighbour = ((dr != 0) || (dc != 0))
+                     && (b8Connected || (dr == 0) || (dc == 0));
+               int rr = r + dr;
+               int cc = c + dc;
+               if (bNeighbour && (rr >= 0) && (rr < nRows) && (cc >= 0) && (cc < nCols))
+                  {
+                  int nNext = rr * nCols + cc;
+                  if ((Labels[nNext] == -1) && IsIncluded(nNext) && IsJoined(nAt, nNext))
+                     {
+                     Labels[nNext] = nLabel;
+                     Stack.push_back(nNext);
+                     } // end if
+                  } // end if
+               } // end for
+            } // end for
+         } // end while
+      } // end for
+
+   return (static_cast<int>(Seeds.size()));
+
+   } // End of function LabelPixels
+
+/*****************************************************************************
+ *
+ ***  struct DTopology
+ *
+ *  The blobs of a category matrix found by flood filling it, the reference
+ *  for the statistics the finder builds from runs.  Blobs are 4 connected
+ *  and their holes 8 connected.  A blob's parent is the blob of another
+ *  color with the smallest bounding box among those whose closed gap, a set
+ *  of 8 connected pixels not of their color that misses the image border,
+ *  holds the blob's first pixel.
+ *
+ *****************************************************************************/
+
+struct DTopology
+   {
+   struct DComponent
+      {
+      int nColor;
+      int nFirst;
+      int nArea;
+      cv::Rect rcBound;
+      int nPerimeter;
+      int nHoles;
+      int nParent;
+      };
+
+   DTopology(const std::vector<unsigned char>& Categories, int nRowCount,
+         int nColCount);
+
+   int nRows;
+   int nCols;
+   // Component of each pixel, -1 for background
+   std::vector<int> Labels;
+   std::vector<DComponent> Components;
+
+   }; // end of struct DTopology
+
+/*****************************************************************************
+ *
+ *  DTopology::DTopology
+ *
+ *****************************************************************************/
+
+DTopology::DTopology(const std::vector<unsigned char>& Categories, int nRowCount,
+      int nColCount) :
+      nRows(nRowCount),
+      nCols(nColCount)
+   {
+   std::vector<int> Seeds;
+   LabelPixels(nRows, nCols, [&](int p) { return (Categories[p] != 0); },
+         [&](int p, int q) { return (Categories[p] == Categories[q]); }, false,
+         Labels, Seeds);
+
+   int nColors = 0;
+   for (int nFirst : Seeds)
+      {
+      DComponent Component = { Categories[nFirst], nFirst, 0,
+            cv::Rect(nFirst % nCols, nFirst / nCols, 1, 1), 0, 0, -1 };
+      Components.push_back(Component);
+      nColors = std::max(nColors, static_cast<int>(Categories[nFirst]));
+      } // end for
+
+   // Area, bounds and the crack perimeter, the sides of the pixels that
+   // face another blob, the background or the image border
+   for (int r = 0 ; r < nRows ; r++)
+      {
+      for (int c = 0 ; c < nCols ; c++)
+         {
+         int nLabel = Labels[r * nCols + c];
+         if (nLabel == -1)
+            {
+            continue;
+            } // end if
+
+         DComponent& Component = Components[nLabel];
+         Component.nArea++;
+         Component.rcBound = Component.rcBound | cv::Rect(c, r, 1, 1);
+         const int Steps[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+         for (const auto& Step : Steps)
+            {
+            int rr = r + Step[0];
+            int cc = c + Step[1];
+            if ((rr < 0) || (rr >= nRows) || (cc < 0) || (cc >= nCols)
+                  || (Labels[rr * nCols + cc] != nLabel))
+               {
+               Component.nPerimeter++;
+               } // end if
+            } // end for
+         } // end for
+      } // end for
+
+   // Holes are the 8 connected parts of the rest of the blob's bounding box,
+   // grown by a pixel, that don't reach its edge
+   std::vector<int> Local;
+   std::vector<int> LocalSeeds;
+   for (size_t k = 0 ; k < Components.size() ; k++)
+      {
+      DComponent& Component = Components[k];
+      int nLocalRows = Component.rcBound.height + 2;
+      int nLocalCols = Component.rcBound.width + 2;
+      auto IsOutside = [&](int p)
+         {
+         int r = Component.rcBound.y + p / nLocalCols - 1;
+         int c = Component.rcBound.x + p % nLocalCols - 1;
+         return ((r < 0) || (r >= nRows) || (c < 0) || (c >= nCols)
+               || (Labels[r * nCols + c] != static_cast<int>(k)));
+         };
+      int nParts = LabelPixels(nLocalRows, nLocalCols, IsOutside,
+            [](int, int) { return (true); }, true, Local, LocalSeeds);
+
+      std::vector<char> Open(nParts, 0);
+      for (int r = 0 ; r < nLocalRows ; r++)
+         {
+         for (int c = 0 ; c < nLocalCols ; c++)
+            {
+            int nPart = Local[r * nLocalCols + c];
+            if ((nPart != -1) && ((r == 0) || (r == nLocalRows - 1) || (c == 0)
+                  || (c == nLocalCols - 1)))
+               {
+               Open[nPart] = 1;
+               } // end if
+            } // end for
+         } // end for
+      Component.nHoles = static_cast<int>(std::count(Open.begin(), Open.end(), 0));
+      } // end for
+
+   // Gaps of each color, their owners, and the nearest owner of each blob
+   std::vector<int> Gaps;
+   std::vector<int> GapSeeds;
+   for (int nColor = 1 ; nColor <= nColors ; nColor++)
+      {
+      int nGaps = LabelPixels(nRows, nCols,
+            [&](int p) { return (Categories[p] != nColor); },
+            [](int, int) { return (true); }, true, Gaps, GapSeeds);
+
+      std::vector<char> Open(nGaps, 0);
+      for (int r = 0 ; r < nRows ; r++)
+         {
+         for (int c = 0 ; c < nCols ; c++)
+            {
+            int nGap = Gaps[r * nCols + c];
+            if ((nGap != -1) && ((r == 0) || (r == nRows - 1) || (c == 0)
+                  || (c == nCols - 1)))
+               {
+               Open[nGap] = 1;
+               } // end if
+            } // end for
+         } // end for
+
+      for (auto& Component : Components)
+         {
+         int nGap = Gaps[Component.nFirst];
+         if ((Component.nColor != nColor) && (nGap != -1) && !Open[nGap])
+            {
+            // A closed gap doesn't start in column 0, and the pixel before
+            // its first one is of the color
+            int nOwner = Labels[GapSeeds[nGap] - 1];
+            if ((Component.nParent == -1) || (Components[nOwner].rcBound.area()
+                  < Components[Component.nParent].rcBound.area()))
+               {
+               Component.nParent = nOwner;
+               } // end if
+            } // end if
+         } // end for
+      } // end for
+
+   return;
+
+   } // End of function DTopology::DTopology
+
+/*****************************************************************************
+ *
+ *  GetCategories
+ *
+ *  The finder's categories as one vector, as background outside the
+ *  windows.
+ *
+ *****************************************************************************/
+
+static std::vector<unsigned char> GetCategories(const DColorBlobFinder& Finder,
+      const std::vector<cv::Rect>& Windows)
+   {
+   const DColorBlobFinder::DCategoryMatrix& Matrix = Finder.GetCategories();
+   int nRows = Matrix.GetNumRows();
+   int nCols = Matrix.GetNumCols();
+
+   std::vector<unsigned char> Categories(static_cast<size_t>(nRows) * nCols, 0);
+   for (const cv::Rect& rcWindow : Windows)
+      {
+      cv::Rect rcInside = rcWindow & cv::Rect(0, 0, nCols, nRows);
+      for (int r = rcInside.y ; r < rcInside.y + rcInside.height ; r++)
+         {
+         for (int c = rcInside.x ; c < rcInside.x + rcInside.width ; c++)
+            {
+            Categories[r * nCols + c] = Matrix[r][c];
+            } // end for
+         } // end for
+      } // end for
+
+   return (Categories);
+
+   } // End of function GetCategories
+
+/*****************************************************************************
+ *
+ *  CompareTopology
+ *
+ *  Check every blob the finder found against the flood filled reference:
+ *  the same pixels, bounds, perimeter, Euler number, holes and, when
+ *  bContainment, parent and children.  Returns the number of differences.
+ *
+ *****************************************************************************/
+
+static int CompareTopology(const DColorBlobFinder& Finder, const DTopology& Reference,
+      bool bContainment)
+   {
+   const DBlobs& Blobs = Finder.GetBlobs();
+   const int nRows = Reference.nRows;
+   const int nCols = Reference.nCols;
+
+   // Blob ID of each pixel from the blobs' runs
+   std::vector<int> IDs(static_cast<size_t>(nRows) * nCols, -1);
+   std::vector<const DBlob*> ByID;
+   std::vector<int> Colors;
+   int nBad = 0;
+   size_t nBlobs = 0;
+   for (size_t nColor = 1 ; nColor < Blobs.size() ; nColor++)
+      {
+      for (const auto& Entry : Blobs[nColor])
+         {
+         if (Entry.first >= static_cast<int>(ByID.size()))
+            {
+            ByID.resize(Entry.first + 1, nullptr);
+            Colors.resize(Entry.first + 1, 0);
+            } // end if
+         ByID[Entry.first] = &Entry.second;
+         Colors[Entry.first] = static_cast<int>(nColor);
+         nBlobs++;
+
+         const DRun* pRuns = Blobs[nColor].GetRuns(Entry.second);
+         for (int i = 0 ; (pRuns != nullptr) && (i < Entry.second.GetRunCount()) ; i++)
+            {
+            for (int c = pRuns[i].GetStart() ; c <= pRuns[i].GetEnd() ; c++)
+               {
+               IDs[pRuns[i].GetRow() * nCols + c] = Entry.first;
+               } // end for
+            } // end for
+         } // end for
+      } // end for
+
+   if (nBlobs != Reference.Components.size())
+      {
+      return (1);
+      } // end if
+
+   std::vector<int> ComponentIDs(Reference.Components.size(), -1);
+   for (size_t k = 0 ; k < Reference.Components.size() ; k++)
+      {
+      ComponentIDs[k] = IDs[Reference.Components[k].nFirst];
+      } // end for
+
+   for (size_t p = 0 ; p < IDs.size() ; p++)
+      {
+      int nLabel = Reference.Labels[p];
+      if ((nLabel == -1) ? (IDs[p] != -1) : (IDs[p] != ComponentIDs[nLabel]))
+         {
+         return (1);
+         } // end if
+      } // end for
+
+   std::vector<int> ChildCounts(Reference.Components.size(), 0);
+   for (const auto& Component : Reference.Components)
+      {
+      if (bContainment && (Component.nParent != -1))
+         {
+         ChildCounts[Component.nParent]++;
+         } // end if
+      } // end for
+
+   DBlob::DIDVector Children;
+   for (size_t k = 0 ; k < Reference.Components.size() ; k++)
+      {
+      const DTopology::DComponent& Component = Reference.Components[k];
+      int nID = ComponentIDs[k];
+      const DBlob& Blob = *ByID[nID];
+      const DCVRect& rcBound = Blob.GetBoundingRect();
+      int nParent = (bContainment && (Component.nParent != -1))
+            ? ComponentIDs[Component.nParent] : -1;
+      Blobs.GetChildren(nID, Children);
+      bool bChildrenMatch = (static_cast<int>(Children.size()) == ChildCounts[k])
+            && std::all_of(Children.begin(), Children.end(),
+            [&](int nChild) { return (Blobs.GetParent(nChild) == nID); });
+
+      if ((Colors[nID] != Component.nColor) || (Blob.GetArea() != Component.nArea)
+            || (rcBound.x != Component.rcBound.x) || (rcBound.y != Component.rcBound.y)
+            || (rcBound.width != Component.rcBound.width)
+            || (rcBound.height != Component.rcBound.height)
+            || (Blob.GetPerimeter() != Component.nPerimeter)
+            || (Blob.GetEulerNumber() != 1 - Component.nHoles)
+            || (Blob.GetHoleCount() != Component.nHoles)
+            || (Blobs.GetParent(nID) != nParent) || !bChildrenMatch)
+         {
+         nBad++;
+         } // end if
+      } // end for
+
+   return (nBad);
+
+   } // End of function CompareTopology
+
+/*****************************************************************************
+ *
+ *  CheckTopology
+ *
+ *  Perimeter, holes and containment against a flood fill of the categories
+ *  on one band, on four threads with and without containment, which labels
+ *  the bands apart when it's off, and inside a window.  The bullseye, torus
+ *  and rectangle with a hole sample images have holes and nested blobs.
+ *
+ *****************************************************************************/
+
+template <class Finder>
+static int CheckTopology(const char* pName, const std::vector<DCVImage>& Images)
+   {
+   DBlobColor::Vector Colors = MakeColors();
+   Finder Serial(&Colors);
+   Finder Threads(&Colors);
+   Finder Bands(&Colors);
+   Finder Windowed(&Colors);
+   Serial.SetContainment(true);
+   Threads.SetContainment(true);
+   Threads.SetThreadCount(4);
+   Bands.SetThreadCount(4);
+   Windowed.SetContainment(true);
+
+   int nBad[4] = { 0, 0, 0, 0 };
+   int nHoles = 0;
+   int nParents = 0;
+   for (const DCVImage& Source : Images)
+      {
+      DCVImage Image = Source;
+      int nRows = Image.GetNumRows();
+      int nCols = Image.GetNumCols();
+      cv::Rect rcFull(0, 0, nCols, nRows);
+      cv::Rect rcWindow(nCols / 5, nRows / 6, 3 * nCols / 5, 2 * nRows / 3);
+
+      Serial.Find(&Image);
+      DTopology Reference(GetCategories(Serial, { rcFull }), nRows, nCols);
+      nBad[0] += CompareTopology(Serial, Reference, true);
+
+      Threads.Find(&Image);
+      nBad[1] += CompareTopology(Threads, Reference, true);
+
+      Bands.Find(&Image);
+      nBad[2] += CompareTopology(Bands, Reference, false);
+
+      Windowed.Find(&Image, rcWindow);
+      DTopology WindowReference(GetCategories(Serial, { rcWindow }), nRows,
+            nCols);
+      nBad[3] += CompareTopology(Windowed, WindowReference, true);
+
+      for (const auto& Component : Reference.Components)
+         {
+         nHoles += Component.nHoles;
+         nParents += (Component.nParent != -1) ? 1 : 0;
+         } // end for
+      } // end for
+
+   const char* pPaths[4] = { "serial", "4 threads", "4 bands", "window" };
+   int nFailed = 0;
+   for (int i = 0 ; i < 4 ; i++)
+      {
+      std::printf("%s topology %s: %s\n", pName, pPaths[i],
+            (nBad[i] == 0) ? "passed" : "FAILED");
+      nFailed += (nBad[i] == 0) ? 0 : 1;
+      } // end for
+   std::printf("%s topology: %d holes, %d blobs inside others\n", pName, nHoles,
+         nParents);
+
+   return (nFailed);
+
+   } // End of function CheckTopology
+
+/*****************************************************************************
+ *
+ *  IsClose
+ *
+ *  dA and dB agree to about twelve digits of dScale, the size of the sums
+ *  they were worked out from.
+ *
+ *****************************************************************************/
+
+static bool IsClose(double dA, double dB, double dScale)
+   {
+   return (std::fabs(dA - dB) <= 1e-12 * std::max(dScale, 1.0));
+
+   } // End of function IsClose
+
+/*****************************************************************************
+ *
+ *  CompareMoments
+ *
+ *  One blob's moments, orientation, axes and Hu invariants against
+ *  cv::moments and cv::HuMoments of its runs drawn into a mask of its
+ *  bounding box.  The mask moves the blob to the origin, so the raw
+ *  moments differ but the centroid, less the offset, and everything
+ *  central agree.
+ *
+ *****************************************************************************/
+
+static bool CompareMoments(const DBlob& Blob, const DRun* pRuns,
+      const DBlobMoments& Higher)
+   {
+   const DCVRect& rcBound = Blob.GetBoundingRect();
+   cv::Mat Mask(rcBound.height, rcBound.width, CV_8UC1, cv::Scalar(0));
+   for (int i = 0 ; i < Blob.GetRunCount() ; i++)
+      {
+      unsigned char* pRow = Mask.ptr<unsigned char>(pRuns[i].GetRow() - rcBound.y);
+      for (int c = pRuns[i].GetStart() ; c <= pRuns[i].GetEnd() ; c++)
+         {
+         pRow[c - rcBound.x] = 255;
+         } // end for
+      } // end for
+
+   cv::Moments Expected = cv::moments(Mask, true);
+   cv::Moments Moments = Blob.GetMoments(&Higher);
+
+   // The central moments come from raw sums as large as these
+   double dReach = static_cast<double>(rcBound.x + rcBound.width + rcBound.y
+         + rcBound.height);
+   double dScale2 = Moments.m00 * dReach * dReach;
+   double dScale3 = dScale2 * dReach;
+   bool bRet = (Moments.m00 == Expected.m00)
+         && IsClose(Moments.m10 / Moments.m00, Expected.m10 / Expected.m00 + rcBound.x,
+               dReach)
+         && IsClose(Moments.m01 / Moments.m00, Expected.m01 / Expected.m00 + rcBound.y,
+               dReach)
+         && IsClose(Moments.mu20, Expected.mu20, dScale2)
+         && IsClose(Moments.mu11, Expected.mu11, dScale2)
+         && IsClose(Moments.mu02, Expected.mu02, dScale2)
+         && IsClose(Moments.mu30, Expected.mu30, dScale3)
+         && IsClose(Moments.mu21, Expected.mu21, dScale3)
+         && IsClose(Moments.mu12, Expected.mu12, dScale3)
+         && IsClose(Moments.mu03, Expected.mu03, dScale3);
+
+   // Hu invariants are built from the normalized moments, which divide the
+   // central ones by a power of the area.  Third order ones of small blobs
+   // far from the origin lose digits to the raw sums, and near symmetric
+   // blobs have invariants that are all round off.
+   double Hu[7];
+   double ExpectedHu[7];
+   Blob.GetHuMoments(Higher, Hu);
+   cv::HuMoments(Expected, ExpectedHu);
+   for (int i = 0 ; i < 7 ; i++)
+      {
+      bRet = bRet && (std::fabs(Hu[i] - ExpectedHu[i])
+            <= 1e-6 * std::fabs(ExpectedHu[i]) + 1e-9);
+      } // end for
+
+   // The orientation only means something when the blob is longer one way.
+   // The angle of the major axis doubled turns with the second moments.
+   double dSpread = std::hypot(2.0 * Expected.mu11, Expected.mu20 - Expected.mu02);
+   if (dSpread > 1e-6 * (Expected.mu20 + Expected.mu02))
+      {
+      double dAngle = 2.0 * Blob.GetOrientation(Higher);
+      bRet = bRet && IsClose(std::cos(dAngle) * dSpread, Expected.mu20 - Expected.mu02,
+            dScale2) && IsClose(std::sin(dAngle) * dSpread, 2.0 * Expected.mu11, dScale2);
+      } // end if
+
+   // The axes of the ellipse hold the sum and product of the variances
+   double dMajor;
+   double dMinor;
+   Blob.GetAxes(Higher, dMajor, dMinor);
+   double dMajorVariance = dMajor * dMajor / 16.0;
+   double dMinorVariance = dMinor * dMinor / 16.0;
+   double dXX = Expected.mu20 / Expected.m00;
+   double dXY = Expected.mu11 / Expected.m00;
+   double dYY = Expected.mu02 / Expected.m00;
+   double dVarianceScale = dReach * dReach;
+   bRet = bRet && (dMajor >= dMinor) && (dMinor >= 0.0)
+         && IsClose(dMajorVariance + dMinorVariance, dXX + dYY, dVarianceScale)
+         && IsClose(dMajorVariance * dMinorVariance, dXX * dYY - dXY * dXY,
+               dVarianceScale * dVarianceScale);
+
+   return (bRet);
+
+   } // End of function CompareMoments
+
+/*****************************************************************************
+ *
+ *  CheckMoments
+ *
+ *  The higher moments of every blob found on one band and on four, where
+ *  the bands' moments are merged, against OpenCV.
+ *
+ *****************************************************************************/
+
+template <class Finder>
+static int CheckMoments(const char* pName, const std::vector<DCVImage>& Images)
+   {
+   DBlobColor::Vector Colors = MakeColors();
+   Finder Serial(&Colors);
+   Finder Threads(&Colors);
+   Finder* Finders[2] = { &Serial, &Threads };
+   const char* pPaths[2] = { "serial", "4 threads" };
+   Threads.SetThreadCount(4);
+
+   int nFailed = 0;
+   for (int i = 0 ; i < 2 ; i++)
+      {
+      Finder& Search = *Finders[i];
+      Search.SetStoreRuns(true);
+      Search.SetHigherMoments(true);
+
+      int nBad = 0;
+      for (const DCVImage& Source : Images)
+         {
+         DCVImage Image = Source;
+         Search.Find(&Image);
+         const DBlobs& Blobs = Search.GetBlobs();
+         for (size_t nColor = 1 ; nColor < Blobs.size() ; nColor++)
+            {
+            for (const auto& Entry : Blobs[nColor])
+               {
+               const DRun* pRuns = Blobs[nColor].GetRuns(Entry.second);
+               const DBlobMoments* pHigher = Blobs[nColor].GetHigherMoments(Entry.second);
+               if ((pRuns == nullptr) || (pHigher == nullptr)
+                     || !CompareMoments(Entry.second, pRuns, *pHigher))
+                  {
+                  nBad++;
+                  } // end if
+               } // end for
+            } // end for
+         } // end for
+
+      std::printf("%s moments %s: %s\n", pName, pPaths[i],
+            (nBad == 0) ? "passed" : "FAILED");
+      nFailed += (nBad == 0) ? 0 : 1;
+      } // end for
+
+   return (nFailed);
+
+   } // End of function CheckMoments
+
+/*****************************************************************************
+ *
+ *  CheckWindows
+ *
+ *  Finding in windows against the full frame's blobs cut down to the
+ *  windows, pixel for pixel in image coordinates.  The windows reach past
+ *  the image, overlap, repeat, touch along a side or at a corner, miss the
+ *  image altogether, or tile it, which has to give the full frame's blobs.
+ *  On one band with containment and on four threads without.
+ *
+ *****************************************************************************/
+
+template <class Finder>
+static int CheckWindows(const char* pName, const std::vector<DCVImage>& Images)
+   {
+   DBlobColor::Vector Colors = MakeColors();
+   Finder Full(&Colors);
+   Finder Serial(&Colors);
+   Finder Threads(&Colors);
+   Serial.SetContainment(true);
+   Threads.SetThreadCount(4);
+
+   int nBadSingle = 0;
+   int nBadSerial = 0;
+   int nBadThreads = 0;
+   for (const DCVImage& Source : Images)
+      {
+      DCVImage Image = Source;
+      int r = Image.GetNumRows();
+      int c = Image.GetNumCols();
+      const std::vector<std::vector<cv::Rect>> WindowSets = {
+            { cv::Rect(-20, -10, c / 2, r / 2) },
+            { cv::Rect(2 * c / 3, 2 * r / 3, c / 2, r / 2) },
+            { cv::Rect(c / 8, r / 8, c / 2, r / 2),
+                  cv::Rect(c / 3, r / 3, c / 2, r / 2) },
+            { cv::Rect(c / 4, r / 4, c / 3, r / 3),
+                  cv::Rect(c / 4, r / 4, c / 3, r / 3) },
+            { cv::Rect(c / 4, r / 4, c / 4, r / 4),
+                  cv::Rect(c / 4, r / 2, c / 4, r / 4) },
+            { cv::Rect(0, 0, c / 3, r / 3), cv::Rect(c / 3, r / 3, c / 3, r / 3) },
+            { cv::Rect(c + 10, 0, 20, 20) },
+            { cv::Rect(-5, -5, c / 2 + 5, r + 10), cv::Rect(c / 2, 0, c - c / 2, r) } };
+
+      Full.Find(&Image);
+      for (const auto& Windows : WindowSets)
+         {
+         DTopology Reference(GetCategories(Full, Windows), r, c);
+
+         if (Windows.size() == 1)
+            {
+            Serial.Find(&Image, Windows.front());
+            nBadSingle += CompareTopology(Serial, Reference, true);
+            } // end if
+
+         Serial.Find(&Image, Windows);
+         nBadSerial += CompareTopology(Serial, Reference, true);
+
+         Threads.Find(&Image, Windows);
+         nBadThreads += CompareTopology(Threads, Reference, false);
+         } // end for
+
+      // Tiling the image finds what the full frame does
+      Threads.Find(&Image, WindowSets.back());
+      nBadThreads += (DescribeBlobs(Threads.GetBlobs())
+            != DescribeBlobs(Full.GetBlobs())) ? 1 : 0;
+      } // end for
+
+   const int Bad[3] = { nBadSingle, nBadSerial, nBadThreads };
+   const char* pPaths[3] = { "one window", "window list", "window list on 4 threads" };
+   int nFailed = 0;
+   for (int i = 0 ; i < 3 ; i++)
+      {
+      std::printf("%s %s: %s\n", pName, pPaths[i], (Bad[i] == 0) ? "passed" : "FAILED");
+      nFailed += (Bad[i] == 0) ? 0 : 1;
+      } // end for
+
+   return (nFailed);
+
+   } // End of function CheckWindows
+
+/*****************************************************************************
+ *
+ *  FillRect
+ *
+ *****************************************************************************/
+
+static void FillRect(DCVImage& Image, const cv::Rect& rcFill, unsigned char nBlue,
+      unsigned char nGreen, unsigned char nRed)
+   {
+   for (int r = rcFill.y ; r < rcFill.y + rcFill.height ; r++)
+      {
+      unsigned char* pRow = Image.GetRow(r);
+      for (int c = rcFill.x ; c < rcFill.x + rcFill.width ; c++)
+         {
+         pRow[3 * c] = nBlue;
+         pRow[3 * c + 1] = nGreen;
+         pRow[3 * c + 2] = nRed;
+         } // end for
+      } // end for
+
+   return;
+
+   } // End of function FillRect
+
+/*****************************************************************************
+ *
+ *  CheckTreePruning
+ *
+ *  A blue square in a thin green ring in a red ring.  Removing the green
+ *  ring as too small leaves the blue square directly inside the red ring.
+ *
+ *****************************************************************************/
+
+static bool CheckTreePruning()
+   {
+   DCVImage Image(80, 80, CV_8UC3);
+   FillRect(Image, cv::Rect(0, 0, 80, 80), 0, 0, 0);
+   FillRect(Image, cv::Rect(10, 10, 60, 60), 0, 0, 255);
+   FillRect(Image, cv::Rect(20, 20, 40, 40), 0, 0, 0);
+   FillRect(Image, cv::Rect(28, 28, 24, 24), 0, 255, 0);
+   FillRect(Image, cv::Rect(29, 29, 22, 22), 0, 0, 0);
+   FillRect(Image, cv::Rect(30, 30, 20, 20), 255, 0, 0);
+
+   DBlobColor::Vector Colors = MakeColors();
+   DColorBlobFinderHSV Finder(&Colors);
+   Finder.SetContainment(true);
+   Finder.Find(&Image);
+
+   DBlobs Blobs = Finder.GetBlobs();
+   int nRed = Blobs[1].FindLargestBlob();
+   int nGreen = Blobs[3].FindLargestBlob();
+   int nBlue = Blobs[5].FindLargestBlob();
+   bool bRet = (nRed != -1) && (nGreen != -1) && (nBlue != -1)
+         && (Blobs.GetParent(nGreen) == nRed) && (Blobs.GetParent(nBlue) == nGreen);
+
+   Blobs.RemoveSmallBlobs(200.0);
+   DBlob::DIDVector Children;
+   Blobs.GetChildren(nRed, Children);
+   bRet = bRet && !Blobs.FindBlob(nGreen).first && (Blobs.GetParent(nGreen) == -1)
+         && (Blobs.GetParent(nBlue) == nRed) && (Children.size() == 1)
+         && (Children[0] == nBlue);
+   Blobs.GetChildren(nGreen, Children);
+   bRet = bRet && Children.empty();
+
+   std::printf("Containment tree pruning: %s\n", bRet ? "passed" : "FAILED");
+
+   return (bRet);
+
+   } // End of function CheckTreePruning
+
+/*****************************************************************************
+ *
+ ***  struct DMovingScene
+ *
+ *  A synthetic sequence of red, green and blue rectangles moving at
+ *  constant velocities.  The green one is gone for a few frames.
+ *
+ *****************************************************************************/
+
+struct DMovingScene
+   {
+   struct DMover
+      {
+      int nColor;
+      int nX;
+      int nY;
+      int nWidth;
+      int nHeight;
+      int nVelocityX;
+      int nVelocityY;
+      unsigned char Blue;
+      unsigned char Green;
+      unsigned char Red;
+      };
+
+   DMovingScene() :
+      Movers{ { 1, 20, 30, 12, 12, 4, 2, 0, 0, 255 },
+            { 3, 40, 200, 10, 14, 5, -1, 0, 255, 0 },
+            { 5, 280, 40, 16, 10, -3, 4, 255, 0, 0 } }
+      {
+      return;
+      }
+
+   static const int m_nFrameCount = 30;
+   static const int m_nHiddenMover = 1;
+   static const int m_nFirstHidden = 8;
+   static const int m_nHiddenCount = 3;
+
+   DMover Movers[3];
+
+   bool IsVisible(int nMover, int nFrame) const
+      {
+      return ((nMover != m_nHiddenMover) || (nFrame < m_nFirstHidden)
+            || (nFrame >= m_nFirstHidden + m_nHiddenCount));
+      }
+
+   // Centroid of a mover in a frame whether it shows or not
+   double GetX(int nMover, int nFrame) const
+      {
+      const DMover& Mover = Movers[nMover];
+      return (Mover.nX + Mover.nVelocityX * nFrame + (Mover.nWidth - 1) / 2.0);
+      }
+
+   double GetY(int nMover, int nFrame) const
+      {
+      const DMover& Mover = Movers[nMover];
+      return (Mover.nY + Mover.nVelocityY * nFrame + (Mover.nHeight - 1) / 2.0);
+      }
+
+   DCVImage GetFrame(int nFrame) const
+      {
+      DCVImage Image(320, 240, CV_8UC3);
+      FillRect(Image, cv::Rect(0, 0, 320, 240), 0, 0, 0);
+      for (int i = 0 ; i < 3 ; i++)
+         {
+         const DMover& Mover = Movers[i];
+         if (IsVisible(i, nFrame))
+            {
+            FillRect(Image, cv::Rect(Mover.nX + Mover.nVelocityX * nFrame,
+                  Mover.nY + Mover.nVelocityY * nFrame, Mover.nWidth,
+                  Mover.nHeight), Mover.Blue, Mover.Green, Mover.Red);
+            } // end if
+         } // end for
+
+      return (Image);
+      }
+
+   }; // end of struct DMovingScene
+
+/*****************************************************************************
+ *
+ *  CheckTracks
+ *
+ *  Follow the moving scene.  Each rectangle keeps the track it started,
+ *  the green one coasting while it's gone, ages and missed counts add up,
+ *  and the filtered positions and velocities settle on the true ones.
+ *  Tracks missed for longer than allowed are dropped.
+ *
+ *****************************************************************************/
+
+static bool CheckTracks()
+   {
+   DMovingScene Scene;
+   DBlobColor::Vector Colors = MakeColors();
+   DColorBlobFinderHSV Finder(&Colors);
+   DBlobTracks Tracks;
+
+   bool bRet = true;
+   for (int nFrame = 0 ; nFrame < DMovingScene::m_nFrameCount ; nFrame++)
+      {
+      DCVImage Image = Scene.GetFrame(nFrame);
+      Finder.Find(&Image);
+      const DBlobs& Blobs = Finder.GetBlobs();
+      Tracks.Update(Blobs);
+
+      // Tracks are started in color order, one per rectangle
+      const DBlobTracks::DTrackVector& TrackList = Tracks.GetTracks();
+      bRet = bRet && (TrackList.size() == 3);
+      for (int i = 0 ; bRet && (i < 3) ; i++)
+         {
+         const DMovingScene::DMover& Mover = Scene.Movers[i];
+         const DBlobTrack& Track = TrackList[i];
+         bool bVisible = Scene.IsVisible(i, nFrame);
+         int nMissed = bVisible ? 0 : nFrame - DMovingScene::m_nFirstHidden + 1;
+         int nBlobID = Blobs[Mover.nColor].FindLargestBlob();
+         bRet = (Track.GetID() == i) && (Track.GetColor() == Mover.nColor)
+               && (Track.GetAge() == nFrame + 1) && (Track.GetMissed() == nMissed)
+               && (Track.GetBlobID() == (bVisible ? nBlobID : -1))
+               && (!bVisible || (Tracks.FindTrack(nBlobID) == &Track))
+               && (!bVisible || (Track.GetArea() == Mover.nWidth * Mover.nHeight));
+         } // end for
+      } // end for
+
+   // After a few dozen frames the filters have all but caught up
+   int nLast = DMovingScene::m_nFrameCount - 1;
+   for (int i = 0 ; bRet && (i < 3) ; i++)
+      {
+      const DMovingScene::DMover& Mover = Scene.Movers[i];
+      const DBlobTrack& Track = Tracks.GetTracks()[i];
+      bRet = (std::fabs(Track.GetVelocityX() - Mover.nVelocityX) < 0.05)
+            && (std::fabs(Track.GetVelocityY() - Mover.nVelocityY) < 0.05)
+            && (std::fabs(Track.GetX() - Scene.GetX(i, nLast)) < 0.25)
+            && (std::fabs(Track.GetY() - Scene.GetY(i, nLast)) < 0.25);
+      } // end for
+
+   // With nothing in view every track coasts until it has been missed for
+   // too long
+   DBlobs Empty;
+   Empty.resize(Colors.size());
+   for (int n = 0 ; n <= Tracks.GetMaxMissed() ; n++)
+      {
+      bRet = bRet && (Tracks.GetTracks().size() == 3);
+      Tracks.Update(Empty);
+      } // end for
+   bRet = bRet && Tracks.GetTracks().empty();
+
+   std::printf("Tracks: %s\n", bRet ? "passed" : "FAILED");
+
+   return (bRet);
+
+   } // End of function CheckTracks
+
+/*****************************************************************************
+ *
+ ***  class DTestTrack
+ *
+ *  Opens up the track's axis filter to the checks.
+ *
+ *****************************************************************************/
+
+class DTestTrack : public DBlobTrack
+   {
+   public:
+      using DBlobTrack::DAxisFilter;
+
+   }; // end of class DTestTrack
+
+/*****************************************************************************
+ *
+ *  CheckAxisFilter
+ *
+ *  One axis filter fed a steady move of 3 pixels a frame.  Its covariance
+ *  has to stay positive definite, grow with each prediction, shrink with
+ *  each measurement, and the state has to settle on the move.
+ *
+ *****************************************************************************/
+
+static bool CheckAxisFilter()
+   {
+   DTestTrack::DAxisFilter Filter;
+   Filter.Start(10.0, 1.0, 32.0 * 32.0);
+
+   bool bRet = true;
+   for (int n = 1 ; n <= 40 ; n++)
+      {
+      double dPosition = Filter.dPosition;
+      double dVariance = Filter.dP00;
+      Filter.Predict(1.0);
+      bRet = bRet && (Filter.dPosition == dPosition + Filter.dVelocity)
+            && (Filter.dP00 > dVariance);
+
+      dVariance = Filter.dP00;
+      Filter.Correct(10.0 + 3.0 * n, 1.0);
+      bRet = bRet && (Filter.dP00 < dVariance) && (Filter.dP00 > 0.0)
+            && (Filter.dP11 > 0.0)
+            && (Filter.dP00 * Filter.dP11 > Filter.dP01 * Filter.dP01);
+      } // end for
+
+   bRet = bRet && (std::fabs(Filter.dVelocity - 3.0) < 0.01)
+         && (std::fabs(Filter.dPosition - 130.0) < 0.01);
+
+   std::printf("Axis filter: %s\n", bRet ? "passed" : "FAILED");
+
+   return (bRet);
+
+   } // End of function CheckAxisFilter
+
+/*****************************************************************************
+ *
+ *  IsCovered
+ *
+ *  rcBound lies wholly inside one of the windows.
+ *
+ *****************************************************************************/
+
+static bool IsCovered(const cv::Rect& rcBound, const std::vector<cv::Rect>& Windows)
+   {
+   return (std::any_of(Windows.begin(), Windows.end(),
+         [&rcBound](const cv::Rect& rcWindow)
+            {
+            return ((rcBound & rcWindow) == rcBound);
+            }));
+
+   } // End of function IsCovered
+
+/*****************************************************************************
+ *
+ *  CheckSearchWindows
+ *
+ *  Follow the moving scene the way the app does, searching only the
+ *  tracks' windows until a full scan is due.  Full scans have to come on
+ *  the first frame, every rescan interval and right after a track goes
+ *  missing.  The windows have to hold the blobs of the next frame, and of
+ *  the one after when asked to look two ahead, and searching them has to
+ *  find the same blobs as searching the whole frame.
+ *
+ *****************************************************************************/
+
+static bool CheckSearchWindows()
+   {
+   const int nRescanInterval = 4;
+   DMovingScene Scene;
+   DBlobColor::Vector Colors = MakeColors();
+   DColorBlobFinderHSV Full(&Colors);
+   DColorBlobFinderHSV Windowed(&Colors);
+   DBlobTracks Tracks;
+   Tracks.SetRescanInterval(nRescanInterval);
+
+   bool bRet = true;
+   int nLastFull = 0;
+   int nWindowed = 0;
+   bool bMissed = false;
+   std::vector<cv::Rect> Windows;
+   for (int nFrame = 0 ; nFrame < DMovingScene::m_nFrameCount ; nFrame++)
+      {
+      DCVImage Image = Scene.GetFrame(nFrame);
+      Full.Find(&Image);
+
+      bool bFullScan = Tracks.IsFullScanDue();
+      bRet = bRet && (bFullScan == ((nFrame == 0) || bMissed
+            || (nFrame - nLastFull >= nRescanInterval)));
+      if (bFullScan)
+         {
+         Tracks.Update(Full.GetBlobs(), true);
+         nLastFull = nFrame;
+         } // end if
+      else
+         {
+         Windowed.Find(&Image, Windows);
+         bRet = bRet && (DescribeBlobs(Windowed.GetBlobs())
+               == DescribeBlobs(Full.GetBlobs()));
+         Tracks.Update(Windowed.GetBlobs(), false);
+         nWindowed++;
+         } // end else
+
+      // Everything in view is matched, so only the hidden one goes missing
+      bMissed = false;
+      for (int i = 0 ; i < 3 ; i++)
+         {
+         bMissed = bMissed || !Scene.IsVisible(i, nFrame);
+         } // end for
+
+      // A full scan is due as soon as the frames since the last one reach
+      // the interval
+      int nSince = nFrame - nLastFull;
+      bRet = bRet && (bMissed || (Tracks.IsFullScanDue(nRescanInterval - nSince)
+            && ((nSince == nRescanInterval - 1)
+            || !Tracks.IsFullScanDue(nRescanInterval - nSince - 1))));
+
+      std::vector<cv::Rect> Ahead;
+      Tracks.GetSearchWindows(Windows);
+      Tracks.GetSearchWindows(Ahead, 2);
+      for (int i = 0 ; i < 3 ; i++)
+         {
+         const DMovingScene::DMover& Mover = Scene.Movers[i];
+         for (int nAhead = 1 ; nAhead <= 2 ; nAhead++)
+            {
+            int nNext = nFrame + nAhead;
+            cv::Rect rcNext(Mover.nX + Mover.nVelocityX * nNext,
+                  Mover.nY + Mover.nVelocityY * nNext, Mover.nWidth, Mover.nHeight);
+            bRet = bRet && IsCovered(rcNext, (nAhead == 1) ? Windows : Ahead);
+            } // end for
+         } // end for
+      } // end for
+
+   bRet = bRet && (nWindowed > 0);
+
+   std::printf("Search windows: %s\n", bRet ? "passed" : "FAILED");
+
+   return (bRet);
+
+   } // End of function CheckSearchWindows
+
+/*****************************************************************************
+ *
+ *  WaitFor
+ *
+ *  Poll IsDone until it's true or a few seconds pass.  Returns whether it
+ *  came true.
+ *
+ *****************************************************************************/
+
+template <class Condition>
+static bool WaitFor(Condition&& IsDone)
+   {
+   auto Deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+   bool bDone = IsDone();
+   while (!bDone && (std::chrono::steady_clock::now() < Deadline))
+      {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      bDone = IsDone();
+      } // end while
+
+   return (bDone);
+
+   } // End of function WaitFor
+
+/*****************************************************************************
+ *
+ ***  class DGate
+ *
+ *  Holds a pipeline stage's thread in Pass until the test opens it, so the
+ *  test knows which frame is where.
+ *
+ *****************************************************************************/
+
+class DGate
+   {
+   public:
+      DGate() :
+            m_bOpen(false),
+            m_nEntered(0)
+         {
+         return;
+         }
+
+      void Pass()
+         {
+         std::unique_lock<std::mutex> Lock(m_Mutex);
+         m_nEntered++;
+         m_Changed.notify_all();
+         m_Changed.wait(Lock, [this] { return (m_bOpen); });
+
+         return;
+         }
+
+      // Until nEntered frames have reached the gate.  False on a time out.
+      bool WaitForEntered(int nEntered)
+         {
+         std::unique_lock<std::mutex> Lock(m_Mutex);
+
+         return (m_Changed.wait_for(Lock, std::chrono::seconds(5),
+               [this, nEntered] { return (m_nEntered >= nEntered); }));
+         }
+
+      void Open()
+         {
+         std::lock_guard<std::mutex> Lock(m_Mutex);
+         m_bOpen = true;
+         m_Changed.notify_all();
+
+         return;
+         }
+
+   protected:
+      std::mutex m_Mutex;
+      std::condition_variable m_Changed;
+      bool m_bOpen;
+      int m_nEntered;
+
+   private:
+
+   }; // end of class DGate
+
+/*****************************************************************************
+ *
+ *  CheckRing
+ *
+ *  A ring filled, emptied and wrapped many times on one thread, then a
+ *  long run of numbers through a small ring between two threads, which
+ *  has to come out whole and in order.
+ *
+ *****************************************************************************/
+
+static bool CheckRing()
+   {
+   DSPSCRing<int> Ring(5);
+   bool bRet = (Ring.GetCapacity() == 5) && Ring.IsEmpty();
+
+   int nNext = 0;
+   int nExpected = 0;
+   for (int nRound = 0 ; nRound < 7 ; nRound++)
+      {
+      // Fill it, then take all but a few so the ends keep moving round
+      while (Ring.Push(nNext))
+         {
+         nNext++;
+         } // end while
+      bRet = bRet && (Ring.GetSize() == 5);
+      for (int i = 0 ; i < 3 + nRound % 3 ; i++)
+         {
+         int nItem;
+         bRet = bRet && Ring.Pop(nItem) && (nItem == nExpected++);
+         } // end for
+      } // end for
+   int nItem;
+   while (Ring.Pop(nItem))
+      {
+      bRet = bRet && (nItem == nExpected++);
+      } // end while
+   bRet = bRet && (nExpected == nNext) && Ring.IsEmpty();
+
+   const int nCount = 200000;
+   DSPSCRing<int> Shared(7);
+   std::thread Producer([&Shared]
+      {
+      for (int i = 0 ; i < nCount ; i++)
+         {
+         while (!Shared.Push(i))
+            {
+            std::this_thread::yield();
+            } // end while
+         } // end for
+      });
+
+   nExpected = 0;
+   while (nExpected < nCount)
+      {
+      if (Shared.Pop(nItem))
+         {
+         bRet = bRet && (nItem == nExpected);
+         nExpected++;
+         } // end if
+      else
+         {
+         std::this_thread::yield();
+         } // end else
+      } // end while
+   Producer.join();
+   bRet = bRet && Shared.IsEmpty();
+
+   std::printf("SPSC ring: %s\n", bRet ? "passed" : "FAILED");
+
+   return (bRet);
+
+   } // End of function CheckRing
+
+/*****************************************************************************
+ *
+ *  CheckPipelineDrops
+ *
+ *  With the first stage held on a frame, newer frames replace each other
+ *  in the mailbox and the producer gets the replaced slots back.  Only
+ *  the frame held and the newest come out, and with the consumer holding
+ *  them there's no slot for another frame.  The counters account for
+ *  every frame.
+ *
+ *****************************************************************************/
+
+static bool CheckPipelineDrops()
+   {
+   DGate Gate;
+   std::vector<int> Frames(3, 0);
+   DBlobPipeline Pipeline(3, { [&Gate](int) { Gate.Pass(); }, [](int) {} }, [] {});
+
+   // The first stage takes frame 1 and stops on it
+   int nHeld = Pipeline.AcquireSlot();
+   Frames[nHeld] = 1;
+   Pipeline.Submit(nHeld);
+   bool bRet = Gate.WaitForEntered(1) && (Pipeline.GetStageStats(0).nQueued == 0);
+
+   // Frame 2 waits and frames 3 and 4 each replace the one before.  The
+   // replaced frame's slot is the next one handed out.
+   int nWaiting = -1;
+   int nSpare = -1;
+   for (int nFrame = 2 ; nFrame <= 4 ; nFrame++)
+      {
+      int nSlot = Pipeline.AcquireSlot();
+      bRet = bRet && (nSlot != -1) && (nSlot != nHeld)
+            && ((nSpare == -1) || (nSlot == nSpare));
+      Frames[nSlot] = nFrame;
+      Pipeline.Submit(nSlot);
+      nSpare = nWaiting;
+      nWaiting = nSlot;
+      bRet = bRet && (Pipeline.GetStageStats(0).nQueued == 1)
+            && (Pipeline.GetQueuedFrames() == 1)
+            && (Pipeline.GetDroppedFrames() == nFrame - 2);
+      } // end for
+
+   // Frames 1 and 4 come out, in order
+   Gate.Open();
+   std::vector<int> Taken;
+   bRet = bRet && WaitFor([&]
+      {
+      int nResult = Pipeline.TakeResult();
+      if (nResult != -1)
+         {
+         Taken.push_back(nResult);
+         } // end if
+      return (Taken.size() == 2);
+      });
+   bRet = bRet && (Frames[Taken[0]] == 1) && (Frames[Taken[1]] == 4);
+
+   // The spare slot takes frame 5, after which there's none left
+   int nSlot = Pipeline.AcquireSlot();
+   bRet = bRet && (nSlot != -1);
+   Frames[nSlot] = 5;
+   Pipeline.Submit(nSlot);
+   bRet = bRet && (Pipeline.AcquireSlot() == -1) && (Pipeline.GetDroppedFrames() == 3);
+   bRet = bRet && WaitFor([&]
+      {
+      int nResult = Pipeline.TakeResult();
+      if (nResult != -1)
+         {
+         Taken.push_back(nResult);
+         } // end if
+      return (Taken.size() == 3);
+      });
+   bRet = bRet && (Frames[Taken[2]] == 5);
+
+   // Three frames went through each stage, and each stage had to wait
+   for (int nStage = 0 ; nStage < 2 ; nStage++)
+      {
+      DBlobPipeline::DStageStats Stats = Pipeline.GetStageStats(nStage);
+      bRet = bRet && (Stats.nProcessed == 3) && (Stats.nStalls >= 1)
+            && (Stats.nQueued == 0) && (Stats.dOccupancy >= 0.0)
+            && (Stats.dOccupancy <= 1.0);
+      } // end for
+
+   Pipeline.ResetStats();
+   bRet = bRet && (Pipeline.GetDroppedFrames() == 0)
+         && (Pipeline.GetStageStats(0).nProcessed == 0)
+         && (Pipeline.GetStageStats(1).nProcessed == 0);
+
+   // Handed back, every slot can be had once more
+   for (int nTaken : Taken)
+      {
+      Pipeline.ReleaseSlot(nTaken);
+      } // end for
+   std::vector<int> Slots;
+   for (int i = 0 ; i < 3 ; i++)
+      {
+      Slots.push_back(Pipeline.AcquireSlot());
+      } // end for
+   std::sort(Slots.begin(), Slots.end());
+   bRet = bRet && (Slots == std::vector<int>({ 0, 1, 2 }))
+         && (Pipeline.AcquireSlot() == -1);
+   for (int nAcquired : Slots)
+      {
+      Pipeline.Submit(nAcquired);
+      } // end for
+
+   std::printf("Pipeline drops: %s\n", bRet ? "passed" : "FAILED");
+
+   return (bRet);
+
+   } // End of function CheckPipelineDrops
+
+/*****************************************************************************
+ *
+ *  CheckPipelinePause
+ *
+ *  One frame held in the second stage and another queued behind it when
+ *  a pause starts.  Neither may come out, whether or not the stages got
+ *  to finish them first, and the next frame goes through.
+ *
+ *****************************************************************************/
+
+static bool CheckPipelinePause()
+   {
+   DGate Gate;
+   std::atomic<int> nLastStage(0);
+   DBlobPipeline Pipeline(3, { [](int) {}, [&Gate](int) { Gate.Pass(); },
+         [&nLastStage](int) { nLastStage++; } }, [] {});
+
+   int nSlot = Pipeline.AcquireSlot();
+   Pipeline.Submit(nSlot);
+   bool bRet = Gate.WaitForEntered(1);
+   nSlot = Pipeline.AcquireSlot();
+   Pipeline.Submit(nSlot);
+   bRet = bRet && WaitFor([&] { return (Pipeline.GetStageStats(1).nQueued == 1); });
+
+   // The pause waits for the second stage to let its frame go
+   std::thread Opener([&Gate]
+      {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      Gate.Open();
+      });
+      {
+      DBlobPipeline::DPause Pause(Pipeline);
+      }
+   Opener.join();
+
+   // Both frames reach the end, whether or not the stages got to them
+   // before the pause, and are dropped there.  The second stage may have
+   // taken the second frame before the pause did.
+   bool bTaken = false;
+   bRet = bRet && WaitFor([&]
+      {
+      bTaken = bTaken || (Pipeline.TakeResult() != -1);
+      return (Pipeline.GetDroppedFrames() == 2);
+      });
+   bRet = bRet && !bTaken && (Pipeline.GetStageStats(1).nProcessed <= 2)
+         && (nLastStage <= 2);
+
+   nSlot = Pipeline.AcquireSlot();
+   Pipeline.Submit(nSlot);
+   int nResult = -1;
+   bRet = bRet && WaitFor([&] { return ((nResult = Pipeline.TakeResult()) != -1); })
+         && (nResult == nSlot) && (Pipeline.GetDroppedFrames() == 2);
+   Pipeline.ReleaseSlot(nResult);
+
+   std::printf("Pipeline pause: %s\n", bRet ? "passed" : "FAILED");
+
+   return (bRet);
+
+   } // End of function CheckPipelinePause
+
+/*****************************************************************************
+ *
+ *  CheckPipelineSlots
+ *
+ *  A producer submitting frames faster than three stages with uneven
+ *  work take them, and a consumer on a thread of its own.  Every slot has
+ *  to be in one place at a time, go through the stages in order, and come
+ *  out with frames in order.  Once it all settles each frame is either
+ *  taken or counted as dropped, and every slot can be had again.
+ *
+ *****************************************************************************/
+
+static bool CheckPipelineSlots()
+   {
+   const int nSlots = 4;
+   const int nStages = 3;
+   const int nFrameCount = 3000;
+
+   // Who holds each slot, the pipeline, the producer or the consumer
+   enum { ePipeline, eProducer, eConsumer };
+   std::vector<std::atomic<int> > Owners(nSlots);
+   std::vector<std::atomic<int> > Busy(nSlots);
+   std::vector<int> Frames(nSlots, 0);
+   std::vector<int> Progress(nSlots, 0);
+   std::atomic<int> nErrors(0);
+   for (int i = 0 ; i < nSlots ; i++)
+      {
+      Owners[i] = ePipeline;
+      Busy[i] = 0;
+      } // end for
+
+   std::vector<DBlobPipeline::DStage> Stages;
+   for (int nStage = 0 ; nStage < nStages ; nStage++)
+      {
+      Stages.push_back([&, nStage](int nSlot)
+         {
+         if ((Owners[nSlot] != ePipeline) || (Busy[nSlot]++ != 0)
+               || (Progress[nSlot] != nStage))
+            {
+            nErrors++;
+            } // end if
+         Progress[nSlot] = nStage + 1;
+         std::this_thread::sleep_for(std::chrono::microseconds(
+               20 * (nStage + 1) * (Frames[nSlot] % 4)));
+         Busy[nSlot]--;
+         });
+      } // end for
+
+   std::atomic<int> nTaken(0);
+   std::atomic<int> nAttempts(0);
+   std::atomic<bool> bProducing(true);
+   std::mutex ReadyMutex;
+   std::condition_variable Ready;
+   bool bRet = true;
+      {
+      DBlobPipeline Pipeline(nSlots, Stages, [&]
+         {
+            {
+            std::lock_guard<std::mutex> Lock(ReadyMutex);
+            }
+         Ready.notify_one();
+         });
+
+      // Takes results as they're ready until every frame submitted is
+      // accounted for, or gives up a while after the producer is done
+      std::thread Consumer([&]
+         {
+         int nLastFrame = 0;
+         auto Deadline = std::chrono::steady_clock::time_point::max();
+         while (std::chrono::steady_clock::now() < Deadline)
+            {
+            int nSlot = Pipeline.TakeResult();
+            if (nSlot == -1)
+               {
+               if (!bProducing)
+                  {
+                  if (nTaken + Pipeline.GetDroppedFrames() == nAttempts)
+                     {
+                     break;
+                     } // end if
+                  Deadline = std::min(Deadline, std::chrono::steady_clock::now()
+                        + std::chrono::seconds(5));
+                  } // end if
+               std::unique_lock<std::mutex> Lock(ReadyMutex);
+               Ready.wait_for(Lock, std::chrono::milliseconds(1));
+               continue;
+               } // end if
+
+            int nOwner = ePipeline;
+            if (!Owners[nSlot].compare_exchange_strong(nOwner, eConsumer)
+                  || (Progress[nSlot] != nStages) || (Frames[nSlot] <= nLastFrame))
+               {
+               nErrors++;
+               } // end if
+            nLastFrame = Frames[nSlot];
+            nTaken++;
+            Owners[nSlot] = ePipeline;
+            Pipeline.ReleaseSlot(nSlot);
+            } // end while
+         });
+
+      for (int nFrame = 1 ; nFrame <= nFrameCount ; nFrame++)
+         {
+         nAttempts++;
+         int nSlot = Pipeline.AcquireSlot();
+         if (nSlot != -1)
+            {
+            int nOwner = ePipeline;
+            if (!Owners[nSlot].compare_exchange_strong(nOwner, eProducer))
+               {
+               nErrors++;
+               } // end if
+            Frames[nSlot] = nFrame;
+            Progress[nSlot] = 0;
+            Owners[nSlot] = ePipeline;
+            Pipeline.Submit(nSlot);
+            } // end if
+         std::this_thread::sleep_for(std::chrono::microseconds(10 * (nFrame % 5)));
+         } // end for
+      bProducing = false;
+      Consumer.join();
+
+      bRet = (nErrors == 0) && (nTaken + Pipeline.GetDroppedFrames() == nAttempts)
+            && (nTaken > 0) && (Pipeline.GetDroppedFrames() > 0)
+            && (Pipeline.GetQueuedFrames() == 0);
+      for (int nStage = 0 ; nStage < nStages ; nStage++)
+         {
+         bRet = bRet && (Pipeline.GetStageStats(nStage).nProcessed == nTaken);
+         } // end for
+
+      std::vector<int> Slots;
+      for (int i = 0 ; i < nSlots ; i++)
+         {
+         Slots.push_back(Pipeline.AcquireSlot());
+         } // end for
+      std::sort(Slots.begin(), Slots.end());
+      bRet = bRet && (Slots == std::vector<int>({ 0, 1, 2, 3 }))
+            && (Pipeline.AcquireSlot() == -1);
+      for (int nSlot : Slots)
+         {
+         Pipeline.Submit(nSlot);
+         } // end for
+      }
+
+   std::printf("Pipeline slots: %s\n", bRet ? "passed" : "FAILED");
+
+   return (bRet);
+
+   } // End of function CheckPipelineSlots
+
+/*****************************************************************************
+ *
+ *  FillFrame
+ *
+ *  Every byte of Image set to nValue, as a capture of frame nValue.
+ *
+ *****************************************************************************/
+
+static void FillFrame(DCVImage& Image, unsigned char nValue)
+   {
+   size_t nRowSize = static_cast<size_t>(Image.GetNumCols()) * Image.GetPixelSize();
+   for (int r = 0 ; r < Image.GetNumRows() ; r++)
+      {
+      std::memset(Image.GetRow(r), nValue, nRowSize);
+      } // end for
+
+   return;
+
+   } // End of function FillFrame
+
+/*****************************************************************************
+ *
+ *  IsFrame
+ *
+ *  Image still holds the capture FillFrame made of frame nValue.
+ *
+ *****************************************************************************/
+
+static bool IsFrame(const DCVImage& Image, unsigned char nValue)
+   {
+   size_t nRowSize = static_cast<size_t>(Image.GetNumCols()) * Image.GetPixelSize();
+   bool bRet = !Image.empty();
+   for (int r = 0 ; bRet && (r < Image.GetNumRows()) ; r++)
+      {
+      const unsigned char* pRow = Image.GetRow(r);
+      bRet = std::all_of(pRow, pRow + nRowSize,
+            [nValue](unsigned char nByte) { return (nByte == nValue); });
+      } // end for
+
+   return (bRet);
+
+   } // End of function IsFrame
+
+/*****************************************************************************
+ *
+ *  CheckFramePool
+ *
+ *  A capture image nothing else holds is published without copying and
+ *  swapped for a free buffer, one something else still holds is copied
+ *  and left alone, and no buffer is captured into again while a frame
+ *  published from it is held.  Free buffers beyond the most to keep are
+ *  let go once the frames are.
+ *
+ *****************************************************************************/
+
+static bool CheckFramePool()
+   {
+   const int nMaxBuffers = 3;
+   DFramePool Pool(nMaxBuffers);
+
+   // Taken as it is, and the capture gets a buffer the same size
+   DCVImage Captured(64, 48, CV_8UC3);
+   FillFrame(Captured, 1);
+   const unsigned char* pCaptured = Captured.GetRow(0);
+   DCVImage First = Pool.Publish(Captured);
+   bool bRet = (First.GetRow(0) == pCaptured) && IsFrame(First, 1)
+         && (Captured.GetRow(0) != pCaptured) && (Captured.GetNumCols() == 64)
+         && (Captured.GetNumRows() == 48) && (Captured.type() == CV_8UC3)
+         && (Pool.GetBufferCount() == 2);
+
+   // Publishing a published frame only shares it again
+   DCVImage Again = Pool.Publish(First);
+   bRet = bRet && (Again.GetRow(0) == pCaptured) && (First.GetRow(0) == pCaptured)
+         && (Pool.GetBufferCount() == 2);
+
+   // The pool's own buffer, with only the capture holding it, is taken too
+   FillFrame(Captured, 2);
+   pCaptured = Captured.GetRow(0);
+   DCVImage Second = Pool.Publish(Captured);
+   bRet = bRet && (Second.GetRow(0) == pCaptured) && IsFrame(Second, 2)
+         && (Captured.GetRow(0) != pCaptured) && (Captured.GetRow(0) != First.GetRow(0));
+
+   // Something else still holds these pixels, so they're copied
+   DCVImage Device(64, 48, CV_8UC3);
+   FillFrame(Device, 3);
+   DCVImage Shared = Device;
+   DCVImage Third = Pool.Publish(Shared);
+   bRet = bRet && (Third.GetRow(0) != Device.GetRow(0)) && IsFrame(Third, 3)
+         && (Shared.GetRow(0) == Device.GetRow(0)) && IsFrame(Device, 3);
+
+   // Many more frames, some copied, while the first three are held.  None
+   // may be captured into again, so they keep their pixels.
+   std::vector<const unsigned char*> Held = { First.GetRow(0), Second.GetRow(0),
+         Third.GetRow(0) };
+   for (int nFrame = 4 ; nFrame < 40 ; nFrame++)
+      {
+      bRet = bRet && (std::find(Held.begin(), Held.end(), Captured.GetRow(0))
+            == Held.end());
+      FillFrame(Captured, static_cast<unsigned char>(nFrame));
+      DCVImage Holder = Captured;
+      DCVImage Frame = Pool.Publish((nFrame % 3 == 0) ? Holder : Captured);
+      bRet = bRet && IsFrame(Frame, static_cast<unsigned char>(nFrame))
+            && (std::find(Held.begin(), Held.end(), Frame.GetRow(0)) == Held.end());
+      } // end for
+   bRet = bRet && IsFrame(First, 1) && IsFrame(Second, 2) && IsFrame(Third, 3);
+
+   // Frames a different size get buffers that size
+   DCVImage Small(32, 24, CV_8UC3);
+   FillFrame(Small, 50);
+   DCVImage SmallFrame = Pool.Publish(Small);
+   bRet = bRet && IsFrame(SmallFrame, 50) && (Small.GetNumCols() == 32)
+         && (Small.GetNumRows() == 24);
+
+   // While the frames are held the pool grows past its limit, and once
+   // they're let go it shrinks back
+   bRet = bRet && (Pool.GetBufferCount() > nMaxBuffers);
+   First = DCVImage();
+   Second = DCVImage();
+   Third = DCVImage();
+   Again = DCVImage();
+   SmallFrame = DCVImage();
+   FillFrame(Small, 51);
+   SmallFrame = Pool.Publish(Small);
+   bRet = bRet && IsFrame(SmallFrame, 51) && (Pool.GetBufferCount() <= nMaxBuffers);
+
+   // An empty image is passed through
+   DCVImage Empty;
+   bRet = bRet && Pool.Publish(Empty).empty();
+
+   std::printf("Frame pool: %s\n", bRet ? "passed" : "FAILED");
+
+   return (bRet);
+
+   } // End of function CheckFramePool
+
+/*****************************************************************************
+ *
+ *  CheckFinder
+ *
+ *****************************************************************************/
+
+template <class Finder>
+static int CheckFinder(const char* pName, const std::vector<DCVImage>& Images)
+   {
+   int nFailed = CheckClassifiers<Finder>(pName, Images);
+   nFailed += CheckLabeling<Finder>(pName, Images);
+   nFailed += CheckRawFormats<Finder>(pName, Images);
+   nFailed += CheckYCbCr<Finder>(pName, Images);
+   nFailed += CheckTopology<Finder>(pName, Images);
+   nFailed += CheckBandIDs<Finder>(pName, Images);
+   nFailed += CheckMoments<Finder>(pName, Images);
+   nFailed += CheckPruning<Finder>(pName, Images);
+   nFailed += CheckWindows<Finder>(pName, Images);
+
+   return (nFailed);
+
+   } // End of function CheckFinder
+
+/*****************************************************************************
+ *
+ *  main
+ *
+ *****************************************************************************/
+
+int main(int argc, char* argv[])
+   {
+   int nFailed = 0;
+
+   nFailed += CheckHueConversion<DColorSpaceHSV>("HSV") ? 0 : 1;
+   nFailed += CheckHueConversion<DColorSpaceHSL>("HSL") ? 0 : 1;
+   nFailed += CheckImageTypes() ? 0 : 1;
+   nFailed += CheckTreePruning() ? 0 : 1;
+   nFailed += CheckTracks() ? 0 : 1;
+   nFailed += CheckAxisFilter() ? 0 : 1;
+   nFailed += CheckSearchWindows() ? 0 : 1;
+   nFailed += CheckRing() ? 0 : 1;
+   nFailed += CheckPipelineDrops() ? 0 : 1;
+   nFailed += CheckPipelinePause() ? 0 : 1;
+   nFailed += CheckPipelineSlots() ? 0 : 1;
+   nFailed += CheckFramePool() ? 0 : 1;
+
+   std::vector<DCVImage> Images;
+   for (int i = 1 ; i < argc ; i++)
+      {
+      DCVImage Image;
+      if (LoadImage(argv[i], Image))
+         {
+         Images.push_back(Image);
+         } // end if
+      else
+         {
+         std::printf("Can't read %s\n", argv[i]);
+         nFailed++;
+         } // end else
+      } // end for
+
+   if (!Images.empty())
+      {
+      nFailed += CheckFinder<DColorBlobFinder>("RGB", Images);
+      nFailed += CheckFinder<DColorBlobFinderHSV>("HSV", Images);
+      nFailed += CheckFinder<DColorBlobFinderHSL>("HSL", Images);
+      nFailed += CheckClassifiers<DColorBlobFinderYCbCr>("YCbCr", Images);
+      nFailed += CheckYCbCrClassifiers<DColorBlobFinderYCbCr>("YCbCr", Images);
+      nFailed += CheckYCbCrClassifiers<DColorBlobFinderHSV>("HSV", Images);
+      } // end if
+
+   std::printf("%d checks failed\n", nFailed);
+
+   return (nFailed);
+
+   } // end main
@@ -0,0 +1,34 @@
+#-------------------------------------------------
+#
+# Checks of the blob finder against its reference paths
+#
+#-------------------------------------------------
+
+QT       += core gui
+
+TARGET = BlobTrackerTests
+TEMPLATE = app
+CONFIG += console
+
+include(D:/Projects/Workspace/ProjectsCommon/Druai.pri)
+include(D:/Projects/Workspace/ProjectsCommon/OpenCV.pri)
+
+INCLUDEPATH += ..
+
+SOURCES += BlobTrackerTests.cpp \
+        ../DBlobPipeline.cpp \
+        ../DBlobs.cpp \
+        ../DBlobsSIMD.cpp \
+        ../DBlobTracks.cpp \
+        ../DFramePool.cpp \
+        ../DThreadPool.cpp
+
+HEADERS  += ../DBlobPipeline.h \
+            ../DBlobs.h \
+            ../DBlobsSIMD.h \
+            ../DBlobTracks.h \
+            ../DFramePool.h \
+            ../DSPSCRing.h \
+            ../DThreadPool.h
+
+CONFIG += c++14